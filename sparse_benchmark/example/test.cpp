@@ -1,11 +1,249 @@
 #include <sparsebench.hpp>
 
+// formats selected on the command line
+struct FormatList{
+    bool csr_;
+    bool sell_;
+    bool ldu_;
+};
 
-int main(){
+static FormatList parse_format_list(const string& list){
+    FormatList formats = {false, false, false};
+    size_t start = 0;
+    while(start <= list.size()){
+        size_t end = list.find(',', start);
+        if(end == string::npos){
+            end = list.size();
+        }
+        string name = list.substr(start, end - start);
+        if(name == "csr"){
+            formats.csr_ = true;
+        }else if(name == "sell"){
+            formats.sell_ = true;
+        }else if(name == "ldu"){
+            formats.ldu_ = true;
+        }else{
+            cerr << "unknown format : " << name << ", expect csr, sell or ldu" << endl;
+            throw std::invalid_argument("unknown format");
+        }
+        start = end + 1;
+    }
+    return formats;
+}
+
+template <typename IndexType, typename ValueType>
+void format_benchmark(CSR<IndexType, ValueType>& csr, const FormatList& formats){
+    if(formats.csr_){
+        csr.spmv_benchmark();
+    }
+    if(formats.sell_){
+        SELL<IndexType, ValueType> sell(csr, env_get_int("SELL_SIGMA", SELL_SIGMA));
+        sell.spmv_benchmark();
+    }
+    if(formats.ldu_){
+        LDU<IndexType, ValueType> ldu(csr);
+        ldu.spmv_benchmark();
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void format_benchmark_mixed(CSR<IndexType, ValueType>& csr, const FormatList& formats){
+    if(formats.csr_){
+        csr.spmv_benchmark_mixed();
+    }
+    if(formats.sell_){
+        SELL<IndexType, ValueType> sell(csr, env_get_int("SELL_SIGMA", SELL_SIGMA));
+        sell.spmv_benchmark_mixed();
+    }
+    if(formats.ldu_){
+        LDU<IndexType, ValueType> ldu(csr);
+        ldu.spmv_benchmark_mixed();
+    }
+}
+
+// residual checks that FAILED on any rank, the exit status of the run
+static int failure_count(){
+    int failures = benchmark_failure_count();
+    MPI_Allreduce(MPI_IN_PLACE, &failures, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+    if(failures > 0){
+        cout << failures << " residual check(s) FAILED !!!" << endl;
+    }
+    return failures;
+}
+
+static void print_usage(const char* program){
+    cerr << "usage : " << program << " <matrix.mtx> [--formats csr,sell,ldu] [--csv file] [--json file]" << endl;
+}
+
+int main(int argc, char** argv){
+
+    // OpenMP threads inside a rank, MPI calls from the master thread only
+    int mpi_thread_level = 0;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_thread_level);
+    int mpi_rank = 0;
+    int mpi_size = 1;
+    MPI_Comm_rank(MPI_COMM_WORLD, &mpi_rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &mpi_size);
+    if(mpi_rank != 0){
+        cout.setstate(std::ios::failbit);
+    }
+
+    string filename;
+    FormatList formats = {true, true, true};
+    string csv_filename;
+    string json_filename;
+    for(int i = 1; i < argc; ++i){
+        string arg(argv[i]);
+        if((arg == "--formats" || arg == "--csv" || arg == "--json") && i + 1 >= argc){
+            print_usage(argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+        if(arg == "--formats"){
+            formats = parse_format_list(argv[++i]);
+        }else if(arg == "--csv"){
+            csv_filename = argv[++i];
+        }else if(arg == "--json"){
+            json_filename = argv[++i];
+        }else if(filename.empty() && arg.compare(0, 2, "--") != 0){
+            filename = arg;
+        }else{
+            print_usage(argv[0]);
+            MPI_Finalize();
+            return 1;
+        }
+    }
+    if(filename.empty()){
+        print_usage(argv[0]);
+        MPI_Finalize();
+        return 1;
+    }
+
+    // before the first allocation, so first touch sees the final thread placement
+    numa_pin_threads();
+    numa_print_binding();
+
+    // mpirun -np N (N > 1) : rank 0 reads, DistributedCSR sends the row blocks
+    omp_timer timer;
+    // a failed read on rank 0 ends every rank, the others would wait in DistributedCSR
+    CSR<int64_t, double> csr;
+    int read_ok = 1;
+    if(mpi_rank == 0){
+        try{
+            csr = read_csr_from_mtx(filename);
+        }catch(const std::exception& e){
+            cerr << "In main, cannot read " << filename << " : " << e.what() << " !!!" << endl;
+            read_ok = 0;
+        }
+    }
+    MPI_Bcast(&read_ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if(!read_ok){
+        MPI_Finalize();
+        return 1;
+    }
+    double setup_time = timer.timeIncrement();
+    cout << "setup benchmark ------------" << endl;
+    cout << "thread count : " << omp_get_max_threads() << endl;
+    cout << "read + sort + coo -> csr time (or binary load) : " << setup_time << endl;
+    cout << "----------------------------" << endl;
+
+    // env REORDER (none | rcm | bisection | multicolor), REORDER_PART_SIZE rows per bisection part
+    const char* reorder_method = getenv("REORDER");
+    if(mpi_rank == 0 && reorder_method != NULL && reorder_method_from_string(reorder_method) != REORDER_NONE){
+        // throughput in file order, the benchmarks below run on the reordered matrix
+        csr.spmv_benchmark();
+        csr = reorder(csr, reorder_method_from_string(reorder_method), static_cast<int64_t>(env_get_int("REORDER_PART_SIZE", 16384)));
+    }
+    // y_ref of the matrix as benchmarked, every spmv_benchmark checks against it
+    if(mpi_rank == 0){
+        vector<double> y_ref;
+        csr.SpMV_reference(y_ref, benchmark_vector<double>(csr.col_));
+        set_benchmark_reference(std::move(y_ref));
+    }
+
+    // mpirun -np N (N > 1) : only the distributed SpMV, every rank keeps a row block
+    if(mpi_size > 1){
+        DistributedCSR<int64_t, double> distributed(csr, MPI_COMM_WORLD);
+        distributed.print_info();
+        distributed.benchmark();
+        if(mpi_rank == 0 && !csv_filename.empty()){
+            write_benchmark_csv(csv_filename);
+        }
+        if(mpi_rank == 0 && !json_filename.empty()){
+            write_benchmark_json(json_filename);
+        }
+        const int failures = failure_count();
+        MPI_Finalize();
+        return failures > 0 ? 1 : 0;
+    }
+
+    const int spmm_k = env_get_int("SPMM_K", 8);
+    if(formats.csr_){
+        csr.load_balance_report(omp_get_max_threads());
+        csr.numa_benchmark();
+        csr.spmv_fused_benchmark();
+        Triangular<int64_t, double> triangular(csr);
+        triangular.benchmark();
+        refresh_benchmark(csr);
+        CSRMixed<int64_t, float> csr_mixed(csr, env_get_bool("MIXED_DELTA16", true));
+        csr_mixed.print_info();
+        csr_mixed.benchmark();
+        compressed_benchmark(csr);
+        if(env_get_bool("SPGEMM", true)){
+            spgemm_benchmark(csr, csr);
+        }
+        csr.spmm_benchmark(spmm_k);
+    }
+    if(formats.sell_){
+        SELL<int64_t, double> sell(csr, env_get_int("SELL_SIGMA", SELL_SIGMA));
+        sell.print_info();
+        sell.spmm_benchmark(spmm_k);
+    }
+    if(formats.ldu_){
+        LDU<int64_t, double> ldu(csr);
+        ldu.print_info();
+        ldu.spmm_benchmark(spmm_k);
+    }
+
+    format_benchmark(csr, formats);
+
+    CSR<int32_t, double> csr_i32_f64(csr);
+    format_benchmark(csr_i32_f64, formats);
+
+    CSR<int64_t, float> csr_i64_f32(csr);
+    format_benchmark(csr_i64_f32, formats);
+
+    CSR<int32_t, float> csr_i32_f32(csr);
+    format_benchmark(csr_i32_f32, formats);
+    format_benchmark_mixed(csr_i32_f32, formats);
+
+    // env SOLVER (pcg | pbicgstab | gamg, AMG_* see amg.hpp), PRECONDITIONER (none | jacobi | dic | dilu | sgs),
+    // SOLVER_LAPLACIAN replaces the values by a shifted graph Laplacian (pattern only files)
+    const char* solver = getenv("SOLVER");
+    if(solver != NULL){
+        SolverType solver_type = solver_type_from_string(solver);
+        const char* preconditioner = getenv("PRECONDITIONER");
+        PreconditionerType preconditioner_type = (preconditioner != NULL) ? preconditioner_type_from_string(preconditioner)
+            : (solver_type == SOLVER_PCG ? PRECONDITIONER_DIC : PRECONDITIONER_DILU);
+        SolverControl control = {env_get_double("SOLVER_TOLERANCE", 1e-8), env_get_double("SOLVER_REL_TOL", 0.),
+            env_get_int("SOLVER_MAX_ITER", 1000)};
+        if(env_get_bool("SOLVER_LAPLACIAN", false)){
+            set_laplacian_values(csr, env_get_double("SOLVER_LAPLACIAN_SHIFT", 0.01));
+        }
+        solver_benchmark(csr, solver_type, preconditioner_type, control);
+        // env SOLVER_REFINEMENT, the same solve in double against mixed precision iterative refinement
+        if(env_get_bool("SOLVER_REFINEMENT", false)){
+            refinement_benchmark(csr, solver_type, preconditioner_type, control);
+        }
+    }
 
-    string filename("/vol0001/hp230257/guozhuoqiang/DeepFlame/deepflame-dev/examples/dfLowMachFoam/threeD_reactingTGV/CH4/Grid128_2pi_8_2x2x2/sparse_pattern_0.mtx");
-    COO<int64_t, double> coo = read_coo_from_pattern_mtx(filename);
-    CSR<int64_t, double> csr(coo);
-    csr.spmv_benchmark();
-    return 0;
+    if(!csv_filename.empty()){
+        write_benchmark_csv(csv_filename);
+    }
+    if(!json_filename.empty()){
+        write_benchmark_json(json_filename);
+    }
+    const int failures = failure_count();
+    MPI_Finalize();
+    return failures > 0 ? 1 : 0;
 }
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+#include "preconditioner.hpp"
+#include "solver.hpp"
+
+// GAMG style algebraic multigrid : pairwise aggregation, Galerkin coarse
+// matrices, V-cycle with weighted Jacobi smoothing
+struct AMGControl{
+    int64_t coarsest_size_;     // stop coarsening below this row count
+    int max_levels_;
+    int pre_sweeps_;
+    int post_sweeps_;
+    double omega_;              // Jacobi weight
+    bool scale_correction_;     // x += alpha e, alpha = <e, r> / <e, A e>
+    double coarsest_rel_tol_;   // PCG / PBiCGStab on the coarsest level
+    bool spgemm_galerkin_;      // R (A P) with two SpGEMM instead of the aggregate sums
+};
+
+// env AMG_COARSEST_SIZE, AMG_MAX_LEVELS, AMG_PRE_SWEEPS, AMG_POST_SWEEPS,
+// AMG_JACOBI_OMEGA, AMG_SCALE_CORRECTION, AMG_COARSEST_REL_TOL, AMG_SPGEMM_GALERKIN
+AMGControl amg_control_from_env();
+
+template <typename IndexType, typename ValueType>
+struct AMGLevel{
+    CSR<IndexType, ValueType> A_;   // empty on level 0, the fine matrix is held by AMG
+    vector<IndexType> aggregate_;   // row -> row of the next coarser level
+    vector<IndexType> member_ptr_;  // rows of each aggregate in ascending order : restriction
+    vector<IndexType> member_;
+    vector<ValueType> rdiag_;
+    vector<ValueType> x_;           // correction and right hand side, coarse levels only
+    vector<ValueType> b_;
+    vector<ValueType> r_;
+    vector<ValueType> t_;
+    vector<ValueType> w_;
+
+    // profile, accumulated over all cycles
+    double time_smooth_;
+    double time_residual_;
+    double time_restrict_;
+    double time_prolong_;
+    double time_coarsest_;
+    int64_t spmv_count_;
+
+    AMGLevel():time_smooth_(0.), time_residual_(0.), time_restrict_(0.), time_prolong_(0.), time_coarsest_(0.), spmv_count_(0){}
+};
+
+// the hierarchy is built once in the constructor, A keeps its pattern and values
+// aggregates : every row is paired with its unpaired neighbour of largest |a_ij|
+// (faceAreaPair with the coefficient as weight), rows left alone join the
+// aggregate of their strongest neighbour, so each level roughly halves the rows
+// P is piecewise constant, R = P^T : A_c(I, J) = sum_{i in I, j in J} a_ij
+template <typename IndexType, typename ValueType>
+class AMG{
+private:
+    CSR<IndexType, ValueType>& A_;
+    AMGControl control_;
+    vector<AMGLevel<IndexType, ValueType>> levels_;
+    Preconditioner<IndexType, ValueType>* coarsest_preconditioner_;
+    bool coarsest_symmetric_;
+    double setup_time_;
+
+    CSR<IndexType, ValueType>& matrix(int level){
+        return level == 0 ? A_ : levels_[level].A_;
+    }
+
+    const CSR<IndexType, ValueType>& matrix(int level) const {
+        return level == 0 ? A_ : levels_[level].A_;
+    }
+
+    // fills aggregate_ / member_ptr_ / member_ of level, returns the coarse row count
+    IndexType aggregate(int level);
+
+    // Galerkin product R A P of level into level + 1
+    void galerkin(int level);
+
+    // sweeps times x += omega D^-1 (b - A x), x = 0 on entry when zero_initial
+    void smooth(int level, vector<ValueType>& x, const vector<ValueType>& b, int sweeps, bool zero_initial);
+
+    void vcycle(int level, vector<ValueType>& x, const vector<ValueType>& b);
+
+public:
+    AMG(CSR<IndexType, ValueType>& A, const AMGControl& control);
+
+    ~AMG(){
+        delete coarsest_preconditioner_;
+    }
+
+    AMG(const AMG&) = delete;
+    AMG& operator=(const AMG&) = delete;
+
+    int level_count() const {return levels_.size();}
+
+    // V-cycles from x until control is met, OpenFOAM residual as in pcg_solve
+    SolverPerformance solve(vector<ValueType>& x, const vector<ValueType>& b, const SolverControl& control);
+
+    // rows / nnz / coarsening ratio per level, grid and operator complexity
+    void print_info() const;
+
+    // time per level and per V-cycle stage, accumulated since construction
+    void print_profile() const;
+};
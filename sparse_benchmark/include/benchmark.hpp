@@ -0,0 +1,320 @@
+#pragma once
+
+#include "common.hpp"
+#include <cmath>
+
+template <typename T>
+struct type_name{
+    static const char* get(){return typeid(T).name();}
+};
+template <> struct type_name<int32_t>{static const char* get(){return "int32";}};
+template <> struct type_name<int64_t>{static const char* get(){return "int64";}};
+template <> struct type_name<float>{static const char* get(){return "float";}};
+template <> struct type_name<double>{static const char* get(){return "double";}};
+
+// one timed kernel, collected for the CSV / JSON output
+struct BenchmarkResult{
+    string title_;
+    string info_;
+    int thread_count_;
+    int repeat_count_;
+    double FLOPs_;          // per call
+    double bytes_;          // streamed per call, 0 when unknown
+    double time_no_warm_up_;
+    double time_min_;
+    double time_median_;
+    double time_max_;
+    double time_total_;     // sum of the repeats
+    double residual_;       // max |y - y_ref| / max |y_ref|, -1 when not checked
+    double tolerance_;
+};
+
+// results of every spmv_benchmark_run of this process
+vector<BenchmarkResult>& benchmark_results();
+
+// results whose residual check FAILED (residual > tolerance)
+int benchmark_failure_count();
+
+// reference y of the matrix under test, y_ref = A * benchmark_vector(col)
+void set_benchmark_reference(vector<double> y_ref);
+const vector<double>& benchmark_reference();
+
+// STREAM triad bandwidth in GB/s, measured on first call
+// arrays of env STREAM_SIZE doubles (default 2^25), best of 10
+double stream_triad_bandwidth();
+
+void write_benchmark_csv(const string& filename);
+void write_benchmark_json(const string& filename);
+
+// x[i] = 1 + (i % 16) / 16, so a wrong column index changes y
+template <typename VectorType>
+static vector<VectorType> benchmark_vector(int64_t n){
+    vector<VectorType> x(n);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        x[i] = 1. + (i % 16) / 16.;
+    }
+    return x;
+}
+
+template <typename VectorType>
+static double benchmark_residual(const vector<VectorType>& y){
+    const vector<double>& y_ref = benchmark_reference();
+    if(y_ref.empty() || y_ref.size() != y.size()){
+        return -1.;
+    }
+    double diff = 0.;
+    double norm = 0.;
+    const int64_t n = y.size();
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(max:diff, norm)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        diff = std::max(diff, std::abs(static_cast<double>(y[i]) - y_ref[i]));
+        norm = std::max(norm, std::abs(y_ref[i]));
+    }
+    return norm > 0. ? diff / norm : diff;
+}
+
+// y = y0 + alpha * A * x (SpMV_axpy), benchmark_residual against y0 + alpha * y_ref
+template <typename VectorType>
+static double benchmark_residual_axpy(const vector<VectorType>& y, const vector<VectorType>& y0, double alpha){
+    const vector<double>& y_ref = benchmark_reference();
+    if(y_ref.empty() || y_ref.size() != y.size() || y0.size() != y.size()){
+        return -1.;
+    }
+    double diff = 0.;
+    double norm = 0.;
+    const int64_t n = y.size();
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(max:diff, norm)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        const double expected = static_cast<double>(y0[i]) + alpha * y_ref[i];
+        diff = std::max(diff, std::abs(static_cast<double>(y[i]) - expected));
+        norm = std::max(norm, std::abs(expected));
+    }
+    return norm > 0. ? diff / norm : diff;
+}
+
+// reference of <w, A * x> in double, from y_ref, 0 without a reference
+template <typename VectorType>
+static double benchmark_dot_reference(const vector<VectorType>& w){
+    const vector<double>& y_ref = benchmark_reference();
+    if(y_ref.size() != w.size()){
+        return 0.;
+    }
+    double dot = 0.;
+    const int64_t n = w.size();
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:dot)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        dot += static_cast<double>(w[i]) * y_ref[i];
+    }
+    return dot;
+}
+
+// relative error of dot = <w, A * x> against benchmark_dot_reference(w)
+template <typename VectorType>
+static double benchmark_residual_dot(double dot, const vector<VectorType>& w){
+    const vector<double>& y_ref = benchmark_reference();
+    if(y_ref.empty() || y_ref.size() != w.size()){
+        return -1.;
+    }
+    const double reference = benchmark_dot_reference(w);
+    const double diff = std::abs(dot - reference);
+    return reference != 0. ? diff / std::abs(reference) : diff;
+}
+
+// SpMM input : column j of the row major block X (n x k) is (j + 1) * benchmark_vector,
+// so a column mix up changes Y
+template <typename VectorType>
+static vector<VectorType> benchmark_block(int64_t n, int k){
+    vector<VectorType> x = benchmark_vector<VectorType>(n);
+    vector<VectorType> X(n * k);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        for(int j = 0; j < k; ++j){
+            X[i * k + j] = static_cast<VectorType>((j + 1.) * x[i]);
+        }
+    }
+    return X;
+}
+
+// the columns of benchmark_block as k separate vectors
+template <typename VectorType>
+static vector<vector<VectorType>> benchmark_columns(int64_t n, int k){
+    vector<VectorType> x = benchmark_vector<VectorType>(n);
+    vector<vector<VectorType>> columns(k, vector<VectorType>(n));
+    for(int j = 0; j < k; ++j){
+        for(int64_t i = 0; i < n; ++i){
+            columns[j][i] = static_cast<VectorType>((j + 1.) * x[i]);
+        }
+    }
+    return columns;
+}
+
+// benchmark_residual of y[i * stride] against scale * y_ref
+template <typename VectorType>
+static double benchmark_residual_scaled(const VectorType* y, int64_t n, int64_t stride, double scale){
+    const vector<double>& y_ref = benchmark_reference();
+    if(y_ref.empty() || static_cast<int64_t>(y_ref.size()) != n){
+        return -1.;
+    }
+    double diff = 0.;
+    double norm = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(max:diff, norm)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        diff = std::max(diff, std::abs(static_cast<double>(y[i * stride]) - scale * y_ref[i]));
+        norm = std::max(norm, std::abs(scale * y_ref[i]));
+    }
+    return norm > 0. ? diff / norm : diff;
+}
+
+// largest column residual of Y = A * benchmark_block(col, k), Y row major n x k
+template <typename VectorType>
+static double benchmark_residual_block(const vector<VectorType>& Y, int k){
+    double residual = 0.;
+    for(int j = 0; j < k; ++j){
+        double r = benchmark_residual_scaled(Y.data() + j, static_cast<int64_t>(Y.size()) / k, k, j + 1.);
+        if(r < 0.){
+            return -1.;
+        }
+        residual = std::max(residual, r);
+    }
+    return residual;
+}
+
+// the same for y[j] = A * column j of benchmark_block
+template <typename VectorType>
+static double benchmark_residual_block(const vector<vector<VectorType>>& y){
+    double residual = 0.;
+    for(size_t j = 0; j < y.size(); ++j){
+        double r = benchmark_residual_scaled(y[j].data(), static_cast<int64_t>(y[j].size()), 1, j + 1.);
+        if(r < 0.){
+            return -1.;
+        }
+        residual = std::max(residual, r);
+    }
+    return residual;
+}
+
+// run spmv() once without warm up, then REPEAT_COUNT times (each timed),
+// print time min / median / max, TFLOPS and GB/s against the STREAM triad
+// bandwidth, record the result and return the time of the repeats
+// bytes : bytes streamed per call (matrix + x + y), 0 skips the bandwidth line
+// residual() : called after the repeats, usually benchmark_residual(y),
+// a negative value means not checked
+template <typename Function, typename ResidualFunction>
+static double spmv_benchmark_run(const string& title, const string& info, double FLOPs, double bytes, Function spmv,
+    ResidualFunction residual, double tolerance){
+    const int repeat_count = std::max(1, env_get_int("REPEAT_COUNT", 10));
+    omp_timer timer;
+    // warm up
+    spmv();
+
+    double time_no_warm_up = timer.timeIncrement();
+
+    vector<double> times(repeat_count);
+    for(int repeat = 0; repeat < repeat_count; ++repeat){
+        double start = omp_get_wtime();
+        spmv();
+        times[repeat] = omp_get_wtime() - start;
+    }
+
+    double time_warm_up = timer.timeIncrement();
+
+    BenchmarkResult result;
+    result.title_ = title;
+    result.info_ = info;
+    result.thread_count_ = omp_get_max_threads();
+    result.repeat_count_ = repeat_count;
+    result.FLOPs_ = FLOPs;
+    result.bytes_ = bytes;
+    result.time_no_warm_up_ = time_no_warm_up;
+    result.time_total_ = time_warm_up;
+    std::sort(times.begin(), times.end());
+    result.time_min_ = times.front();
+    result.time_max_ = times.back();
+    result.time_median_ = (repeat_count % 2 == 1) ? times[repeat_count / 2]
+        : 0.5 * (times[repeat_count / 2 - 1] + times[repeat_count / 2]);
+    result.residual_ = residual();
+    result.tolerance_ = tolerance;
+
+    double TFLOPS = FLOPs / time_no_warm_up * 1e-12;
+
+    double FLOPs_repeat = FLOPs * repeat_count;
+    double TFLOPS_repeat = FLOPs_repeat / time_warm_up * 1e-12;
+
+    cout << title << " benchmark -------------" << endl;
+#ifdef _OPENMP
+    cout << "thread count : " << omp_get_max_threads() << endl;
+#endif
+    if(!info.empty()){
+        cout << info << endl;
+    }
+    cout << "with out warm up : " << endl;
+    cout << "time : " << time_no_warm_up << endl;
+    cout << "FLOPs : " << FLOPs << endl;
+    cout << "TFLOPS : " << TFLOPS << endl;
+    cout << "with warm up and repeat : " << endl;
+    cout << "repeat_count : " << repeat_count << endl;
+    cout << "time : " << time_warm_up << endl;
+    cout << "FLOPs : " << FLOPs_repeat << endl;
+    cout << "TFLOPS : " << TFLOPS_repeat << endl;
+    cout << "time min / median / max : " << result.time_min_ << " / " << result.time_median_ << " / " << result.time_max_ << endl;
+    if(bytes > 0.){
+        double GBs = bytes / result.time_median_ * 1e-9;
+        double stream = stream_triad_bandwidth();
+        cout << "bytes : " << bytes << endl;
+        cout << "GB/s (median) : " << GBs << ", STREAM triad : " << stream << ", fraction : " << GBs / stream << endl;
+    }
+    if(result.residual_ >= 0.){
+        cout << "residual : " << result.residual_ << (result.residual_ <= tolerance ? " (passed)" : " (FAILED)") << endl;
+    }
+    cout << "----------------------------" << endl;
+    benchmark_results().push_back(result);
+    return time_warm_up;
+}
+
+template <typename Function>
+static double spmv_benchmark_run(const string& title, const string& info, double FLOPs, double bytes, Function spmv){
+    return spmv_benchmark_run(title, info, FLOPs, bytes, spmv, [](){ return -1.; }, 0.);
+}
+
+// relative residual allowed for a matrix stored in ValueType
+template <typename ValueType>
+static double benchmark_tolerance(){
+    return 1024. * std::numeric_limits<ValueType>::epsilon();
+}
+
+// spmm() on a block of k vectors against spmv_k(), k separate SpMV calls
+// matrix_bytes / vector_bytes : bytes streamed per SpMV for the matrix and
+// one x + y pair, for the arithmetic intensity estimate
+// spmm_residual() / spmv_residual() : benchmark_residual_block of the results
+template <typename SpMMFunction, typename SpMVFunction, typename SpMMResidualFunction, typename SpMVResidualFunction>
+static void spmm_benchmark_run(const string& title, const string& info, double FLOPs, int k,
+    double matrix_bytes, double vector_bytes, SpMMFunction spmm, SpMVFunction spmv_k,
+    SpMMResidualFunction spmm_residual, SpMVResidualFunction spmv_residual, double tolerance){
+    double time_spmm = spmv_benchmark_run(title + " spmm k=" + std::to_string(k), info, FLOPs * k, matrix_bytes + k * vector_bytes, spmm,
+        spmm_residual, tolerance);
+    double time_spmv = spmv_benchmark_run(title + " spmv x " + std::to_string(k), info, FLOPs * k, k * (matrix_bytes + vector_bytes), spmv_k,
+        spmv_residual, tolerance);
+    cout << "arithmetic intensity spmm : " << FLOPs * k / (matrix_bytes + k * vector_bytes)
+         << ", spmv : " << FLOPs / (matrix_bytes + vector_bytes) << " FLOPs/Byte" << endl;
+    cout << "spmm speedup over " << k << " spmv : " << time_spmv / time_spmm << endl;
+    cout << "----------------------------" << endl;
+}
+
+// "index : int32, value : float"
+template <typename IndexType, typename ValueType>
+static string precision_info(){
+    return string("index : ") + type_name<IndexType>::get() + ", value : " + type_name<ValueType>::get();
+}
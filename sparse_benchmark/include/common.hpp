@@ -11,6 +11,8 @@
 #include <algorithm>
 #include <stdexcept>
 #include <cassert>
+#include <utility>
+#include <limits>
 #ifndef _OPENMP
 #error "must open -fopenmp flag!!!"
 #endif
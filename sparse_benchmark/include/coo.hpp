@@ -19,7 +19,7 @@ public:
     ~COO(){}
 
     COO(IndexType row, IndexType col, IndexType nnz, vector<IndexType> rowidx, vector<IndexType> colidx, vector<ValueType> value)
-        :row_(row), col_(col), nnz_(nnz), rowidx_(rowidx), colidx_(colidx), value_(value), sorted_(false){}
+        :row_(row), col_(col), nnz_(nnz), rowidx_(std::move(rowidx)), colidx_(std::move(colidx)), value_(std::move(value)), sorted_(false){}
 
     COO(const COO& other):row_(other.row_), col_(other.col_), nnz_(other.nnz_), rowidx_(other.rowidx_), colidx_(other.colidx_), value_(other.value_), sorted_(other.sorted_){
         cout << "Warning : COO copy constructor is called !!!" << endl;
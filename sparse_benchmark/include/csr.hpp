@@ -2,32 +2,136 @@
 
 #include "common.hpp"
 #include "coo.hpp"
+#include "numa.hpp"
+
+// thread schedule of CSR SpMV
+enum SpMVSchedule{
+    SPMV_SCHEDULE_ROW,          // equal row count per thread
+    SPMV_SCHEDULE_MERGE_PATH,   // equal (row + nnz) count per thread
+};
+
+SpMVSchedule spmv_schedule_from_string(const string& name);
+string spmv_schedule_to_string(SpMVSchedule schedule);
 
 template <typename IndexType, typename ValueType>
 class CSR{
 private:
     bool sorted_;
+
+    // merge path partition, computed once per thread count and cached
+    // thread t owns merge path items [t, t+1) : (row, nnz) coordinates
+    int merge_path_thread_count_;
+    vector<IndexType> merge_path_row_;
+    vector<IndexType> merge_path_nnz_;
+    // partial sum of the row that crosses the end of each thread
+    vector<IndexType> carry_row_;
+    vector<ValueType> carry_value_;
+
+    void merge_path_search(IndexType diagonal, IndexType& row, IndexType& nnz) const;
+
+    template <typename VectorType>
+    void SpMV_row(VectorType* y, const VectorType* x);
+
+    template <int K>
+    void SpMM_kernel(ValueType* Y, const ValueType* X, int k);
     
 public:
     IndexType row_;
     IndexType col_;
     IndexType nnz_;
-    vector<IndexType> rowptr_;
-    vector<IndexType> colidx_;
-    vector<ValueType> value_;
+    // first touch arrays, see first_touch() / numa_place()
+    numa_vector<IndexType> rowptr_;
+    numa_vector<IndexType> colidx_;
+    numa_vector<ValueType> value_;
 
-    CSR():row_(0),col_(0),nnz_(0),sorted_(false){}
+    CSR():row_(0),col_(0),nnz_(0),sorted_(false),merge_path_thread_count_(0){}
 
     CSR(const COO<IndexType,ValueType>& coo);
 
+    // copy of built arrays (parallel, first touch), columns sorted inside each row
+    CSR(IndexType row, IndexType col, const vector<IndexType>& rowptr, const vector<IndexType>& colidx, const vector<ValueType>& value);
+
+    // index / value width conversion, throws if the indices do not fit
+    template <typename OtherIndexType, typename OtherValueType>
+    explicit CSR(const CSR<OtherIndexType,OtherValueType>& other);
+
     ~CSR(){}
 
-    CSR(const CSR& other):row_(other.row_), col_(other.col_), nnz_(other.nnz_), rowptr_(other.rowptr_), colidx_(other.colidx_), value_(other.value_), sorted_(other.sorted_){
+    CSR(const CSR& other):row_(other.row_), col_(other.col_), nnz_(other.nnz_), rowptr_(other.rowptr_), colidx_(other.colidx_), value_(other.value_), sorted_(other.sorted_), merge_path_thread_count_(0){
         cout << "Warning : CSR copy constructor is called !!!" << endl;
     }
 
+    CSR(CSR&& other):CSR(){
+        swap(other);
+    }
+
+    CSR& operator=(CSR&& other){
+        swap(other);
+        return *this;
+    }
+
+    void swap(CSR& other);
+
+    bool is_sorted() const {return sorted_;};
+
+    // columns strictly increasing inside each row, sets the sorted flag
+    bool check_sorted();
+
+    // serial, long double accumulation, reference y for the residual check
+    void SpMV_reference(vector<double>& y, const vector<double>& x) const;
+
+    // bytes of the matrix arrays streamed by one SpMV
+    double matrix_bytes() const;
+
+    // rowptr_ set, colidx_ / value_ allocated : write the rows in the static
+    // schedule of SpMV, so each page lands on the node of the thread using it
+    void first_touch();
+
+    // reallocate the arrays with the placement
+    void numa_place(NumaPlacement placement);
+
+    // page locality and SpMV bandwidth per NUMA domain, for each placement,
+    // the matrix is left first touch placed
+    void numa_benchmark();
+
+    // schedule is read from env SPMV_SCHEDULE (row | merge), default row
     void spmv_benchmark();
 
+    void spmv_benchmark(SpMVSchedule schedule);
+
+    void spmv_benchmark_mixed();
+
+    void spmm_benchmark(int k);
+
+    // per thread rows / nnz of row and merge path schedule side by side
+    void load_balance_report(int thread_count);
+
+    void build_merge_path_partition(int thread_count);
+
+    // y = A * x
     void SpMV(vector<ValueType>& y, const vector<ValueType>& x);
 
+    void SpMV_merge_path(vector<ValueType>& y, const vector<ValueType>& x);
+
+    void SpMV(vector<ValueType>& y, const vector<ValueType>& x, SpMVSchedule schedule);
+
+    // ValueType storage, double x / y and accumulation
+    void SpMV_mixed(vector<double>& y, const vector<double>& x);
+
+    // fused kernels, one pass with per thread partial sums (row schedule)
+    // y = A * x, returns <x, y>, A square
+    double SpMV_dot(vector<ValueType>& y, const vector<ValueType>& x);
+
+    // y = A * x, returns <r, y>
+    double SpMV_dot(vector<ValueType>& y, const vector<ValueType>& x, const vector<ValueType>& r);
+
+    // z += alpha * A * x
+    void SpMV_axpy(vector<ValueType>& z, ValueType alpha, const vector<ValueType>& x);
+
+    // fused kernels against SpMV followed by the separate vector pass
+    void spmv_fused_benchmark();
+
+    // Y = A * X, X : col_ x k, Y : row_ x k, row major
+    void SpMM(vector<ValueType>& Y, const vector<ValueType>& X, int k);
+
 };
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+#include "numa.hpp"
+
+// bytes after the last offset, the SIMD decoder loads full vectors of offsets
+#define CSR_COMPRESSED_PAD 64
+
+// CSR with compressed column indices, frame of reference per row :
+//   col(idx) = base_[r] + offset(idx), base_[r] = smallest column of row r
+// offsets are bit packed with one width for the matrix, the smallest of
+// 8 / 16 / 32 bits that holds the widest row span (max col - min col), so a
+// banded FV matrix stores 1 or 2 bytes per entry instead of sizeof(IndexType).
+// every offset decodes on its own (no prefix sum over the row), so the SpMV
+// decodes a SIMD vector of offsets with one widening load + add into the
+// gather indices (AVX-512 / AVX2, portable loop otherwise)
+// entries keep the order of the source CSR
+template <typename IndexType, typename ValueType>
+class CSRCompressed{
+public:
+    IndexType row_;
+    IndexType col_;
+    IndexType nnz_;
+    int width_;                     // bytes per offset : 1, 2 or 4
+    numa_vector<IndexType> rowptr_;
+    numa_vector<IndexType> base_;
+    numa_vector<uint8_t> packed_;   // nnz_ * width_ + CSR_COMPRESSED_PAD bytes
+    numa_vector<ValueType> value_;
+
+    CSRCompressed(const CSR<IndexType, ValueType>& A);
+
+    CSRCompressed(const CSRCompressed&) = delete;
+    CSRCompressed& operator=(const CSRCompressed&) = delete;
+
+    // bytes of the column index stream : base_ + offsets
+    double index_bytes() const;
+
+    // bytes of the matrix arrays streamed by one SpMV
+    double matrix_bytes() const;
+
+    // y = A * x
+    void SpMV(vector<ValueType>& y, const vector<ValueType>& x) const;
+
+    void print_info() const;
+};
+
+// SpMV of csr against its CSRCompressed : index compression ratio, matrix bytes
+// and the median time gain end to end
+template <typename IndexType, typename ValueType>
+void compressed_benchmark(CSR<IndexType, ValueType>& csr);
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+#include "numa.hpp"
+
+// largest column gap a 16 bit delta holds
+#define CSR_MIXED_DELTA_MAX 65535
+
+// CSR with ValueType (float) storage, double x / y and accumulation
+// columns of a row are sorted, with delta16 the row keeps its first column in
+// row_col_ and every entry the gap to the previous column of the row :
+//   col(idx) = row_col_[r] + delta_[rowptr_[r]] + ... + delta_[idx], delta_[rowptr_[r]] = 0
+// if a gap does not fit in 16 bits the full colidx_ is kept instead
+// rowptr_ / value_ / row_ match CSR, so the Krylov solvers of solver.hpp run on it
+template <typename IndexType, typename ValueType>
+class CSRMixed{
+private:
+    // sum_j a_ij x_j of row r, in double
+    double row_product(IndexType r, const double* x) const;
+
+public:
+    IndexType row_;
+    IndexType col_;
+    IndexType nnz_;
+    bool delta16_;
+    numa_vector<IndexType> rowptr_;
+    numa_vector<IndexType> row_col_;    // delta16_ : first column of each row
+    numa_vector<uint16_t> delta_;       // delta16_ : column gaps
+    numa_vector<IndexType> colidx_;     // !delta16_ : columns
+    numa_vector<ValueType> value_;
+
+    // values rounded to ValueType, delta16 : try the 16 bit column deltas
+    CSRMixed(const CSR<IndexType, double>& A, bool delta16 = true);
+
+    CSRMixed(const CSRMixed&) = delete;
+    CSRMixed& operator=(const CSRMixed&) = delete;
+
+    // bytes of the matrix arrays streamed by one SpMV
+    double matrix_bytes() const;
+
+    // y = A * x
+    void SpMV(vector<double>& y, const vector<double>& x) const;
+
+    // y = A * x, returns <x, y>, A square
+    double SpMV_dot(vector<double>& y, const vector<double>& x) const;
+
+    // y = A * x, returns <r, y>
+    double SpMV_dot(vector<double>& y, const vector<double>& x, const vector<double>& r) const;
+
+    void print_info() const;
+
+    // SpMV against benchmark_reference(), matrix bytes against CSR<IndexType, double>
+    void benchmark() const;
+};
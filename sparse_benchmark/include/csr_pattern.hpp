@@ -0,0 +1,49 @@
+#pragma once
+
+#include "common.hpp"
+#include "coo.hpp"
+#include "csr.hpp"
+#include "ldu.hpp"
+
+// CSR sparsity pattern built once, plus the map from the input value order to
+// the CSR slots : source_[slot] = position of the value in the input, so when
+// only the coefficients change (same pattern every time step) the values of a
+// CSR are refreshed by a parallel gather, no sort and no allocation
+//   COO input : position in coo.value_, the coo may be in any order, entries distinct
+//   LDU input : position in [diag_ | upper_ | lower()], cell_count_ + 2 * face_count_ values
+template <typename IndexType, typename ValueType>
+class CSRPattern{
+private:
+    // sort the input positions by (row, col) into rowptr_ / colidx_ / source_
+    void build(const IndexType* rowidx, const IndexType* colidx, IndexType nnz);
+
+public:
+    IndexType row_;
+    IndexType col_;
+    IndexType nnz_;
+    IndexType cell_count_;  // LDU layout of source_, 0 for COO input
+    IndexType face_count_;
+    vector<IndexType> rowptr_;
+    vector<IndexType> colidx_;
+    vector<IndexType> source_;
+
+    CSRPattern(const COO<IndexType, ValueType>& coo);
+
+    CSRPattern(const LDU<IndexType, ValueType>& ldu);
+
+    // CSR with the pattern and zero values, then refresh() it
+    CSR<IndexType, ValueType> csr() const;
+
+    // csr.value_[slot] = value[source_[slot]], value in the COO input order
+    void refresh(CSR<IndexType, ValueType>& csr, const vector<ValueType>& value) const;
+
+    // csr.value_[slot] from the diag_ / upper_ / lower() of an LDU with the pattern
+    void refresh(CSR<IndexType, ValueType>& csr, const LDU<IndexType, ValueType>& ldu) const;
+
+    void print_info() const;
+};
+
+// full rebuild (COO sort + CSR(coo), LDU::to_csr) against the value refresh,
+// from a COO in reversed (assembly like) order and from the LDU of csr
+template <typename IndexType, typename ValueType>
+void refresh_benchmark(const CSR<IndexType, ValueType>& csr);
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mpi.h>
+#include "common.hpp"
+#include "csr.hpp"
+
+template <typename T> struct mpi_type;
+template <> struct mpi_type<int32_t>{static MPI_Datatype get(){return MPI_INT32_T;}};
+template <> struct mpi_type<int64_t>{static MPI_Datatype get(){return MPI_INT64_T;}};
+template <> struct mpi_type<float>{static MPI_Datatype get(){return MPI_FLOAT;}};
+template <> struct mpi_type<double>{static MPI_Datatype get(){return MPI_DOUBLE;}};
+
+// row block distributed square CSR, rank p owns global rows [row_offset_[p], row_offset_[p+1]),
+// blocks balanced by nnz. the owned rows are split into
+//   local_  : columns owned by this rank, renumbered to local rows
+//   remote_ : the other columns, renumbered to halo slots
+// the halo (ghost x) is sorted by global column, so it is grouped by owner rank
+// and each neighbour sends one contiguous message
+template <typename IndexType, typename ValueType>
+class DistributedCSR{
+private:
+    MPI_Comm comm_;
+    int rank_;
+    int size_;
+
+    // receive : halo slots [recv_ptr_[n], recv_ptr_[n+1]) come from recv_rank_[n]
+    vector<int> recv_rank_;
+    vector<IndexType> recv_ptr_;
+    // send : x[send_index_[k]], k in [send_ptr_[n], send_ptr_[n+1]), goes to send_rank_[n]
+    vector<int> send_rank_;
+    vector<IndexType> send_ptr_;
+    vector<IndexType> send_index_;
+
+    vector<ValueType> send_buffer_;
+    vector<ValueType> halo_;
+    vector<MPI_Request> requests_;
+
+    // send buffer packed, receives and sends posted
+    void start_exchange(const vector<ValueType>& x);
+
+public:
+    vector<IndexType> row_offset_;  // size_ + 1
+    IndexType row_begin_;
+    IndexType row_count_;
+    vector<IndexType> halo_col_;    // global column of each halo slot
+    CSR<IndexType, ValueType> local_;
+    CSR<IndexType, ValueType> remote_;
+
+    // time split of the SpMV calls since the last reset_timers()
+    double time_exchange_start_;    // pack + post
+    double time_local_;
+    double time_wait_;
+    double time_remote_;
+    int64_t spmv_count_;
+
+    // global is read on rank 0 only (the other ranks pass an empty CSR) : rank 0
+    // splits the rows and sends every rank its row block
+    DistributedCSR(const CSR<IndexType, ValueType>& global, MPI_Comm comm);
+
+    DistributedCSR(const DistributedCSR&) = delete;
+    DistributedCSR& operator=(const DistributedCSR&) = delete;
+
+    void reset_timers();
+
+    // y = A x on the owned rows, x / y : row_count_ entries
+    // the local block product runs while the halo exchange is in flight
+    void SpMV(vector<ValueType>& y, const vector<ValueType>& x);
+
+    // exchange first, then local + remote, the non overlapped baseline
+    void SpMV_blocking(vector<ValueType>& y, const vector<ValueType>& x);
+
+    // rows / nnz / halo / neighbours, min / max over the ranks, printed on rank 0
+    void print_info() const;
+
+    // both SpMV variants : time per call, communication vs compute split,
+    // residual of the owned rows against benchmark_reference() of rank 0, printed on rank 0
+    void benchmark();
+};
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <cstdint>
 
 static bool env_get_bool(const char* name, bool default_value){
@@ -31,3 +32,11 @@ static int64_t env_get_int64(const char* name, int64_t default_value){
     }
     return std::atol(tmp);
 }
+
+static double env_get_double(const char* name, double default_value){
+    char* tmp = getenv(name);
+    if(tmp == NULL){
+        return default_value;
+    }
+    return std::atof(tmp);
+}
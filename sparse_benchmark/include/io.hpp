@@ -1,6 +1,22 @@
 #pragma once
 
 #include "coo.hpp"
+#include "csr.hpp"
 
 COO<int64_t, double> read_coo_from_pattern_mtx(string filename);
 
+// mmap + multithreaded Matrix Market reader
+// coordinate pattern / integer / real / complex (real part),
+// general / symmetric / skew-symmetric / hermitian (expanded)
+COO<int64_t, double> read_coo_from_mtx(string filename);
+
+// binary CSR sidecar : <filename>.csr.bin, the header holds a magic, a
+// version, the index / value widths and the size and mtime of the source mtx
+string csr_binary_filename(const string& filename);
+void write_csr_binary(const CSR<int64_t, double>& csr, string filename, string source);
+// false if the sidecar is missing, of another version or source, or truncated
+bool read_csr_binary(CSR<int64_t, double>& csr, string filename, string source);
+
+// load the sidecar if it matches the mtx file, otherwise read the
+// mtx, build the CSR and write the sidecar (env MTX_BINARY_CACHE, default true)
+CSR<int64_t, double> read_csr_from_mtx(string filename);
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "common.hpp"
+#include "coo.hpp"
+#include "csr.hpp"
+
+// LDU matrix as stored by OpenFOAM / DeepFlame lduMatrix
+// face f couples owner lower_addr_[f] < neighbour upper_addr_[f] :
+//   A(lower_addr_[f], upper_addr_[f]) = upper_[f]
+//   A(upper_addr_[f], lower_addr_[f]) = lower_[f]
+// faces are ordered by owner, then neighbour (upper triangular order).
+// A symmetric matrix keeps only upper_ (lower_ is empty).
+template <typename IndexType, typename ValueType>
+class LDU{
+private:
+    // face partition for the parallel Amul, cached per thread count
+    // thread t owns cells [thread_cell_start_[t], thread_cell_start_[t+1])
+    // and the faces whose owner it owns; lower coefficients of faces whose
+    // neighbour lies in another thread are gathered by that thread through
+    // incoming_face_, so no thread writes outside its own cells
+    int partition_thread_count_;
+    vector<IndexType> thread_cell_start_;
+    vector<IndexType> thread_face_start_;
+    vector<IndexType> incoming_ptr_;
+    vector<IndexType> incoming_face_;
+
+    template <typename VectorType>
+    void Amul_kernel(VectorType* y, const VectorType* x);
+
+    template <int K>
+    void SpMM_kernel(ValueType* Y, const ValueType* X, int k);
+
+public:
+    IndexType cell_count_;
+    IndexType face_count_;
+    bool symmetric_;
+    vector<IndexType> lower_addr_;  // owner
+    vector<IndexType> upper_addr_;  // neighbour
+    vector<ValueType> diag_;
+    vector<ValueType> upper_;
+    vector<ValueType> lower_;
+
+    LDU():partition_thread_count_(0),cell_count_(0),face_count_(0),symmetric_(false){}
+
+    // faces come from the (structurally symmetrized) off diagonal pattern,
+    // missing mirror entries get coefficient 0
+    // symmetric storage is used when every lower == upper and detect_symmetric
+    LDU(const CSR<IndexType,ValueType>& csr, bool detect_symmetric = true);
+
+    ~LDU(){}
+
+    const vector<ValueType>& lower() const {return symmetric_ ? upper_ : lower_;}
+
+    CSR<IndexType,ValueType> to_csr() const;
+
+    void print_info();
+
+    // bytes of the matrix arrays streamed by one SpMV
+    double matrix_bytes() const;
+
+    void build_partition(int thread_count);
+
+    void spmv_benchmark();
+
+    void spmv_benchmark_mixed();
+
+    void spmm_benchmark(int k);
+
+    // y = A * x, OpenFOAM lduMatrix::Amul
+    void Amul(vector<ValueType>& y, const vector<ValueType>& x);
+
+    void SpMV(vector<ValueType>& y, const vector<ValueType>& x){Amul(y, x);}
+
+    // Y = A * X, X : col x k, Y : row x k, row major
+    void SpMM(vector<ValueType>& Y, const vector<ValueType>& X, int k);
+
+    // ValueType storage, double x / y and accumulation
+    void Amul_mixed(vector<double>& y, const vector<double>& x);
+
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "common.hpp"
+#include <new>
+
+// allocator that leaves default constructed elements uninitialized : resize()
+// does not touch the pages, so the first (parallel) write decides the NUMA node
+// of each page. assign() / resize(n, value) still write from the calling thread
+template <typename T>
+class first_touch_allocator : public std::allocator<T>{
+public:
+    template <typename U>
+    struct rebind{
+        typedef first_touch_allocator<U> other;
+    };
+
+    first_touch_allocator() noexcept {}
+
+    template <typename U>
+    first_touch_allocator(const first_touch_allocator<U>&) noexcept {}
+
+    template <typename U>
+    void construct(U* p){
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args){
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename T>
+using numa_vector = vector<T, first_touch_allocator<T>>;
+
+// where the pages of the CSR arrays live
+enum NumaPlacement{
+    NUMA_PLACEMENT_MASTER,      // serial copy : every page on the node of the master thread
+    NUMA_PLACEMENT_FIRST_TOUCH, // parallel copy with the static row schedule of SpMV
+};
+
+NumaPlacement numa_placement_from_string(const string& name);
+string numa_placement_to_string(NumaPlacement placement);
+
+// NUMA node of the calling thread (getcpu), 0 when unknown
+int numa_current_node();
+
+// NUMA node of each page, -1 when unknown (move_pages query, nothing moves)
+void numa_page_nodes(const void* const* pages, int64_t count, int* nodes);
+
+// env NUMA_PIN=true pins OpenMP thread t to the t-th cpu of the process mask,
+// only when the runtime does not bind (no OMP_PLACES / OMP_PROC_BIND),
+// returns true when threads were pinned here
+bool numa_pin_threads();
+
+// proc bind, places and the cpu / node of every thread
+void numa_print_binding();
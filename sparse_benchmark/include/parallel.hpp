@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <omp.h>
+
+// exclusive prefix sum of data[0, n) in place, returns the total
+// two pass blocked scan : local sums, scan of block sums, local scan
+template <typename T>
+static T parallel_exclusive_scan(T* data, int64_t n){
+    const int thread_count = omp_get_max_threads();
+    std::vector<T> block_sum(thread_count + 1, 0);
+
+    #pragma omp parallel num_threads(thread_count)
+    {
+        const int t = omp_get_thread_num();
+        const int nt = omp_get_num_threads();
+        const int64_t start = n * t / nt;
+        const int64_t end = n * (t + 1) / nt;
+
+        T local = 0;
+        for(int64_t i = start; i < end; ++i){
+            local += data[i];
+        }
+        block_sum[t + 1] = local;
+
+        #pragma omp barrier
+        #pragma omp single
+        {
+            for(int i = 0; i < nt; ++i){
+                block_sum[i + 1] += block_sum[i];
+            }
+        }
+
+        T running = block_sum[t];
+        for(int64_t i = start; i < end; ++i){
+            T tmp = data[i];
+            data[i] = running;
+            running += tmp;
+        }
+    }
+    return block_sum[thread_count];
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+#include "triangular.hpp"
+
+enum PreconditionerType{
+    PRECONDITIONER_NONE,
+    PRECONDITIONER_JACOBI,  // w = r / diag(A)
+    PRECONDITIONER_DIC,     // diagonal incomplete Cholesky, A symmetric
+    PRECONDITIONER_DILU,    // diagonal incomplete LU
+    PRECONDITIONER_SGS,     // symmetric Gauss-Seidel, D = diag(A)
+};
+
+PreconditionerType preconditioner_type_from_string(const string& name);
+string preconditioner_type_to_string(PreconditionerType type);
+
+// OpenFOAM style DIC / DILU on CSR : M = (D + L) D^-1 (D + U), where only the
+// diagonal D is modified, rD_ keeps D^-1
+//   DILU : D_i = a_ii - sum_{j<i} a_ij a_ji / D_j
+//   DIC  : D_i = a_ii - sum_{j<i} a_ij^2 / D_j
+//   SGS  : D_i = a_ii
+// the forward / backward sweeps run on Triangular, level scheduled by default
+// rows of A have to be sorted and contain the diagonal
+template <typename IndexType, typename ValueType>
+class Preconditioner{
+private:
+    PreconditionerType type_;
+    const CSR<IndexType, ValueType>& A_;
+    vector<IndexType> diag_pos_;   // position of a_ii in row i
+    vector<ValueType> rD_;         // reciprocal (modified) diagonal
+    TriangularSchedule schedule_;
+    Triangular<IndexType, ValueType>* triangular_;
+
+public:
+    Preconditioner(const CSR<IndexType, ValueType>& A, PreconditionerType type,
+        TriangularSchedule schedule = TRIANGULAR_SCHEDULE_LEVEL);
+
+    ~Preconditioner(){
+        delete triangular_;
+    }
+
+    Preconditioner(const Preconditioner&) = delete;
+    Preconditioner& operator=(const Preconditioner&) = delete;
+
+    PreconditionerType type() const {return type_;}
+
+    // w = M^-1 r
+    void precondition(vector<ValueType>& w, const vector<ValueType>& r) const;
+
+    // sweeps times x += M^-1 (b - A x), r / w are work vectors
+    void smooth(vector<ValueType>& x, const vector<ValueType>& b, int sweeps, vector<ValueType>& r, vector<ValueType>& w) const;
+};
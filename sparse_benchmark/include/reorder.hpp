@@ -0,0 +1,41 @@
+#pragma once
+
+#include "common.hpp"
+#include "coo.hpp"
+#include "csr.hpp"
+
+// symmetric reordering P A P^T, applied between COO and CSR build
+enum ReorderMethod{
+    REORDER_NONE,
+    REORDER_RCM,        // reverse Cuthill-McKee, minimizes bandwidth
+    REORDER_BISECTION,  // recursive level structure bisection, parts of at most part_size rows
+    REORDER_MULTICOLOR, // greedy colouring, rows grouped by colour : one level per colour in Triangular
+};
+
+ReorderMethod reorder_method_from_string(const string& name);
+string reorder_method_to_string(ReorderMethod method);
+
+// orderings are returned as perm[new] = old, computed on the pattern of A + A^T
+
+template <typename IndexType, typename ValueType>
+vector<IndexType> rcm_ordering(const CSR<IndexType, ValueType>& csr);
+
+template <typename IndexType, typename ValueType>
+vector<IndexType> bisection_ordering(const CSR<IndexType, ValueType>& csr, IndexType part_size);
+
+// first fit colouring in row order, color_count = colours used
+template <typename IndexType, typename ValueType>
+vector<IndexType> multicolor_ordering(const CSR<IndexType, ValueType>& csr, IndexType& color_count);
+
+// relabel rows and columns of csr with perm, the result is not sorted
+template <typename IndexType, typename ValueType>
+COO<IndexType, ValueType> permute_symmetric(const CSR<IndexType, ValueType>& csr, const vector<IndexType>& perm);
+
+// bandwidth : max |i - j|, profile : sum over rows of i - min(j, i)
+template <typename IndexType, typename ValueType>
+void bandwidth_profile(const CSR<IndexType, ValueType>& csr, IndexType& bandwidth, double& profile);
+
+// compute the ordering, apply it and print bandwidth / profile before and after
+// part_size is only used by REORDER_BISECTION
+template <typename IndexType, typename ValueType>
+CSR<IndexType, ValueType> reorder(const CSR<IndexType, ValueType>& csr, ReorderMethod method, IndexType part_size);
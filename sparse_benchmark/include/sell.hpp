@@ -0,0 +1,73 @@
+#pragma once
+
+#include "common.hpp"
+#include "coo.hpp"
+#include "csr.hpp"
+
+// chunk height C = SIMD width in doubles
+#if defined(__AVX512F__)
+#define SELL_CHUNK 8
+#elif defined(__AVX2__)
+#define SELL_CHUNK 4
+#else
+#define SELL_CHUNK 8
+#endif
+
+#define SELL_SIGMA 256
+
+// SELL-C-sigma (Kreutzer et al., SIAM J. Sci. Comput. 2014)
+// rows are sorted by length inside windows of sigma rows, then packed in
+// chunks of C rows. Inside a chunk the storage is column major, so the j-th
+// nonzero of the C rows is contiguous and maps to the C SIMD lanes.
+template <typename IndexType, typename ValueType>
+class SELL{
+private:
+
+public:
+    const IndexType chunk_size_; // C
+    IndexType sigma_;
+
+    IndexType row_;
+    IndexType col_;
+    IndexType nnz_;
+    IndexType padded_nnz_;  // nnz with zero fill of chunks
+
+    IndexType chunk_count_;
+    vector<IndexType> chunk_ptr_;   // chunk_count_ + 1, offset of each chunk
+    vector<IndexType> chunk_len_;   // chunk_count_, width of each chunk
+    vector<IndexType> perm_;        // sorted row -> original row
+    vector<IndexType> colidx_;
+    vector<ValueType> value_;
+
+    SELL():chunk_size_(SELL_CHUNK),sigma_(SELL_SIGMA),row_(0),col_(0),nnz_(0),padded_nnz_(0),chunk_count_(0){}
+
+    SELL(const CSR<IndexType,ValueType>& csr, IndexType sigma = SELL_SIGMA);
+
+    SELL(const COO<IndexType,ValueType>& coo, IndexType sigma = SELL_SIGMA);
+
+    ~SELL(){}
+
+    void print_info();
+
+    // bytes of the matrix arrays streamed by one SpMV
+    double matrix_bytes() const;
+
+    void spmv_benchmark();
+
+    void spmv_benchmark_mixed();
+
+    void spmm_benchmark(int k);
+
+    // y = A * x
+    void SpMV(vector<ValueType>& y, const vector<ValueType>& x);
+
+    // Y = A * X, X : col x k, Y : row x k, row major
+    void SpMM(vector<ValueType>& Y, const vector<ValueType>& X, int k);
+
+    // ValueType storage, double x / y and accumulation
+    void SpMV_mixed(vector<double>& y, const vector<double>& x);
+
+private:
+    void build(const CSR<IndexType,ValueType>& csr);
+
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+#include "csr_mixed.hpp"
+#include "preconditioner.hpp"
+
+enum SolverType{
+    SOLVER_PCG,         // A symmetric positive definite
+    SOLVER_PBICGSTAB,
+    SOLVER_GAMG,        // V-cycles of AMG, the preconditioner is not used
+};
+
+SolverType solver_type_from_string(const string& name);
+string solver_type_to_string(SolverType type);
+
+// OpenFOAM convention : residual = sum |b - A x| / normFactor,
+// converged when residual < tolerance or residual < rel_tol * initial residual
+struct SolverControl{
+    double tolerance_;
+    double rel_tol_;
+    int max_iter_;
+};
+
+struct SolverPerformance{
+    string solver_;
+    string preconditioner_;
+    int iterations_;
+    double initial_residual_;
+    double final_residual_;
+    bool converged_;
+    int spmv_count_;
+    int precondition_count_;
+    double time_total_;
+    double time_spmv_;         // including the dot products fused into SpMV_dot
+    double time_precondition_;
+    double time_reduction_;     // reductions and the vector updates fused with them
+
+    void print() const;
+};
+
+bool solver_converged(const SolverControl& control, double initial, double residual);
+
+// MatrixType : CSR<IndexType, ValueType>, or CSRMixed<IndexType, float> with double vectors
+// (row_, rowptr_, value_, SpMV, SpMV_dot)
+
+// one pass over A and the vectors, yA = A x on entry :
+//   normFactor = sum |yA - pA| + |b - pA| + small, pA = average(x) * rowsum(A)
+//   r = b - yA, returns sum |r|
+template <typename MatrixType, typename VectorType>
+double solver_initial_residual(const MatrixType& A, const vector<VectorType>& x, const vector<VectorType>& yA,
+    const vector<VectorType>& b, vector<VectorType>& r, double& norm_factor);
+
+template <typename MatrixType, typename IndexType, typename ValueType>
+SolverPerformance pcg_solve(MatrixType& A, const Preconditioner<IndexType, ValueType>& M,
+    vector<ValueType>& x, const vector<ValueType>& b, const SolverControl& control);
+
+template <typename MatrixType, typename IndexType, typename ValueType>
+SolverPerformance pbicgstab_solve(MatrixType& A, const Preconditioner<IndexType, ValueType>& M,
+    vector<ValueType>& x, const vector<ValueType>& b, const SolverControl& control);
+
+// mixed precision iterative refinement, until control is met on A :
+//   r = b - A x            double values (A)
+//   A_low d = r            pcg / pbicgstab to inner_rel_tol, float values (A_low), double accumulation
+//   x += d
+// M is built on A, iterations_ / spmv_count_ / times sum the inner solves,
+// refinement_steps the outer corrections
+template <typename IndexType>
+SolverPerformance refinement_solve(CSR<IndexType, double>& A, CSRMixed<IndexType, float>& A_low,
+    const Preconditioner<IndexType, double>& M, SolverType inner, vector<double>& x, const vector<double>& b,
+    const SolverControl& control, double inner_rel_tol, int& refinement_steps);
+
+// replace the values with a shifted graph Laplacian of the pattern :
+// a_ij = -1 off the diagonal, a_ii = (1 + shift) * off diagonal count,
+// SPD for a symmetric pattern, so pattern only mtx files can be solved
+template <typename IndexType, typename ValueType>
+void set_laplacian_values(CSR<IndexType, ValueType>& A, double shift);
+
+// build the preconditioner (the AMG hierarchy for SOLVER_GAMG, control from env),
+// solve A x = b from x = 0 with b = A * benchmark_vector, print the error and the time split
+template <typename IndexType, typename ValueType>
+SolverPerformance solver_benchmark(CSR<IndexType, ValueType>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
+
+// solver (pcg | pbicgstab) in double against iterative refinement on CSRMixed<IndexType, float>,
+// same b / x_exact as solver_benchmark, prints residual, error, time and the SpMV bytes of both,
+// env REFINEMENT_INNER_REL_TOL (default 1e-3), MIXED_DELTA16 (default true)
+template <typename IndexType>
+void refinement_benchmark(CSR<IndexType, double>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
@@ -1,6 +1,20 @@
 #pragma once
 
 #include <common.hpp>
+#include <benchmark.hpp>
+#include <numa.hpp>
 #include <io.hpp>
 #include <coo.hpp>
 #include <csr.hpp>
+#include <sell.hpp>
+#include <ldu.hpp>
+#include <csr_pattern.hpp>
+#include <csr_mixed.hpp>
+#include <csr_compressed.hpp>
+#include <reorder.hpp>
+#include <triangular.hpp>
+#include <preconditioner.hpp>
+#include <spgemm.hpp>
+#include <solver.hpp>
+#include <amg.hpp>
+#include <distributed.hpp>
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+
+// row accumulator of C = A * B
+enum SpGEMMAccumulator{
+    SPGEMM_ACCUMULATOR_AUTO,    // per row : ESC up to SPGEMM_ESC_MAX_FLOP products, hash above
+    SPGEMM_ACCUMULATOR_HASH,    // open addressing table, linear probing
+    SPGEMM_ACCUMULATOR_ESC,     // expand, sort, compress
+};
+
+SpGEMMAccumulator spgemm_accumulator_from_string(const string& name);
+string spgemm_accumulator_to_string(SpGEMMAccumulator accumulator);
+
+// short rows sort faster than they hash
+#define SPGEMM_ESC_MAX_FLOP 32
+
+// two phase C = A * B : the constructor runs the symbolic phase (row products,
+// accumulator per row, pattern of C), numeric() computes the values on it
+// reuse : when only the values of A and B change (same pattern, same objects),
+// keep the SpGEMM and call numeric() again, the symbolic phase is not repeated
+template <typename IndexType, typename ValueType>
+class SpGEMM{
+private:
+    const CSR<IndexType, ValueType>& A_;
+    const CSR<IndexType, ValueType>& B_;
+    SpGEMMAccumulator accumulator_;
+    vector<int64_t> row_flop_;      // products of row i : sum over a_ik of nnz(B row k)
+    vector<char> row_esc_;          // accumulator of row i, 1 : ESC, 0 : hash
+    vector<IndexType> rowptr_;      // pattern of C, columns sorted
+    vector<IndexType> colidx_;
+    int64_t flop_;
+    int64_t max_row_flop_;
+
+    void symbolic();
+
+public:
+    SpGEMM(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B,
+        SpGEMMAccumulator accumulator = SPGEMM_ACCUMULATOR_AUTO);
+
+    // C with the pattern of the symbolic phase and the values of A * B
+    CSR<IndexType, ValueType> multiply() const;
+
+    // values of C from the current values of A and B, C from multiply()
+    void numeric(CSR<IndexType, ValueType>& C) const;
+
+    // multiply-add count, 2 * flop() FLOPs
+    int64_t flop() const {return flop_;}
+
+    IndexType nnz() const {return rowptr_.back();}
+
+    void print_info() const;
+};
+
+// C = A * B, one call to both phases
+template <typename IndexType, typename ValueType>
+CSR<IndexType, ValueType> spgemm(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B,
+    SpGEMMAccumulator accumulator = SPGEMM_ACCUMULATOR_AUTO);
+
+// A * B with each accumulator : symbolic + numeric, numeric only (reuse),
+// checked against A (B x)
+template <typename IndexType, typename ValueType>
+void spgemm_benchmark(CSR<IndexType, ValueType>& A, CSR<IndexType, ValueType>& B);
@@ -0,0 +1,47 @@
+#pragma once
+
+// SpMM : Y = A * X, X (col x k) and Y (row x k) are row major blocks of k vectors
+// kernels are templates on K, the block width known at compile time,
+// K = 0 is the generic kernel for any k
+
+#define SPMM_MAX_K 32
+
+#define SPMM_CASE(F, K) case K : F(K); break;
+
+// call F(K) with K = k for k in [1, SPMM_MAX_K], F(0) otherwise
+#define SPMM_DISPATCH(k, F) \
+    switch(k){ \
+        SPMM_CASE(F, 1) \
+        SPMM_CASE(F, 2) \
+        SPMM_CASE(F, 3) \
+        SPMM_CASE(F, 4) \
+        SPMM_CASE(F, 5) \
+        SPMM_CASE(F, 6) \
+        SPMM_CASE(F, 7) \
+        SPMM_CASE(F, 8) \
+        SPMM_CASE(F, 9) \
+        SPMM_CASE(F, 10) \
+        SPMM_CASE(F, 11) \
+        SPMM_CASE(F, 12) \
+        SPMM_CASE(F, 13) \
+        SPMM_CASE(F, 14) \
+        SPMM_CASE(F, 15) \
+        SPMM_CASE(F, 16) \
+        SPMM_CASE(F, 17) \
+        SPMM_CASE(F, 18) \
+        SPMM_CASE(F, 19) \
+        SPMM_CASE(F, 20) \
+        SPMM_CASE(F, 21) \
+        SPMM_CASE(F, 22) \
+        SPMM_CASE(F, 23) \
+        SPMM_CASE(F, 24) \
+        SPMM_CASE(F, 25) \
+        SPMM_CASE(F, 26) \
+        SPMM_CASE(F, 27) \
+        SPMM_CASE(F, 28) \
+        SPMM_CASE(F, 29) \
+        SPMM_CASE(F, 30) \
+        SPMM_CASE(F, 31) \
+        SPMM_CASE(F, 32) \
+        default : F(0); break; \
+    }
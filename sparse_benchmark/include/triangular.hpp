@@ -0,0 +1,51 @@
+#pragma once
+
+#include "common.hpp"
+#include "csr.hpp"
+
+enum TriangularSchedule{
+    TRIANGULAR_SCHEDULE_SERIAL,  // row order, one thread
+    TRIANGULAR_SCHEDULE_LEVEL,   // level sets, rows of one level in parallel
+};
+
+TriangularSchedule triangular_schedule_from_string(const string& name);
+string triangular_schedule_to_string(TriangularSchedule schedule);
+
+// sparse triangular sweeps on the strict lower / upper part of a CSR
+//   lower : x_i = c_i * b_i - s_i * sum_{j<i} a_ij x_j   (rows ascending)
+//   upper : x_i = c_i * b_i - s_i * sum_{j>i} a_ij x_j   (rows descending)
+// c = s = 1 / diag(A) is the plain (D + L) / (D + U) solve, c == NULL means
+// c = 1, x and b may alias.
+// level sets are computed once : level(i) = 1 + max level(j) over the rows j
+// row i depends on, the rows of one level are independent.
+// rows of A have to be sorted.
+template <typename IndexType, typename ValueType>
+class Triangular{
+private:
+    const CSR<IndexType, ValueType>& A_;
+    vector<IndexType> lower_end_;       // first entry of row i with col >= i
+    vector<IndexType> upper_begin_;     // first entry of row i with col > i
+    vector<IndexType> lower_level_ptr_;
+    vector<IndexType> lower_level_row_;
+    vector<IndexType> upper_level_ptr_;
+    vector<IndexType> upper_level_row_;
+
+    void build_levels(bool lower);
+
+public:
+    Triangular(const CSR<IndexType, ValueType>& A);
+
+    ~Triangular(){}
+
+    IndexType lower_level_count() const {return lower_level_ptr_.size() - 1;}
+    IndexType upper_level_count() const {return upper_level_ptr_.size() - 1;}
+
+    void lower_solve(ValueType* x, const ValueType* b, const ValueType* c, const ValueType* s, TriangularSchedule schedule) const;
+    void upper_solve(ValueType* x, const ValueType* b, const ValueType* c, const ValueType* s, TriangularSchedule schedule) const;
+
+    // level count, average / max rows per level
+    void print_info() const;
+
+    // serial against level scheduled lower and upper solves with 1 / diag(A)
+    void benchmark() const;
+};
@@ -1,21 +1,67 @@
 #!/bin/bash
 
+MATRIX=${MATRIX:-/vol0001/hp230257/guozhuoqiang/DeepFlame/deepflame-dev/examples/dfLowMachFoam/threeD_reactingTGV/CH4/Grid128_2pi_8_2x2x2/sparse_pattern_0.mtx}
+
 export OMP_NUM_THREADS=1
 export REPEAT_COUNT=1
 
-./bin/test
+./bin/test $MATRIX
 
 export OMP_NUM_THREADS=1
 export REPEAT_COUNT=100
 
-./bin/test
+./bin/test $MATRIX
 
 export OMP_NUM_THREADS=6
 export REPEAT_COUNT=1
 
-./bin/test
+./bin/test $MATRIX
+
+export OMP_NUM_THREADS=6
+export REPEAT_COUNT=100
+
+./bin/test $MATRIX
+
+export OMP_NUM_THREADS=6
+export REPEAT_COUNT=100
+export SPMV_SCHEDULE=merge
+
+./bin/test $MATRIX
+
+export OMP_NUM_THREADS=6
+export REPEAT_COUNT=100
+export SPMV_SCHEDULE=row
+export REORDER=rcm
+
+./bin/test $MATRIX --csv spmv_rcm.csv --json spmv_rcm.json
 
 export OMP_NUM_THREADS=6
+export REPEAT_COUNT=10
+export REORDER=none
+export SOLVER=pcg
+export PRECONDITIONER=dic
+export SOLVER_LAPLACIAN=true
+
+./bin/test $MATRIX --formats csr
+
+export SOLVER_REFINEMENT=true
+
+./bin/test $MATRIX --formats csr
+
+unset SOLVER_REFINEMENT
+export SOLVER=gamg
+
+./bin/test $MATRIX --formats csr
+
+export OMP_NUM_THREADS=48
+export OMP_PLACES=cores
+export OMP_PROC_BIND=close
+export REPEAT_COUNT=100
+unset SOLVER
+
+./bin/test $MATRIX --formats csr --csv spmv_numa.csv
+
+export OMP_NUM_THREADS=12
 export REPEAT_COUNT=100
 
-./bin/test
\ No newline at end of file
+mpirun -np 4 ./bin/test $MATRIX --csv spmv_distributed.csv
@@ -0,0 +1,458 @@
+#include "amg.hpp"
+#include "spgemm.hpp"
+#include "parallel.hpp"
+#include "benchmark.hpp"
+
+AMGControl amg_control_from_env(){
+    AMGControl control;
+    control.coarsest_size_ = env_get_int64("AMG_COARSEST_SIZE", 10);
+    control.max_levels_ = std::max(1, env_get_int("AMG_MAX_LEVELS", 50));
+    control.pre_sweeps_ = env_get_int("AMG_PRE_SWEEPS", 2);
+    control.post_sweeps_ = env_get_int("AMG_POST_SWEEPS", 2);
+    control.omega_ = env_get_double("AMG_JACOBI_OMEGA", 2. / 3.);
+    control.scale_correction_ = env_get_bool("AMG_SCALE_CORRECTION", true);
+    control.coarsest_rel_tol_ = env_get_double("AMG_COARSEST_REL_TOL", 1e-2);
+    control.spgemm_galerkin_ = env_get_bool("AMG_SPGEMM_GALERKIN", false);
+    return control;
+}
+
+template <typename IndexType, typename ValueType>
+AMG<IndexType, ValueType>::AMG(CSR<IndexType, ValueType>& A, const AMGControl& control)
+    :A_(A), control_(control), coarsest_preconditioner_(NULL), coarsest_symmetric_(true), setup_time_(0.){
+    if(A.row_ != A.col_){
+        cerr << "In AMG<IndexType, ValueType>::AMG(CSR<IndexType, ValueType>& A, const AMGControl& control), matrix have to be square !!!" << endl;
+        throw std::invalid_argument("matrix is not square");
+    }
+    omp_timer timer;
+    // no reallocation : the levels hold CSR, whose copy is not wanted
+    levels_.reserve(control_.max_levels_);
+    levels_.emplace_back();
+    for(;;){
+        const int level = levels_.size() - 1;
+        const CSR<IndexType, ValueType>& Al = matrix(level);
+        const IndexType n = Al.row_;
+        AMGLevel<IndexType, ValueType>& L = levels_[level];
+
+        L.rdiag_.resize(n);
+        IndexType missing = 0;
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(+:missing)
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            const IndexType* begin = Al.colidx_.data() + Al.rowptr_[i];
+            const IndexType* end = Al.colidx_.data() + Al.rowptr_[i+1];
+            const IndexType* pos = std::lower_bound(begin, end, i);
+            if(pos == end || *pos != i || Al.value_[pos - Al.colidx_.data()] == 0.){
+                missing += 1;
+                continue;
+            }
+            L.rdiag_[i] = 1. / Al.value_[pos - Al.colidx_.data()];
+        }
+        if(missing > 0){
+            cerr << "In AMG<IndexType, ValueType>::AMG(CSR<IndexType, ValueType>& A, const AMGControl& control), "
+                 << missing << " rows of level " << level << " have no (nonzero) diagonal !!!" << endl;
+            throw std::invalid_argument("missing diagonal");
+        }
+        L.r_.resize(n);
+        L.t_.resize(n);
+        L.w_.resize(n);
+        if(level > 0){
+            L.x_.resize(n);
+            L.b_.resize(n);
+        }
+
+        if(n <= control_.coarsest_size_ || static_cast<int>(levels_.size()) >= control_.max_levels_){
+            break;
+        }
+        // no pair left, e.g. a diagonal matrix
+        if(aggregate(level) == n){
+            L.aggregate_.clear();
+            L.member_ptr_.clear();
+            L.member_.clear();
+            break;
+        }
+        levels_.emplace_back();
+        galerkin(level);
+    }
+
+    // coarsest level : PCG + DIC when symmetric, else PBiCGStab + DILU
+    CSR<IndexType, ValueType>& Ac = matrix(level_count() - 1);
+    for(IndexType i = 0; i < Ac.row_ && coarsest_symmetric_; ++i){
+        for(IndexType idx = Ac.rowptr_[i]; idx < Ac.rowptr_[i+1]; ++idx){
+            const IndexType j = Ac.colidx_[idx];
+            const IndexType* begin = Ac.colidx_.data() + Ac.rowptr_[j];
+            const IndexType* end = Ac.colidx_.data() + Ac.rowptr_[j+1];
+            const IndexType* pos = std::lower_bound(begin, end, i);
+            if(pos == end || *pos != i
+                || std::abs(Ac.value_[pos - Ac.colidx_.data()] - Ac.value_[idx]) > 1e-6 * std::abs(Ac.value_[idx])){
+                coarsest_symmetric_ = false;
+                break;
+            }
+        }
+    }
+    coarsest_preconditioner_ = new Preconditioner<IndexType, ValueType>(Ac,
+        coarsest_symmetric_ ? PRECONDITIONER_DIC : PRECONDITIONER_DILU, TRIANGULAR_SCHEDULE_SERIAL);
+    setup_time_ = timer.elapsedTime();
+}
+
+// serial in row order like the OpenFOAM pairGAMGAgglomeration
+template <typename IndexType, typename ValueType>
+IndexType AMG<IndexType, ValueType>::aggregate(int level){
+    const CSR<IndexType, ValueType>& A = matrix(level);
+    AMGLevel<IndexType, ValueType>& L = levels_[level];
+    const IndexType n = A.row_;
+    vector<IndexType>& aggregate = L.aggregate_;
+    aggregate.assign(n, -1);
+
+    IndexType coarse = 0;
+    for(IndexType i = 0; i < n; ++i){
+        if(aggregate[i] >= 0){
+            continue;
+        }
+        IndexType pair = -1;
+        IndexType strongest = -1;
+        ValueType pair_weight = 0.;
+        ValueType strongest_weight = 0.;
+        for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+            const IndexType j = A.colidx_[idx];
+            if(j == i){
+                continue;
+            }
+            const ValueType weight = std::abs(A.value_[idx]);
+            if(aggregate[j] < 0 && (pair < 0 || weight > pair_weight)){
+                pair = j;
+                pair_weight = weight;
+            }
+            if(strongest < 0 || weight > strongest_weight){
+                strongest = j;
+                strongest_weight = weight;
+            }
+        }
+        if(pair >= 0){
+            aggregate[i] = coarse;
+            aggregate[pair] = coarse;
+            coarse += 1;
+        }else if(strongest >= 0){
+            // every neighbour is taken
+            aggregate[i] = aggregate[strongest];
+        }else{
+            aggregate[i] = coarse;
+            coarse += 1;
+        }
+    }
+
+    L.member_ptr_.assign(coarse + 1, 0);
+    L.member_.resize(n);
+    for(IndexType i = 0; i < n; ++i){
+        L.member_ptr_[aggregate[i]] += 1;
+    }
+    parallel_exclusive_scan(L.member_ptr_.data(), static_cast<int64_t>(coarse) + 1);
+    vector<IndexType> cursor(L.member_ptr_.begin(), L.member_ptr_.end() - 1);
+    for(IndexType i = 0; i < n; ++i){
+        L.member_[cursor[aggregate[i]]++] = i;
+    }
+    return coarse;
+}
+
+// row I of R A P gathers the rows of aggregate I with their columns mapped
+// through aggregate : count pass, scan, fill pass with sorted columns
+template <typename IndexType, typename ValueType>
+void AMG<IndexType, ValueType>::galerkin(int level){
+    const CSR<IndexType, ValueType>& A = matrix(level);
+    const AMGLevel<IndexType, ValueType>& L = levels_[level];
+    const IndexType nc = L.member_ptr_.size() - 1;
+    const IndexType* aggregate = L.aggregate_.data();
+
+    if(control_.spgemm_galerkin_){
+        // R : rows are the aggregate member lists, P : one entry per row
+        const IndexType n = A.row_;
+        vector<IndexType> P_rowptr(n + 1);
+        for(IndexType i = 0; i <= n; ++i){
+            P_rowptr[i] = i;
+        }
+        CSR<IndexType, ValueType> R(nc, n, L.member_ptr_, L.member_, vector<ValueType>(n, 1.));
+        CSR<IndexType, ValueType> P(n, nc, std::move(P_rowptr), L.aggregate_, vector<ValueType>(n, 1.));
+        CSR<IndexType, ValueType> AP = spgemm(A, P);
+        levels_[level + 1].A_ = spgemm(R, AP);
+        return;
+    }
+
+    vector<IndexType> rowptr(nc + 1, 0);
+    #pragma omp parallel
+    {
+        vector<IndexType> stamp(nc, -1);
+        #pragma omp for schedule(dynamic, 64)
+        for(IndexType I = 0; I < nc; ++I){
+            IndexType count = 0;
+            for(IndexType k = L.member_ptr_[I]; k < L.member_ptr_[I+1]; ++k){
+                const IndexType i = L.member_[k];
+                for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+                    const IndexType J = aggregate[A.colidx_[idx]];
+                    if(stamp[J] != I){
+                        stamp[J] = I;
+                        count += 1;
+                    }
+                }
+            }
+            rowptr[I] = count;
+        }
+    }
+    parallel_exclusive_scan(rowptr.data(), static_cast<int64_t>(nc) + 1);
+
+    vector<IndexType> colidx(rowptr[nc]);
+    vector<ValueType> value(rowptr[nc]);
+    #pragma omp parallel
+    {
+        vector<IndexType> stamp(nc, -1);
+        vector<IndexType> slot(nc);
+        #pragma omp for schedule(dynamic, 64)
+        for(IndexType I = 0; I < nc; ++I){
+            IndexType pos = rowptr[I];
+            for(IndexType k = L.member_ptr_[I]; k < L.member_ptr_[I+1]; ++k){
+                const IndexType i = L.member_[k];
+                for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+                    const IndexType J = aggregate[A.colidx_[idx]];
+                    if(stamp[J] != I){
+                        stamp[J] = I;
+                        colidx[pos++] = J;
+                    }
+                }
+            }
+            std::sort(colidx.begin() + rowptr[I], colidx.begin() + rowptr[I+1]);
+            for(IndexType p = rowptr[I]; p < rowptr[I+1]; ++p){
+                slot[colidx[p]] = p;
+                value[p] = 0.;
+            }
+            for(IndexType k = L.member_ptr_[I]; k < L.member_ptr_[I+1]; ++k){
+                const IndexType i = L.member_[k];
+                for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+                    value[slot[aggregate[A.colidx_[idx]]]] += A.value_[idx];
+                }
+            }
+        }
+    }
+    // copied in parallel into the first touch arrays of the CSR (numa_vector
+    // has its own allocator, the std::vector buffers can not be adopted)
+    levels_[level + 1].A_ = CSR<IndexType, ValueType>(nc, nc, rowptr, colidx, value);
+}
+
+template <typename IndexType, typename ValueType>
+void AMG<IndexType, ValueType>::smooth(int level, vector<ValueType>& x, const vector<ValueType>& b, int sweeps, bool zero_initial){
+    CSR<IndexType, ValueType>& A = matrix(level);
+    AMGLevel<IndexType, ValueType>& L = levels_[level];
+    const IndexType n = A.row_;
+    const ValueType omega = control_.omega_;
+    const double t = omp_get_wtime();
+    if(zero_initial){
+        // first sweep from x = 0 needs no SpMV
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            x[i] = (sweeps > 0) ? omega * L.rdiag_[i] * b[i] : 0.;
+        }
+    }
+    for(int sweep = zero_initial ? 1 : 0; sweep < sweeps; ++sweep){
+        A.SpMV(L.t_, x);
+        L.spmv_count_ += 1;
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            x[i] += omega * L.rdiag_[i] * (b[i] - L.t_[i]);
+        }
+    }
+    L.time_smooth_ += omp_get_wtime() - t;
+}
+
+template <typename IndexType, typename ValueType>
+void AMG<IndexType, ValueType>::vcycle(int level, vector<ValueType>& x, const vector<ValueType>& b){
+    CSR<IndexType, ValueType>& A = matrix(level);
+    AMGLevel<IndexType, ValueType>& L = levels_[level];
+    const IndexType n = A.row_;
+    double t;
+
+    if(level == level_count() - 1){
+        t = omp_get_wtime();
+        if(level > 0){
+            x.assign(n, 0.);
+        }
+        const SolverControl control = {1e-20, control_.coarsest_rel_tol_, static_cast<int>(std::max<IndexType>(n, 1))};
+        SolverPerformance perf = coarsest_symmetric_ ? pcg_solve(A, *coarsest_preconditioner_, x, b, control)
+            : pbicgstab_solve(A, *coarsest_preconditioner_, x, b, control);
+        L.spmv_count_ += perf.spmv_count_;
+        L.time_coarsest_ += omp_get_wtime() - t;
+        return;
+    }
+
+    smooth(level, x, b, control_.pre_sweeps_, level > 0);
+
+    // r = b - A x
+    t = omp_get_wtime();
+    A.SpMV(L.r_, x);
+    L.spmv_count_ += 1;
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        L.r_[i] = b[i] - L.r_[i];
+    }
+    L.time_residual_ += omp_get_wtime() - t;
+
+    // b_c = R r
+    AMGLevel<IndexType, ValueType>& C = levels_[level + 1];
+    const IndexType nc = L.member_ptr_.size() - 1;
+    t = omp_get_wtime();
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType I = 0; I < nc; ++I){
+        ValueType sum = 0.;
+        for(IndexType k = L.member_ptr_[I]; k < L.member_ptr_[I+1]; ++k){
+            sum += L.r_[L.member_[k]];
+        }
+        C.b_[I] = sum;
+    }
+    L.time_restrict_ += omp_get_wtime() - t;
+
+    vcycle(level + 1, C.x_, C.b_);
+
+    // e = P x_c, x += alpha e
+    t = omp_get_wtime();
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        L.t_[i] = C.x_[L.aggregate_[i]];
+    }
+    double alpha = 1.;
+    if(control_.scale_correction_){
+        A.SpMV(L.w_, L.t_);
+        L.spmv_count_ += 1;
+        double er = 0.;
+        double eAe = 0.;
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(+:er, eAe)
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            er += static_cast<double>(L.t_[i]) * L.r_[i];
+            eAe += static_cast<double>(L.t_[i]) * L.w_[i];
+        }
+        if(eAe > 0.){
+            alpha = er / eAe;
+        }
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        x[i] += alpha * L.t_[i];
+    }
+    L.time_prolong_ += omp_get_wtime() - t;
+
+    smooth(level, x, b, control_.post_sweeps_, false);
+}
+
+template <typename IndexType, typename ValueType>
+SolverPerformance AMG<IndexType, ValueType>::solve(vector<ValueType>& x, const vector<ValueType>& b, const SolverControl& control){
+    const IndexType n = A_.row_;
+    AMGLevel<IndexType, ValueType>& L = levels_[0];
+    SolverPerformance perf = {"gamg", "v-cycle, jacobi smoother", 0, 0., 0., false, 0, 0, 0., 0., 0., 0.};
+    const double start = omp_get_wtime();
+    double t;
+
+    t = omp_get_wtime();
+    A_.SpMV(L.t_, x);
+    perf.time_spmv_ += omp_get_wtime() - t;
+    perf.spmv_count_ += 1;
+
+    t = omp_get_wtime();
+    double norm_factor;
+    perf.initial_residual_ = solver_initial_residual(A_, x, L.t_, b, L.r_, norm_factor) / norm_factor;
+    perf.final_residual_ = perf.initial_residual_;
+    perf.time_reduction_ += omp_get_wtime() - t;
+
+    while(perf.iterations_ < control.max_iter_ && !solver_converged(control, perf.initial_residual_, perf.final_residual_)){
+        t = omp_get_wtime();
+        vcycle(0, x, b);
+        perf.time_precondition_ += omp_get_wtime() - t;
+        perf.precondition_count_ += 1;
+
+        t = omp_get_wtime();
+        A_.SpMV(L.t_, x);
+        perf.time_spmv_ += omp_get_wtime() - t;
+        perf.spmv_count_ += 1;
+
+        t = omp_get_wtime();
+        double residual = 0.;
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(+:residual)
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            residual += std::abs(static_cast<double>(b[i]) - L.t_[i]);
+        }
+        perf.final_residual_ = residual / norm_factor;
+        perf.time_reduction_ += omp_get_wtime() - t;
+        perf.iterations_ += 1;
+    }
+    perf.converged_ = solver_converged(control, perf.initial_residual_, perf.final_residual_);
+    perf.time_total_ = omp_get_wtime() - start;
+    return perf;
+}
+
+template <typename IndexType, typename ValueType>
+void AMG<IndexType, ValueType>::print_info() const {
+    double rows = 0.;
+    double nnz = 0.;
+    cout << "AMG hierarchy --------------" << endl;
+    cout << precision_info<IndexType, ValueType>() << endl;
+    cout << "levels : " << level_count() << ", setup time : " << setup_time_ << endl;
+    for(int l = 0; l < level_count(); ++l){
+        const CSR<IndexType, ValueType>& A = matrix(l);
+        cout << "level " << l << " : row " << A.row_ << ", nnz " << A.nnz_
+             << ", nnz / row " << static_cast<double>(A.nnz_) / A.row_;
+        if(l > 0){
+            cout << ", coarsening ratio " << static_cast<double>(matrix(l - 1).row_) / A.row_;
+        }
+        cout << endl;
+        rows += A.row_;
+        nnz += A.nnz_;
+    }
+    cout << "grid complexity : " << rows / A_.row_ << ", operator complexity : " << nnz / A_.nnz_ << endl;
+    cout << "coarsest solver : " << (coarsest_symmetric_ ? "pcg + dic" : "pbicgstab + dilu")
+         << ", rel tol : " << control_.coarsest_rel_tol_ << endl;
+    cout << "pre / post sweeps : " << control_.pre_sweeps_ << " / " << control_.post_sweeps_ << ", omega : " << control_.omega_
+         << ", scale correction : " << control_.scale_correction_ << endl;
+    cout << "galerkin : " << (control_.spgemm_galerkin_ ? "spgemm" : "aggregate sums") << endl;
+    cout << "----------------------------" << endl;
+}
+
+template <typename IndexType, typename ValueType>
+void AMG<IndexType, ValueType>::print_profile() const {
+    double total = 0.;
+    for(int l = 0; l < level_count(); ++l){
+        const AMGLevel<IndexType, ValueType>& L = levels_[l];
+        total += L.time_smooth_ + L.time_residual_ + L.time_restrict_ + L.time_prolong_ + L.time_coarsest_;
+    }
+    cout << "AMG profile ----------------" << endl;
+    cout << "thread count : " << omp_get_max_threads() << endl;
+    cout << "time in V-cycles : " << total << endl;
+    for(int l = 0; l < level_count(); ++l){
+        const AMGLevel<IndexType, ValueType>& L = levels_[l];
+        const double level_total = L.time_smooth_ + L.time_residual_ + L.time_restrict_ + L.time_prolong_ + L.time_coarsest_;
+        cout << "level " << l << " : " << level_total << " (" << 100. * level_total / total << "%)";
+        if(l == level_count() - 1){
+            cout << ", coarsest solve " << L.time_coarsest_;
+        }else{
+            cout << ", smooth " << L.time_smooth_ << ", residual " << L.time_residual_
+                 << ", restrict " << L.time_restrict_ << ", prolong " << L.time_prolong_;
+        }
+        cout << ", spmv count " << L.spmv_count_ << endl;
+    }
+    cout << "----------------------------" << endl;
+}
+
+template class AMG<int32_t, float>;
+template class AMG<int32_t, double>;
+template class AMG<int64_t, float>;
+template class AMG<int64_t, double>;
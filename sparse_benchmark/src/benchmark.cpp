@@ -0,0 +1,168 @@
+#include "benchmark.hpp"
+#include <fstream>
+#include <sstream>
+
+vector<BenchmarkResult>& benchmark_results(){
+    static vector<BenchmarkResult> results;
+    return results;
+}
+
+int benchmark_failure_count(){
+    int count = 0;
+    for(const BenchmarkResult& r : benchmark_results()){
+        if(r.residual_ >= 0. && r.residual_ > r.tolerance_){
+            ++count;
+        }
+    }
+    return count;
+}
+
+static vector<double>& benchmark_reference_storage(){
+    static vector<double> y_ref;
+    return y_ref;
+}
+
+void set_benchmark_reference(vector<double> y_ref){
+    benchmark_reference_storage().swap(y_ref);
+}
+
+const vector<double>& benchmark_reference(){
+    return benchmark_reference_storage();
+}
+
+double stream_triad_bandwidth(){
+    static double bandwidth = -1.;
+    if(bandwidth > 0.){
+        return bandwidth;
+    }
+    const int64_t n = env_get_int64("STREAM_SIZE", static_cast<int64_t>(1) << 25);
+    const int repeat_count = 10;
+    const double scalar = 3.;
+    // first touch with the same static schedule as the triad
+    double* a = new double[n];
+    double* b = new double[n];
+    double* c = new double[n];
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        a[i] = 0.;
+        b[i] = 1.;
+        c[i] = 2.;
+    }
+    double best = 1e30;
+    for(int repeat = 0; repeat < repeat_count; ++repeat){
+        double start = omp_get_wtime();
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for(int64_t i = 0; i < n; ++i){
+            a[i] = b[i] + scalar * c[i];
+        }
+        best = std::min(best, omp_get_wtime() - start);
+    }
+    // keep the triad from being optimized away
+    volatile double sink = a[n / 2];
+    (void)sink;
+    delete[] a;
+    delete[] b;
+    delete[] c;
+
+    bandwidth = 3. * sizeof(double) * n / best * 1e-9;
+    cout << "stream benchmark -----------" << endl;
+    cout << "thread count : " << omp_get_max_threads() << endl;
+    cout << "array size : " << n << " (" << 3. * sizeof(double) * n / (1024. * 1024.) << " MiB)" << endl;
+    cout << "triad GB/s : " << bandwidth << endl;
+    cout << "----------------------------" << endl;
+    return bandwidth;
+}
+
+static string benchmark_csv_field(const string& s){
+    string ret("\"");
+    for(char ch : s){
+        if(ch == '"'){
+            ret += "\"\"";
+        }else if(ch == '\n'){
+            ret += "; ";
+        }else{
+            ret += ch;
+        }
+    }
+    return ret + "\"";
+}
+
+static string benchmark_json_string(const string& s){
+    string ret("\"");
+    for(char ch : s){
+        switch(ch){
+            case '"' : ret += "\\\""; break;
+            case '\\' : ret += "\\\\"; break;
+            case '\n' : ret += "\\n"; break;
+            default : ret += ch;
+        }
+    }
+    return ret + "\"";
+}
+
+// derived columns, shared by the CSV and the JSON output
+static double benchmark_GFLOPS(const BenchmarkResult& r){
+    return r.FLOPs_ / r.time_median_ * 1e-9;
+}
+
+static double benchmark_GBs(const BenchmarkResult& r){
+    return r.bytes_ / r.time_median_ * 1e-9;
+}
+
+void write_benchmark_csv(const string& filename){
+    std::ofstream out(filename.c_str());
+    if(!out){
+        cerr << "In write_benchmark_csv(const string& filename), can not open " << filename << " !!!" << endl;
+        throw std::invalid_argument("can not open file");
+    }
+    const double stream = benchmark_results().empty() ? 0. : stream_triad_bandwidth();
+    out.precision(9);
+    out << "title,info,thread_count,repeat_count,FLOPs,bytes,time_no_warm_up,time_min,time_median,time_max,time_total,"
+           "GFLOPS,GBs,stream_GBs,stream_fraction,residual,tolerance,passed" << "\n";
+    for(const BenchmarkResult& r : benchmark_results()){
+        out << benchmark_csv_field(r.title_) << "," << benchmark_csv_field(r.info_) << ","
+            << r.thread_count_ << "," << r.repeat_count_ << "," << r.FLOPs_ << "," << r.bytes_ << ","
+            << r.time_no_warm_up_ << "," << r.time_min_ << "," << r.time_median_ << "," << r.time_max_ << "," << r.time_total_ << ","
+            << benchmark_GFLOPS(r) << "," << benchmark_GBs(r) << "," << stream << "," << benchmark_GBs(r) / stream << ","
+            << r.residual_ << "," << r.tolerance_ << "," << (r.residual_ < 0. ? "" : (r.residual_ <= r.tolerance_ ? "1" : "0")) << "\n";
+    }
+}
+
+void write_benchmark_json(const string& filename){
+    std::ofstream out(filename.c_str());
+    if(!out){
+        cerr << "In write_benchmark_json(const string& filename), can not open " << filename << " !!!" << endl;
+        throw std::invalid_argument("can not open file");
+    }
+    const double stream = benchmark_results().empty() ? 0. : stream_triad_bandwidth();
+    out.precision(9);
+    out << "{\n  \"stream_GBs\" : " << stream << ",\n  \"results\" : [";
+    const vector<BenchmarkResult>& results = benchmark_results();
+    for(size_t i = 0; i < results.size(); ++i){
+        const BenchmarkResult& r = results[i];
+        out << (i == 0 ? "\n" : ",\n") << "    {"
+            << "\"title\" : " << benchmark_json_string(r.title_)
+            << ", \"info\" : " << benchmark_json_string(r.info_)
+            << ", \"thread_count\" : " << r.thread_count_
+            << ", \"repeat_count\" : " << r.repeat_count_
+            << ", \"FLOPs\" : " << r.FLOPs_
+            << ", \"bytes\" : " << r.bytes_
+            << ", \"time_no_warm_up\" : " << r.time_no_warm_up_
+            << ", \"time_min\" : " << r.time_min_
+            << ", \"time_median\" : " << r.time_median_
+            << ", \"time_max\" : " << r.time_max_
+            << ", \"time_total\" : " << r.time_total_
+            << ", \"GFLOPS\" : " << benchmark_GFLOPS(r)
+            << ", \"GBs\" : " << benchmark_GBs(r)
+            << ", \"stream_fraction\" : " << benchmark_GBs(r) / stream
+            << ", \"residual\" : " << r.residual_
+            << ", \"tolerance\" : " << r.tolerance_
+            << ", \"passed\" : " << (r.residual_ < 0. ? "null" : (r.residual_ <= r.tolerance_ ? "true" : "false"))
+            << "}";
+    }
+    out << "\n  ]\n}\n";
+}
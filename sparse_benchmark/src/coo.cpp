@@ -1,21 +1,86 @@
 #include "coo.hpp"
+#include "parallel.hpp"
 
+#define COO_INSERTION_SORT_MAX 32
+
+// sort the entries [start, end) of one row by column
+template<typename IndexType, typename ValueType>
+static void sort_row_by_col(IndexType* colidx, ValueType* value, IndexType start, IndexType end){
+    if(end - start <= COO_INSERTION_SORT_MAX){
+        for(IndexType i = start + 1; i < end; ++i){
+            IndexType c = colidx[i];
+            ValueType v = value[i];
+            IndexType j = i;
+            while(j > start && colidx[j - 1] > c){
+                colidx[j] = colidx[j - 1];
+                value[j] = value[j - 1];
+                --j;
+            }
+            colidx[j] = c;
+            value[j] = v;
+        }
+        return;
+    }
+    // long rows are rare, sort a (col, value) copy
+    vector<std::pair<IndexType, ValueType>> entry(end - start);
+    for(IndexType i = start; i < end; ++i){
+        entry[i - start] = std::make_pair(colidx[i], value[i]);
+    }
+    std::stable_sort(entry.begin(), entry.end(),
+        [](const std::pair<IndexType, ValueType>& a, const std::pair<IndexType, ValueType>& b){
+            return a.first < b.first;
+        });
+    for(IndexType i = start; i < end; ++i){
+        colidx[i] = entry[i - start].first;
+        value[i] = entry[i - start].second;
+    }
+}
+
+// parallel counting sort by row, then column sort inside each row
+// rowidx_ is rewritten in place, colidx_ / value_ are scattered into one
+// scratch pair which is swapped in (no copy back, no tuple array)
 template<typename IndexType, typename ValueType>
 void COO<IndexType, ValueType>::sort(){
-    vector<tuple<IndexType,IndexType,ValueType>> rcv_vector(nnz_);
+    // count entries per row
+    vector<IndexType> row_cursor(row_ + 1, 0);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
     for(IndexType i = 0; i < nnz_; ++i){
-        rcv_vector[i] = make_tuple(rowidx_[i], colidx_[i], value_[i]);
+        #pragma omp atomic
+        row_cursor[rowidx_[i]] += 1;
     }
-    auto compare = [](const tuple<IndexType,IndexType,ValueType>& a, const tuple<IndexType,IndexType,ValueType>& b){
-        if(get<0>(a) == get<0>(b)) 
-            return get<1>(a) < get<1>(b);
-        return get<0>(a) < get<0>(b);
-    };
-    std::sort(rcv_vector.begin(), rcv_vector.end(), compare);
+
+    // row_cursor[r] = start of row r
+    parallel_exclusive_scan(row_cursor.data(), static_cast<int64_t>(row_) + 1);
+
+    // scatter, afterwards row_cursor[r] = end of row r
+    vector<IndexType> colidx(nnz_);
+    vector<ValueType> value(nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
     for(IndexType i = 0; i < nnz_; ++i){
-        rowidx_[i] = get<0>(rcv_vector[i]);
-        colidx_[i] = get<1>(rcv_vector[i]);
-        value_[i] = get<2>(rcv_vector[i]);
+        IndexType pos;
+        #pragma omp atomic capture
+        pos = row_cursor[rowidx_[i]]++;
+        colidx[pos] = colidx_[i];
+        value[pos] = value_[i];
+    }
+    colidx_.swap(colidx);
+    value_.swap(value);
+
+    // sort columns inside rows and rewrite rowidx
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 1024)
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        IndexType start = r == 0 ? 0 : row_cursor[r - 1];
+        IndexType end = row_cursor[r];
+        sort_row_by_col(colidx_.data(), value_.data(), start, end);
+        for(IndexType i = start; i < end; ++i){
+            rowidx_[i] = r;
+        }
     }
     sorted_ = true;
 }
@@ -33,16 +98,22 @@ void COO<IndexType, ValueType>::print_info(){
 
 template<typename IndexType, typename ValueType>
 bool COO<IndexType, ValueType>::check_sorted(){
+    IndexType unsorted = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:unsorted)
+#endif
     for(IndexType i = 1; i < nnz_; ++i){
         if(rowidx_[i-1] < rowidx_[i])
             continue;
-        if(colidx_[i-1] < colidx_[i])
+        if(rowidx_[i-1] == rowidx_[i] && colidx_[i-1] < colidx_[i])
             continue; 
-        sorted_ = false;
-        return sorted_;
+        unsorted += 1;
     }
-    sorted_ = true;
+    sorted_ = (unsorted == 0);
     return sorted_;
 }
 
+template class COO<int32_t, float>;
+template class COO<int32_t, double>;
+template class COO<int64_t, float>;
 template class COO<int64_t, double>;
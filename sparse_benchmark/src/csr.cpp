@@ -1,7 +1,7 @@
 #include "csr.hpp"
 
 template<typename IndexType, typename ValueType>
-CSR<IndexType, ValueType>::CSR(const COO<IndexType,ValueType>& coo){
+CSR<IndexType, ValueType>::CSR(const COO<IndexType,ValueType>& coo):merge_path_thread_count_(0){
     if(!coo.is_sorted()){
         cerr << "In CSR<IndexType, ValueType>::CSR(const COO<IndexType,ValueType>& coo), coo have to be sorted !!!" << endl;
         throw std::invalid_argument("coo is not sorted");
@@ -12,42 +12,142 @@ CSR<IndexType, ValueType>::CSR(const COO<IndexType,ValueType>& coo){
     nnz_ = coo.nnz_;
     sorted_ = true;
 
-    // row_count
-    // compute row_count
-    vector<IndexType> row_count(row_, 0);
+    // rowptr
+    // coo is sorted, so rowptr_[r] is the first entry with row >= r :
+    // every entry starting a new row fills rowptr_ for the rows it skips
+    rowptr_.resize(row_ + 1);
+    const IndexType* rowidx = coo.rowidx_.data();
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
     for(IndexType i = 0; i < nnz_; ++i){
-        row_count[coo.rowidx_[i]] += 1;
+        IndexType prev = (i == 0) ? -1 : rowidx[i - 1];
+        for(IndexType r = prev + 1; r <= rowidx[i]; ++r){
+            rowptr_[r] = i;
+        }
+    }
+    IndexType last = (nnz_ == 0) ? -1 : rowidx[nnz_ - 1];
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType r = last + 1; r <= row_; ++r){
+        rowptr_[r] = nnz_;
     }
 
-    // rowptr nnz
-    rowptr_.resize(row_ + 1);
-    rowptr_[0] = 0;
+    // fill colidx value, rows in the static schedule of SpMV (first touch)
+    colidx_.resize(nnz_);
+    value_.resize(nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for(IndexType r = 0; r < row_; ++r){
-        rowptr_[r + 1] = rowptr_[r] + row_count[r];
+        for(IndexType i = rowptr_[r]; i < rowptr_[r+1]; ++i){
+            colidx_[i] = coo.colidx_[i];
+            value_[i] = coo.value_[i];
+        }
     }
+}
 
-    std::vector<IndexType> cur_index(row_);
+template<typename IndexType, typename ValueType>
+CSR<IndexType, ValueType>::CSR(IndexType row, IndexType col, const vector<IndexType>& rowptr, const vector<IndexType>& colidx,
+    const vector<ValueType>& value):sorted_(true), merge_path_thread_count_(0), row_(row), col_(col), nnz_(rowptr.empty() ? 0 : rowptr.back()){
+    rowptr_.resize(row_ + 1);
+    colidx_.resize(nnz_);
+    value_.resize(nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r <= row_; ++r){
+        rowptr_[r] = rowptr[r];
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
     for(IndexType r = 0; r < row_; ++r){
-        cur_index[r] = rowptr_[r];
+        for(IndexType i = rowptr_[r]; i < rowptr_[r+1]; ++i){
+            colidx_[i] = colidx[i];
+            value_[i] = value[i];
+        }
+    }
+}
+
+template<typename IndexType, typename ValueType>
+template<typename OtherIndexType, typename OtherValueType>
+CSR<IndexType, ValueType>::CSR(const CSR<OtherIndexType,OtherValueType>& other):merge_path_thread_count_(0){
+    // merge path coordinates go up to row + nnz
+    if(static_cast<int64_t>(other.row_) + other.nnz_ > static_cast<int64_t>(std::numeric_limits<IndexType>::max())
+        || static_cast<int64_t>(other.col_) > static_cast<int64_t>(std::numeric_limits<IndexType>::max())){
+        cerr << "In CSR<IndexType, ValueType>::CSR(const CSR<OtherIndexType,OtherValueType>& other), row + nnz overflow IndexType !!!" << endl;
+        throw std::overflow_error("IndexType overflow");
     }
 
-    // fill colidx value
+    row_ = other.row_;
+    col_ = other.col_;
+    nnz_ = other.nnz_;
+    sorted_ = true;
+
+    rowptr_.resize(row_ + 1);
     colidx_.resize(nnz_);
     value_.resize(nnz_);
-
-    for(IndexType i = 0; i < nnz_; ++i){
-        IndexType r = coo.rowidx_[i];
-        IndexType csr_index = cur_index[r];
-        colidx_[csr_index] = coo.colidx_[i];
-        value_[csr_index] = coo.value_[i];
-        cur_index[r] += 1;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r <= row_; ++r){
+        rowptr_[r] = static_cast<IndexType>(other.rowptr_[r]);
     }
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        for(IndexType i = rowptr_[r]; i < rowptr_[r+1]; ++i){
+            colidx_[i] = static_cast<IndexType>(other.colidx_[i]);
+            value_[i] = static_cast<ValueType>(other.value_[i]);
+        }
+    }
+}
+
+template<typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::swap(CSR& other){
+    std::swap(sorted_, other.sorted_);
+    std::swap(merge_path_thread_count_, other.merge_path_thread_count_);
+    merge_path_row_.swap(other.merge_path_row_);
+    merge_path_nnz_.swap(other.merge_path_nnz_);
+    carry_row_.swap(other.carry_row_);
+    carry_value_.swap(other.carry_value_);
+    std::swap(row_, other.row_);
+    std::swap(col_, other.col_);
+    std::swap(nnz_, other.nnz_);
+    rowptr_.swap(other.rowptr_);
+    colidx_.swap(other.colidx_);
+    value_.swap(other.value_);
+}
 
-    // check
+template<typename IndexType, typename ValueType>
+bool CSR<IndexType, ValueType>::check_sorted(){
+    IndexType unsorted = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:unsorted)
+#endif
     for(IndexType r = 0; r < row_; ++r){
-        assert(cur_index[r] == rowptr_[r+1]);
+        for(IndexType i = rowptr_[r] + 1; i < rowptr_[r+1]; ++i){
+            if(colidx_[i-1] >= colidx_[i])
+                unsorted += 1;
+        }
     }
+    sorted_ = (unsorted == 0);
+    return sorted_;
 }
 
-template class CSR<int64_t, double>;
+template<typename IndexType, typename ValueType>
+double CSR<IndexType, ValueType>::matrix_bytes() const {
+    return static_cast<double>(nnz_) * (sizeof(IndexType) + sizeof(ValueType)) + (row_ + 1.) * sizeof(IndexType);
+}
 
+template CSR<int32_t, float>::CSR(const CSR<int64_t, double>& other);
+template CSR<int32_t, double>::CSR(const CSR<int64_t, double>& other);
+template CSR<int64_t, float>::CSR(const CSR<int64_t, double>& other);
+
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
+template class CSR<int64_t, double>;
@@ -0,0 +1,277 @@
+#include "csr_compressed.hpp"
+#include "benchmark.hpp"
+#include <cstring>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+template <typename OffsetType, typename IndexType, typename ValueType>
+static void compressed_pack(CSRCompressed<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& csr){
+    OffsetType* offset = reinterpret_cast<OffsetType*>(A.packed_.data());
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r < A.row_; ++r){
+        for(IndexType idx = A.rowptr_[r]; idx < A.rowptr_[r+1]; ++idx){
+            offset[idx] = static_cast<OffsetType>(csr.colidx_[idx] - A.base_[r]);
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+CSRCompressed<IndexType, ValueType>::CSRCompressed(const CSR<IndexType, ValueType>& A)
+    :row_(A.row_), col_(A.col_), nnz_(A.nnz_), width_(0){
+    rowptr_.resize(row_ + 1);
+    base_.resize(row_);
+    value_.resize(nnz_);
+    IndexType max_span = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(max:max_span)
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        rowptr_[r] = A.rowptr_[r];
+        IndexType min_col = A.col_;
+        IndexType max_col = 0;
+        for(IndexType idx = A.rowptr_[r]; idx < A.rowptr_[r+1]; ++idx){
+            min_col = std::min(min_col, A.colidx_[idx]);
+            max_col = std::max(max_col, A.colidx_[idx]);
+            value_[idx] = A.value_[idx];
+        }
+        base_[r] = (A.rowptr_[r+1] > A.rowptr_[r]) ? min_col : 0;
+        max_span = std::max(max_span, max_col - base_[r]);
+    }
+    rowptr_[row_] = A.rowptr_[row_];
+
+    if(static_cast<uint64_t>(max_span) > std::numeric_limits<uint32_t>::max()){
+        cerr << "In CSRCompressed<IndexType, ValueType>::CSRCompressed(const CSR<IndexType, ValueType>& A), row span "
+             << max_span << " does not fit in 32 bits !!!" << endl;
+        throw std::invalid_argument("row span too wide");
+    }
+    width_ = (max_span <= std::numeric_limits<uint8_t>::max()) ? 1
+        : (max_span <= std::numeric_limits<uint16_t>::max()) ? 2 : 4;
+    packed_.resize(static_cast<size_t>(nnz_) * width_ + CSR_COMPRESSED_PAD);
+    std::fill(packed_.end() - CSR_COMPRESSED_PAD, packed_.end(), 0);
+    switch(width_){
+        case 1 : compressed_pack<uint8_t>(*this, A); break;
+        case 2 : compressed_pack<uint16_t>(*this, A); break;
+        default : compressed_pack<uint32_t>(*this, A); break;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+double CSRCompressed<IndexType, ValueType>::index_bytes() const {
+    return static_cast<double>(row_) * sizeof(IndexType) + static_cast<double>(nnz_) * width_;
+}
+
+template <typename IndexType, typename ValueType>
+double CSRCompressed<IndexType, ValueType>::matrix_bytes() const {
+    return (static_cast<double>(row_) + 1.) * sizeof(IndexType) + index_bytes() + static_cast<double>(nnz_) * sizeof(ValueType);
+}
+
+// portable kernel, the decode is left to the compiler
+template <typename OffsetType, typename IndexType, typename ValueType>
+static void compressed_spmv_simd(const CSRCompressed<IndexType, ValueType>& A, ValueType* y, const ValueType* x){
+    const OffsetType* offset = reinterpret_cast<const OffsetType*>(A.packed_.data());
+    const ValueType* value = A.value_.data();
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r < A.row_; ++r){
+        const ValueType* xr = x + A.base_[r];
+        ValueType sum = 0.;
+        for(IndexType idx = A.rowptr_[r]; idx < A.rowptr_[r+1]; ++idx){
+            sum += value[idx] * xr[offset[idx]];
+        }
+        y[r] = sum;
+    }
+}
+
+#if defined(__AVX512F__)
+// 8 offsets widened to the gather index width
+static inline __m512i compressed_load_epi64(const uint8_t* p){
+    return _mm512_cvtepu8_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m512i compressed_load_epi64(const uint16_t* p){
+    return _mm512_cvtepu16_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m512i compressed_load_epi64(const uint32_t* p){
+    return _mm512_cvtepu32_epi64(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)));
+}
+static inline __m256i compressed_load_epi32(const uint8_t* p){
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m256i compressed_load_epi32(const uint16_t* p){
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m256i compressed_load_epi32(const uint32_t* p){
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+}
+
+template <typename OffsetType>
+static void compressed_spmv_simd(const CSRCompressed<int64_t, double>& A, double* y, const double* x){
+    const OffsetType* offset = reinterpret_cast<const OffsetType*>(A.packed_.data());
+    const double* value = A.value_.data();
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int64_t r = 0; r < A.row_; ++r){
+        const __m512i base = _mm512_set1_epi64(A.base_[r]);
+        const int64_t end = A.rowptr_[r+1];
+        __m512d sum = _mm512_setzero_pd();
+        for(int64_t idx = A.rowptr_[r]; idx < end; idx += 8){
+            const __mmask8 mask = (end - idx >= 8) ? 0xFF : static_cast<__mmask8>((1u << (end - idx)) - 1);
+            __m512i vidx = _mm512_add_epi64(base, compressed_load_epi64(offset + idx));
+            __m512d vx = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), mask, vidx, x, 8);
+            sum = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, value + idx), vx, sum);
+        }
+        y[r] = _mm512_reduce_add_pd(sum);
+    }
+}
+
+template <typename OffsetType>
+static void compressed_spmv_simd(const CSRCompressed<int32_t, double>& A, double* y, const double* x){
+    const OffsetType* offset = reinterpret_cast<const OffsetType*>(A.packed_.data());
+    const double* value = A.value_.data();
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int32_t r = 0; r < A.row_; ++r){
+        const __m256i base = _mm256_set1_epi32(A.base_[r]);
+        const int32_t end = A.rowptr_[r+1];
+        __m512d sum = _mm512_setzero_pd();
+        for(int32_t idx = A.rowptr_[r]; idx < end; idx += 8){
+            const __mmask8 mask = (end - idx >= 8) ? 0xFF : static_cast<__mmask8>((1u << (end - idx)) - 1);
+            __m256i vidx = _mm256_add_epi32(base, compressed_load_epi32(offset + idx));
+            __m512d vx = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), mask, vidx, x, 8);
+            sum = _mm512_fmadd_pd(_mm512_maskz_loadu_pd(mask, value + idx), vx, sum);
+        }
+        y[r] = _mm512_reduce_add_pd(sum);
+    }
+}
+#elif defined(__AVX2__) && defined(__FMA__)
+// 4 offsets widened to the gather index width
+static inline __m256i compressed_load_epi64(const uint8_t* p){
+    int32_t packed;
+    std::memcpy(&packed, p, sizeof(packed));
+    return _mm256_cvtepu8_epi64(_mm_cvtsi32_si128(packed));
+}
+static inline __m256i compressed_load_epi64(const uint16_t* p){
+    return _mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m256i compressed_load_epi64(const uint32_t* p){
+    return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m128i compressed_load_epi32(const uint8_t* p){
+    int32_t packed;
+    std::memcpy(&packed, p, sizeof(packed));
+    return _mm_cvtepu8_epi32(_mm_cvtsi32_si128(packed));
+}
+static inline __m128i compressed_load_epi32(const uint16_t* p){
+    return _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(p)));
+}
+static inline __m128i compressed_load_epi32(const uint32_t* p){
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+}
+
+static inline double compressed_reduce_add(__m256d sum){
+    __m128d s = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(s, _mm_unpackhi_pd(s, s)));
+}
+
+template <typename OffsetType>
+static void compressed_spmv_simd(const CSRCompressed<int64_t, double>& A, double* y, const double* x){
+    const OffsetType* offset = reinterpret_cast<const OffsetType*>(A.packed_.data());
+    const double* value = A.value_.data();
+    const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int64_t r = 0; r < A.row_; ++r){
+        const __m256i base = _mm256_set1_epi64x(A.base_[r]);
+        const int64_t end = A.rowptr_[r+1];
+        __m256d sum = _mm256_setzero_pd();
+        for(int64_t idx = A.rowptr_[r]; idx < end; idx += 4){
+            const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(end - idx), lane);
+            __m256i vidx = _mm256_add_epi64(base, compressed_load_epi64(offset + idx));
+            __m256d vx = _mm256_mask_i64gather_pd(_mm256_setzero_pd(), x, vidx, _mm256_castsi256_pd(mask), 8);
+            sum = _mm256_fmadd_pd(_mm256_maskload_pd(value + idx, mask), vx, sum);
+        }
+        y[r] = compressed_reduce_add(sum);
+    }
+}
+
+template <typename OffsetType>
+static void compressed_spmv_simd(const CSRCompressed<int32_t, double>& A, double* y, const double* x){
+    const OffsetType* offset = reinterpret_cast<const OffsetType*>(A.packed_.data());
+    const double* value = A.value_.data();
+    const __m256i lane = _mm256_setr_epi64x(0, 1, 2, 3);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int32_t r = 0; r < A.row_; ++r){
+        const __m128i base = _mm_set1_epi32(A.base_[r]);
+        const int32_t end = A.rowptr_[r+1];
+        __m256d sum = _mm256_setzero_pd();
+        for(int32_t idx = A.rowptr_[r]; idx < end; idx += 4){
+            const __m256i mask = _mm256_cmpgt_epi64(_mm256_set1_epi64x(end - idx), lane);
+            __m128i vidx = _mm_add_epi32(base, compressed_load_epi32(offset + idx));
+            __m256d vx = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), x, vidx, _mm256_castsi256_pd(mask), 8);
+            sum = _mm256_fmadd_pd(_mm256_maskload_pd(value + idx, mask), vx, sum);
+        }
+        y[r] = compressed_reduce_add(sum);
+    }
+}
+#endif
+
+template <typename IndexType, typename ValueType>
+void CSRCompressed<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueType>& x) const {
+    switch(width_){
+        case 1 : compressed_spmv_simd<uint8_t>(*this, y.data(), x.data()); break;
+        case 2 : compressed_spmv_simd<uint16_t>(*this, y.data(), x.data()); break;
+        default : compressed_spmv_simd<uint32_t>(*this, y.data(), x.data()); break;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSRCompressed<IndexType, ValueType>::print_info() const {
+    cout << "CSRCompressed" << endl;
+    cout << "row : " << row_ << ", col : " << col_ << ", nnz : " << nnz_ << endl;
+    cout << "offset width : " << 8 * width_ << " bits" << endl;
+}
+
+template <typename IndexType, typename ValueType>
+void compressed_benchmark(CSR<IndexType, ValueType>& csr){
+    CSRCompressed<IndexType, ValueType> compressed(csr);
+    compressed.print_info();
+
+    const string info = precision_info<IndexType, ValueType>();
+    const double vector_bytes = (static_cast<double>(csr.row_) + csr.col_) * sizeof(ValueType);
+    vector<ValueType> x = benchmark_vector<ValueType>(csr.col_);
+    vector<ValueType> y(csr.row_, 0.);
+    spmv_benchmark_run("spmv csr", info, 2. * csr.nnz_, csr.matrix_bytes() + vector_bytes, [&](){ csr.SpMV(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+    const double time_csr = benchmark_results().back().time_median_;
+    spmv_benchmark_run("spmv compressed csr", info + ", offset : " + std::to_string(8 * compressed.width_) + " bits",
+        2. * compressed.nnz_, compressed.matrix_bytes() + vector_bytes, [&](){ compressed.SpMV(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+    const double time_compressed = benchmark_results().back().time_median_;
+
+    const double index_bytes = static_cast<double>(csr.nnz_) * sizeof(IndexType);
+    cout << "compressed csr benchmark ---" << endl;
+    cout << "column index bytes : " << index_bytes << " -> " << compressed.index_bytes()
+         << ", ratio : " << index_bytes / compressed.index_bytes() << endl;
+    cout << "matrix bytes : " << csr.matrix_bytes() << " -> " << compressed.matrix_bytes()
+         << ", ratio : " << csr.matrix_bytes() / compressed.matrix_bytes() << endl;
+    cout << "time (median) : " << time_csr << " -> " << time_compressed << ", speedup : " << time_csr / time_compressed << endl;
+    cout << "----------------------------" << endl;
+}
+
+template class CSRCompressed<int32_t, float>;
+template class CSRCompressed<int32_t, double>;
+template class CSRCompressed<int64_t, float>;
+template class CSRCompressed<int64_t, double>;
+
+template void compressed_benchmark(CSR<int32_t, float>& csr);
+template void compressed_benchmark(CSR<int32_t, double>& csr);
+template void compressed_benchmark(CSR<int64_t, float>& csr);
+template void compressed_benchmark(CSR<int64_t, double>& csr);
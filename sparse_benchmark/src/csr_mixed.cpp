@@ -0,0 +1,166 @@
+#include "csr_mixed.hpp"
+#include "benchmark.hpp"
+
+template <typename IndexType, typename ValueType>
+CSRMixed<IndexType, ValueType>::CSRMixed(const CSR<IndexType, double>& A, bool delta16)
+    :row_(A.row_), col_(A.col_), nnz_(A.nnz_), delta16_(false){
+    rowptr_.resize(row_ + 1);
+    value_.resize(nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r <= row_; ++r){
+        rowptr_[r] = A.rowptr_[r];
+    }
+
+    // columns sorted inside each row, largest gap between neighbours
+    vector<IndexType> col(nnz_);
+    IndexType max_gap = 0;
+    #pragma omp parallel
+    {
+        vector<std::pair<IndexType, double>> entries;
+        #pragma omp for schedule(static) reduction(max:max_gap)
+        for(IndexType r = 0; r < row_; ++r){
+            const IndexType begin = rowptr_[r];
+            const IndexType end = rowptr_[r+1];
+            if(std::is_sorted(A.colidx_.begin() + begin, A.colidx_.begin() + end)){
+                for(IndexType idx = begin; idx < end; ++idx){
+                    col[idx] = A.colidx_[idx];
+                    value_[idx] = A.value_[idx];
+                }
+            }else{
+                entries.clear();
+                for(IndexType idx = begin; idx < end; ++idx){
+                    entries.push_back(std::make_pair(A.colidx_[idx], A.value_[idx]));
+                }
+                std::sort(entries.begin(), entries.end());
+                for(IndexType idx = begin; idx < end; ++idx){
+                    col[idx] = entries[idx - begin].first;
+                    value_[idx] = entries[idx - begin].second;
+                }
+            }
+            for(IndexType idx = begin + 1; idx < end; ++idx){
+                max_gap = std::max(max_gap, col[idx] - col[idx-1]);
+            }
+        }
+    }
+
+    if(delta16 && max_gap > CSR_MIXED_DELTA_MAX){
+        cout << "Warning : CSRMixed, column gap " << max_gap << " does not fit in 16 bits, full column indices are kept !!!" << endl;
+    }
+    delta16_ = delta16 && max_gap <= CSR_MIXED_DELTA_MAX;
+    if(delta16_){
+        row_col_.resize(row_);
+        delta_.resize(nnz_);
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for(IndexType r = 0; r < row_; ++r){
+            const IndexType begin = rowptr_[r];
+            const IndexType end = rowptr_[r+1];
+            row_col_[r] = (end > begin) ? col[begin] : 0;
+            for(IndexType idx = begin; idx < end; ++idx){
+                delta_[idx] = static_cast<uint16_t>(idx == begin ? 0 : col[idx] - col[idx-1]);
+            }
+        }
+    }else{
+        colidx_.resize(nnz_);
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for(IndexType r = 0; r < row_; ++r){
+            for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
+                colidx_[idx] = col[idx];
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+double CSRMixed<IndexType, ValueType>::matrix_bytes() const {
+    double bytes = (static_cast<double>(row_) + 1.) * sizeof(IndexType) + static_cast<double>(nnz_) * sizeof(ValueType);
+    if(delta16_){
+        bytes += static_cast<double>(row_) * sizeof(IndexType) + static_cast<double>(nnz_) * sizeof(uint16_t);
+    }else{
+        bytes += static_cast<double>(nnz_) * sizeof(IndexType);
+    }
+    return bytes;
+}
+
+template <typename IndexType, typename ValueType>
+double CSRMixed<IndexType, ValueType>::row_product(IndexType r, const double* x) const {
+    double sum = 0.;
+    if(delta16_){
+        IndexType c = row_col_[r];
+        for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
+            c += delta_[idx];
+            sum += static_cast<double>(value_[idx]) * x[c];
+        }
+    }else{
+        for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
+            sum += static_cast<double>(value_[idx]) * x[colidx_[idx]];
+        }
+    }
+    return sum;
+}
+
+template <typename IndexType, typename ValueType>
+void CSRMixed<IndexType, ValueType>::SpMV(vector<double>& y, const vector<double>& x) const {
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        y[r] = row_product(r, x.data());
+    }
+}
+
+template <typename IndexType, typename ValueType>
+double CSRMixed<IndexType, ValueType>::SpMV_dot(vector<double>& y, const vector<double>& x) const {
+    assert(row_ == col_);
+    return SpMV_dot(y, x, x);
+}
+
+template <typename IndexType, typename ValueType>
+double CSRMixed<IndexType, ValueType>::SpMV_dot(vector<double>& y, const vector<double>& x, const vector<double>& r) const {
+    double dot = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static) reduction(+:dot)
+#endif
+    for(IndexType i = 0; i < row_; ++i){
+        const double sum = row_product(i, x.data());
+        y[i] = sum;
+        dot += r[i] * sum;
+    }
+    return dot;
+}
+
+template <typename IndexType, typename ValueType>
+void CSRMixed<IndexType, ValueType>::print_info() const {
+    cout << "CSRMixed" << endl;
+    cout << "row : " << row_ << ", col : " << col_ << ", nnz : " << nnz_ << endl;
+    cout << precision_info<IndexType, ValueType>() << ", column : " << (delta16_ ? "delta16" : "index") << endl;
+}
+
+template <typename IndexType, typename ValueType>
+void CSRMixed<IndexType, ValueType>::benchmark() const {
+    vector<double> x = benchmark_vector<double>(col_);
+    vector<double> y(row_, 0.);
+    const double vector_bytes = (static_cast<double>(row_) + col_) * sizeof(double);
+    const double csr_bytes = (static_cast<double>(row_) + 1.) * sizeof(IndexType)
+        + static_cast<double>(nnz_) * (sizeof(IndexType) + sizeof(double));
+    spmv_benchmark_run("spmv mixed csr", precision_info<IndexType, ValueType>() + ", column : " + (delta16_ ? "delta16" : "index")
+        + ", vector / accumulate : double", 2. * nnz_, matrix_bytes() + vector_bytes, [&](){ SpMV(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+
+    cout << "mixed csr bytes ------------" << endl;
+    cout << "matrix bytes : " << matrix_bytes() << ", CSR<" << type_name<IndexType>::get() << ", double> : " << csr_bytes
+         << ", saved : " << 100. * (1. - matrix_bytes() / csr_bytes) << "%" << endl;
+    cout << "bytes per SpMV (matrix + x + y) : " << matrix_bytes() + vector_bytes << " against " << csr_bytes + vector_bytes
+         << ", saved : " << 100. * (1. - (matrix_bytes() + vector_bytes) / (csr_bytes + vector_bytes)) << "%" << endl;
+    cout << "----------------------------" << endl;
+}
+
+template class CSRMixed<int32_t, float>;
+template class CSRMixed<int32_t, double>;
+template class CSRMixed<int64_t, float>;
+template class CSRMixed<int64_t, double>;
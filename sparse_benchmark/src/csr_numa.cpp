@@ -0,0 +1,179 @@
+#include "csr.hpp"
+#include "benchmark.hpp"
+#include <unistd.h>
+
+// at most this many pages per thread and array are queried for their node
+#define NUMA_PAGE_SAMPLE 4096
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::first_touch(){
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        for(IndexType i = rowptr_[r]; i < rowptr_[r+1]; ++i){
+            colidx_[i] = 0;
+            value_[i] = 0.;
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::numa_place(NumaPlacement placement){
+    numa_vector<IndexType> rowptr(row_ + 1);
+    numa_vector<IndexType> colidx(nnz_);
+    numa_vector<ValueType> value(nnz_);
+    if(placement == NUMA_PLACEMENT_MASTER){
+        std::copy(rowptr_.begin(), rowptr_.end(), rowptr.begin());
+        std::copy(colidx_.begin(), colidx_.end(), colidx.begin());
+        std::copy(value_.begin(), value_.end(), value.begin());
+    }else{
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for(IndexType r = 0; r <= row_; ++r){
+            rowptr[r] = rowptr_[r];
+        }
+#ifdef _OPENMP
+        #pragma omp parallel for schedule(static)
+#endif
+        for(IndexType r = 0; r < row_; ++r){
+            for(IndexType i = rowptr[r]; i < rowptr[r+1]; ++i){
+                colidx[i] = colidx_[i];
+                value[i] = value_[i];
+            }
+        }
+    }
+    rowptr_.swap(rowptr);
+    colidx_.swap(colidx);
+    value_.swap(value);
+}
+
+// fraction of the sampled pages of [begin, end) on node, pages of unknown node are skipped
+static void numa_count_local_pages(const char* begin, const char* end, int node, int64_t& local, int64_t& known){
+    const int64_t page_size = sysconf(_SC_PAGESIZE);
+    const uintptr_t first = reinterpret_cast<uintptr_t>(begin) / page_size;
+    const uintptr_t last = (reinterpret_cast<uintptr_t>(end) + page_size - 1) / page_size;
+    if(last <= first){
+        return;
+    }
+    const int64_t page_count = last - first;
+    const int64_t stride = std::max<int64_t>(1, page_count / NUMA_PAGE_SAMPLE);
+    vector<const void*> pages;
+    for(int64_t p = 0; p < page_count; p += stride){
+        pages.push_back(reinterpret_cast<const void*>((first + p) * page_size));
+    }
+    vector<int> nodes(pages.size());
+    numa_page_nodes(pages.data(), pages.size(), nodes.data());
+    for(size_t p = 0; p < nodes.size(); ++p){
+        if(nodes[p] >= 0){
+            known += 1;
+            local += nodes[p] == node;
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::numa_benchmark(){
+    const int thread_count = omp_get_max_threads();
+    const int repeat_count = std::max(1, env_get_int("REPEAT_COUNT", 10));
+    vector<int> thread_node(thread_count, 0);
+    // rows of each thread in the static schedule
+    vector<IndexType> row_begin(thread_count, 0);
+    vector<IndexType> row_end(thread_count, 0);
+    #pragma omp parallel num_threads(thread_count)
+    {
+        const int t = omp_get_thread_num();
+        thread_node[t] = numa_current_node();
+        IndexType begin = row_;
+        IndexType end = 0;
+        #pragma omp for schedule(static)
+        for(IndexType r = 0; r < row_; ++r){
+            begin = std::min(begin, r);
+            end = std::max(end, r + 1);
+        }
+        row_begin[t] = std::min(begin, end);
+        row_end[t] = end;
+    }
+    const int node_count = *std::max_element(thread_node.begin(), thread_node.end()) + 1;
+
+    vector<ValueType> x = benchmark_vector<ValueType>(col_);
+    vector<ValueType> y(row_, 0.);
+    const NumaPlacement placements[] = {NUMA_PLACEMENT_MASTER, NUMA_PLACEMENT_FIRST_TOUCH};
+    for(NumaPlacement placement : placements){
+        numa_place(placement);
+        spmv_benchmark_run("spmv numa", precision_info<IndexType, ValueType>() + "\nplacement : " + numa_placement_to_string(placement),
+            2. * nnz_, matrix_bytes() + (static_cast<double>(row_) + col_) * sizeof(ValueType), [&](){ SpMV(y, x); },
+            [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+
+        // each thread times its own rows, the slowest thread of a node gives the node time
+        vector<double> thread_time(static_cast<int64_t>(thread_count) * repeat_count, 0.);
+        for(int repeat = 0; repeat < repeat_count; ++repeat){
+            #pragma omp parallel num_threads(thread_count)
+            {
+                const int t = omp_get_thread_num();
+                #pragma omp barrier
+                const double start = omp_get_wtime();
+                #pragma omp for schedule(static) nowait
+                for(IndexType r = 0; r < row_; ++r){
+                    ValueType sum = 0.;
+                    for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
+                        sum += value_[idx] * x[colidx_[idx]];
+                    }
+                    y[r] = sum;
+                }
+                thread_time[static_cast<int64_t>(repeat) * thread_count + t] = omp_get_wtime() - start;
+            }
+        }
+
+        cout << "numa domain benchmark ------" << endl;
+        cout << "placement : " << numa_placement_to_string(placement) << ", thread count : " << thread_count
+             << ", nodes with threads : " << node_count << endl;
+        for(int node = 0; node < node_count; ++node){
+            int threads = 0;
+            double bytes = 0.;
+            int64_t local = 0;
+            int64_t known = 0;
+            for(int t = 0; t < thread_count; ++t){
+                if(thread_node[t] != node){
+                    continue;
+                }
+                threads += 1;
+                const IndexType nnz = rowptr_[row_end[t]] - rowptr_[row_begin[t]];
+                // rowptr + y of the rows, colidx + value of their entries, x not counted
+                bytes += (static_cast<double>(row_end[t]) - row_begin[t]) * (sizeof(IndexType) + sizeof(ValueType))
+                    + static_cast<double>(nnz) * (sizeof(IndexType) + sizeof(ValueType));
+                numa_count_local_pages(reinterpret_cast<const char*>(colidx_.data() + rowptr_[row_begin[t]]),
+                    reinterpret_cast<const char*>(colidx_.data() + rowptr_[row_end[t]]), node, local, known);
+                numa_count_local_pages(reinterpret_cast<const char*>(value_.data() + rowptr_[row_begin[t]]),
+                    reinterpret_cast<const char*>(value_.data() + rowptr_[row_end[t]]), node, local, known);
+            }
+            if(threads == 0){
+                continue;
+            }
+            vector<double> node_time(repeat_count, 0.);
+            for(int repeat = 0; repeat < repeat_count; ++repeat){
+                for(int t = 0; t < thread_count; ++t){
+                    if(thread_node[t] == node){
+                        node_time[repeat] = std::max(node_time[repeat], thread_time[static_cast<int64_t>(repeat) * thread_count + t]);
+                    }
+                }
+            }
+            std::sort(node_time.begin(), node_time.end());
+            const double median = node_time[repeat_count / 2];
+            cout << "node " << node << " : threads " << threads << ", time (median) " << median
+                 << ", GB/s " << bytes / median * 1e-9 << ", local pages ";
+            if(known > 0){
+                cout << static_cast<double>(local) / known << " (" << known << " sampled)" << endl;
+            }else{
+                cout << "unknown" << endl;
+            }
+        }
+        cout << "----------------------------" << endl;
+    }
+}
+
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
+template class CSR<int64_t, double>;
@@ -0,0 +1,209 @@
+#include "csr_pattern.hpp"
+#include "parallel.hpp"
+#include "benchmark.hpp"
+
+template <typename IndexType, typename ValueType>
+CSRPattern<IndexType, ValueType>::CSRPattern(const COO<IndexType, ValueType>& coo)
+    :row_(coo.row_), col_(coo.col_), nnz_(coo.nnz_), cell_count_(0), face_count_(0){
+    build(coo.rowidx_.data(), coo.colidx_.data(), coo.nnz_);
+}
+
+template <typename IndexType, typename ValueType>
+CSRPattern<IndexType, ValueType>::CSRPattern(const LDU<IndexType, ValueType>& ldu)
+    :row_(ldu.cell_count_), col_(ldu.cell_count_), nnz_(ldu.cell_count_ + 2 * ldu.face_count_),
+    cell_count_(ldu.cell_count_), face_count_(ldu.face_count_){
+    vector<IndexType> rowidx(nnz_);
+    vector<IndexType> colidx(nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType c = 0; c < cell_count_; ++c){
+        rowidx[c] = c;
+        colidx[c] = c;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType f = 0; f < face_count_; ++f){
+        rowidx[cell_count_ + f] = ldu.lower_addr_[f];
+        colidx[cell_count_ + f] = ldu.upper_addr_[f];
+        rowidx[cell_count_ + face_count_ + f] = ldu.upper_addr_[f];
+        colidx[cell_count_ + face_count_ + f] = ldu.lower_addr_[f];
+    }
+    build(rowidx.data(), colidx.data(), nnz_);
+}
+
+// counting sort of the positions by row (stable, serial), then each row by column
+template <typename IndexType, typename ValueType>
+void CSRPattern<IndexType, ValueType>::build(const IndexType* rowidx, const IndexType* colidx, IndexType nnz){
+    IndexType out_of_range = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:out_of_range)
+#endif
+    for(IndexType k = 0; k < nnz; ++k){
+        out_of_range += (rowidx[k] < 0 || rowidx[k] >= row_ || colidx[k] < 0 || colidx[k] >= col_);
+    }
+    if(out_of_range > 0){
+        cerr << "In CSRPattern<IndexType, ValueType>::build(const IndexType* rowidx, const IndexType* colidx, IndexType nnz), "
+             << out_of_range << " entries out of range !!!" << endl;
+        throw std::invalid_argument("index out of range");
+    }
+
+    rowptr_.assign(row_ + 1, 0);
+    for(IndexType k = 0; k < nnz; ++k){
+        rowptr_[rowidx[k]] += 1;
+    }
+    parallel_exclusive_scan(rowptr_.data(), static_cast<int64_t>(row_) + 1);
+    source_.resize(nnz);
+    colidx_.resize(nnz);
+    vector<IndexType> cursor(rowptr_.begin(), rowptr_.end() - 1);
+    for(IndexType k = 0; k < nnz; ++k){
+        source_[cursor[rowidx[k]]++] = k;
+    }
+
+    IndexType duplicate = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(dynamic, 256) reduction(+:duplicate)
+#endif
+    for(IndexType i = 0; i < row_; ++i){
+        std::sort(source_.begin() + rowptr_[i], source_.begin() + rowptr_[i+1],
+            [&](IndexType l, IndexType r){ return colidx[l] < colidx[r]; });
+        for(IndexType slot = rowptr_[i]; slot < rowptr_[i+1]; ++slot){
+            colidx_[slot] = colidx[source_[slot]];
+            duplicate += (slot > rowptr_[i] && colidx_[slot] == colidx_[slot - 1]);
+        }
+    }
+    if(duplicate > 0){
+        cerr << "In CSRPattern<IndexType, ValueType>::build(const IndexType* rowidx, const IndexType* colidx, IndexType nnz), "
+             << duplicate << " duplicate entries, the input has to be distinct !!!" << endl;
+        throw std::invalid_argument("duplicate entries");
+    }
+}
+
+template <typename IndexType, typename ValueType>
+CSR<IndexType, ValueType> CSRPattern<IndexType, ValueType>::csr() const {
+    return CSR<IndexType, ValueType>(row_, col_, rowptr_, colidx_, vector<ValueType>(nnz_, 0.));
+}
+
+template <typename IndexType, typename ValueType>
+void CSRPattern<IndexType, ValueType>::refresh(CSR<IndexType, ValueType>& csr, const vector<ValueType>& value) const {
+    if(csr.nnz_ != nnz_ || static_cast<IndexType>(value.size()) != nnz_){
+        cerr << "In CSRPattern<IndexType, ValueType>::refresh(CSR<IndexType, ValueType>& csr, const vector<ValueType>& value), "
+             << "csr nnz " << csr.nnz_ << " / value size " << value.size() << " != pattern nnz " << nnz_ << " !!!" << endl;
+        throw std::invalid_argument("pattern mismatch");
+    }
+    ValueType* dst = csr.value_.data();
+    const ValueType* src = value.data();
+    const IndexType* source = source_.data();
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType slot = 0; slot < nnz_; ++slot){
+        dst[slot] = src[source[slot]];
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSRPattern<IndexType, ValueType>::refresh(CSR<IndexType, ValueType>& csr, const LDU<IndexType, ValueType>& ldu) const {
+    if(csr.nnz_ != nnz_ || ldu.cell_count_ != cell_count_ || ldu.face_count_ != face_count_){
+        cerr << "In CSRPattern<IndexType, ValueType>::refresh(CSR<IndexType, ValueType>& csr, const LDU<IndexType, ValueType>& ldu), "
+             << "csr / ldu do not have the pattern !!!" << endl;
+        throw std::invalid_argument("pattern mismatch");
+    }
+    ValueType* dst = csr.value_.data();
+    const ValueType* diag = ldu.diag_.data();
+    const ValueType* upper = ldu.upper_.data();
+    const ValueType* lower = ldu.lower().data();
+    const IndexType* source = source_.data();
+    const IndexType upper_begin = cell_count_;
+    const IndexType lower_begin = cell_count_ + face_count_;
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType slot = 0; slot < nnz_; ++slot){
+        const IndexType s = source[slot];
+        dst[slot] = (s < upper_begin) ? diag[s] : (s < lower_begin ? upper[s - upper_begin] : lower[s - lower_begin]);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSRPattern<IndexType, ValueType>::print_info() const {
+    cout << "CSRPattern" << endl;
+    cout << "row : " << row_ << ", col : " << col_ << ", nnz : " << nnz_ << endl;
+    if(cell_count_ > 0){
+        cout << "source : ldu, cells : " << cell_count_ << ", faces : " << face_count_ << endl;
+    }else{
+        cout << "source : coo" << endl;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void refresh_benchmark(const CSR<IndexType, ValueType>& csr){
+    const string info = precision_info<IndexType, ValueType>();
+    vector<ValueType> x = benchmark_vector<ValueType>(csr.col_);
+    vector<ValueType> y(csr.row_);
+    // source index + value read, value write
+    const double refresh_bytes = static_cast<double>(csr.nnz_) * (sizeof(IndexType) + 2. * sizeof(ValueType));
+
+    // COO input in reversed order
+    const IndexType nnz = csr.nnz_;
+    vector<IndexType> rowidx(nnz);
+    vector<IndexType> colidx(nnz);
+    vector<ValueType> value(nnz);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < csr.row_; ++i){
+        for(IndexType idx = csr.rowptr_[i]; idx < csr.rowptr_[i+1]; ++idx){
+            rowidx[nnz - 1 - idx] = i;
+            colidx[nnz - 1 - idx] = csr.colidx_[idx];
+            value[nnz - 1 - idx] = csr.value_[idx];
+        }
+    }
+    omp_timer timer;
+    CSRPattern<IndexType, ValueType> coo_pattern(COO<IndexType, ValueType>(csr.row_, csr.col_, nnz, rowidx, colidx, value));
+    const double coo_setup_time = timer.timeIncrement();
+    coo_pattern.print_info();
+    cout << "pattern setup time : " << coo_setup_time << endl;
+
+    CSR<IndexType, ValueType> rebuilt;
+    spmv_benchmark_run("csr rebuild from coo (copy + sort + CSR(coo))", info, 0., 0.,
+        [&](){
+            COO<IndexType, ValueType> coo(csr.row_, csr.col_, nnz, rowidx, colidx, value);
+            coo.sort();
+            rebuilt = CSR<IndexType, ValueType>(coo);
+        },
+        [&](){ rebuilt.SpMV(y, x); return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+    CSR<IndexType, ValueType> refreshed = coo_pattern.csr();
+    spmv_benchmark_run("csr refresh from coo order", info, 0., refresh_bytes,
+        [&](){ coo_pattern.refresh(refreshed, value); },
+        [&](){ refreshed.SpMV(y, x); return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+
+    if(csr.row_ != csr.col_){
+        return;
+    }
+    LDU<IndexType, ValueType> ldu(csr);
+    timer.timeIncrement();
+    CSRPattern<IndexType, ValueType> ldu_pattern(ldu);
+    const double ldu_setup_time = timer.timeIncrement();
+    ldu_pattern.print_info();
+    cout << "pattern setup time : " << ldu_setup_time << endl;
+
+    spmv_benchmark_run("csr rebuild from ldu (to_csr)", info, 0., 0.,
+        [&](){ rebuilt = ldu.to_csr(); },
+        [&](){ rebuilt.SpMV(y, x); return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+    refreshed = ldu_pattern.csr();
+    spmv_benchmark_run("csr refresh from ldu", info, 0., static_cast<double>(ldu_pattern.nnz_) * (sizeof(IndexType) + 2. * sizeof(ValueType)),
+        [&](){ ldu_pattern.refresh(refreshed, ldu); },
+        [&](){ refreshed.SpMV(y, x); return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
+
+template class CSRPattern<int32_t, float>;
+template class CSRPattern<int32_t, double>;
+template class CSRPattern<int64_t, float>;
+template class CSRPattern<int64_t, double>;
+
+template void refresh_benchmark(const CSR<int32_t, float>& csr);
+template void refresh_benchmark(const CSR<int32_t, double>& csr);
+template void refresh_benchmark(const CSR<int64_t, float>& csr);
+template void refresh_benchmark(const CSR<int64_t, double>& csr);
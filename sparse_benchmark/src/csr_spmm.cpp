@@ -0,0 +1,66 @@
+#include "csr.hpp"
+#include "spmm.hpp"
+#include "benchmark.hpp"
+
+template <typename IndexType, typename ValueType>
+template <int K>
+void CSR<IndexType, ValueType>::SpMM_kernel(ValueType* Y, const ValueType* X, int k){
+    const int width = K > 0 ? K : k;
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        // K > 0 : one tile, the accumulators stay in registers
+        for(int j0 = 0; j0 < width; j0 += SPMM_MAX_K){
+            const int kt = K > 0 ? K : std::min(SPMM_MAX_K, width - j0);
+            ValueType sum[K > 0 ? K : SPMM_MAX_K];
+            for(int j = 0; j < kt; ++j){
+                sum[j] = 0.;
+            }
+            for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
+                const ValueType v = value_[idx];
+                const ValueType* xr = X + static_cast<int64_t>(colidx_[idx]) * width + j0;
+                #pragma omp simd
+                for(int j = 0; j < kt; ++j){
+                    sum[j] += v * xr[j];
+                }
+            }
+            ValueType* yr = Y + static_cast<int64_t>(r) * width + j0;
+            for(int j = 0; j < kt; ++j){
+                yr[j] = sum[j];
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::SpMM(vector<ValueType>& Y, const vector<ValueType>& X, int k){
+    assert(static_cast<int64_t>(X.size()) >= static_cast<int64_t>(col_) * k);
+    assert(static_cast<int64_t>(Y.size()) >= static_cast<int64_t>(row_) * k);
+#define CSR_SPMM_KERNEL(K) SpMM_kernel<K>(Y.data(), X.data(), k)
+    SPMM_DISPATCH(k, CSR_SPMM_KERNEL)
+#undef CSR_SPMM_KERNEL
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::spmm_benchmark(int k){
+    vector<ValueType> X = benchmark_block<ValueType>(col_, k);
+    vector<ValueType> Y(static_cast<int64_t>(row_) * k, 0.);
+    vector<vector<ValueType>> x = benchmark_columns<ValueType>(col_, k);
+    vector<vector<ValueType>> y(k, vector<ValueType>(row_, 0.));
+    double vector_bytes = (static_cast<double>(row_) + col_) * sizeof(ValueType);
+    spmm_benchmark_run("csr", precision_info<IndexType, ValueType>(), 2. * nnz_, k, matrix_bytes(), vector_bytes,
+        [&](){ SpMM(Y, X, k); },
+        [&](){
+            for(int j = 0; j < k; ++j){
+                SpMV(y[j], x[j]);
+            }
+        },
+        [&](){ return benchmark_residual_block(Y, k); },
+        [&](){ return benchmark_residual_block(y); }, benchmark_tolerance<ValueType>());
+}
+
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
+template class CSR<int64_t, double>;
@@ -1,58 +1,104 @@
 #include "csr.hpp"
+#include "benchmark.hpp"
 
-#define REPEAT_COUNT 1
+SpMVSchedule spmv_schedule_from_string(const string& name){
+    if(name == "row"){
+        return SPMV_SCHEDULE_ROW;
+    }
+    if(name == "merge" || name == "merge_path"){
+        return SPMV_SCHEDULE_MERGE_PATH;
+    }
+    cerr << "unknown spmv schedule : " << name << ", expect row or merge" << endl;
+    throw std::invalid_argument("unknown spmv schedule");
+}
+
+string spmv_schedule_to_string(SpMVSchedule schedule){
+    switch(schedule){
+        case SPMV_SCHEDULE_ROW : return "row";
+        case SPMV_SCHEDULE_MERGE_PATH : return "merge";
+    }
+    return "unknown";
+}
 
 template <typename IndexType, typename ValueType>
 void CSR<IndexType, ValueType>::spmv_benchmark(){
-    const int repeat_count = env_get_int("REPEAT_COUNT", 10);
+    const char* schedule = getenv("SPMV_SCHEDULE");
+    if(schedule == NULL){
+        spmv_benchmark(SPMV_SCHEDULE_ROW);
+    }else{
+        spmv_benchmark(spmv_schedule_from_string(schedule));
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::spmv_benchmark(SpMVSchedule schedule){
     // init x y
-    vector<ValueType> x(row_, 1.);
+    vector<ValueType> x = benchmark_vector<ValueType>(col_);
     vector<ValueType> y(row_, 0.);
-    omp_timer timer;
-    // warm up
-    SpMV(x, y);
+    spmv_benchmark_run("spmv", precision_info<IndexType, ValueType>() + "\nschedule : " + spmv_schedule_to_string(schedule),
+        2. * nnz_, matrix_bytes() + (static_cast<double>(row_) + col_) * sizeof(ValueType), [&](){ SpMV(y, x, schedule); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
 
-    double time_no_warm_up = timer.timeIncrement();
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::spmv_benchmark_mixed(){
+    vector<double> x = benchmark_vector<double>(col_);
+    vector<double> y(row_, 0.);
+    spmv_benchmark_run("spmv mixed", precision_info<IndexType, ValueType>() + ", vector / accumulate : double",
+        2. * nnz_, matrix_bytes() + (static_cast<double>(row_) + col_) * sizeof(double), [&](){ SpMV_mixed(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
 
-    for(int repeat = 0; repeat < repeat_count; ++repeat){
-        SpMV(x, y);
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueType>& x, SpMVSchedule schedule){
+    switch(schedule){
+        case SPMV_SCHEDULE_ROW :
+            SpMV(y, x);
+            break;
+        case SPMV_SCHEDULE_MERGE_PATH :
+            SpMV_merge_path(y, x);
+            break;
     }
+}
 
-    double time_warm_up = timer.timeIncrement();
-
-    double FLOPs = 2. * nnz_;
-    double TFLOPS = FLOPs / time_no_warm_up * 1e-12;
-
-    double FLOPs_repeat = FLOPs * repeat_count;
-    double TFLOPS_repeat = FLOPs_repeat / time_warm_up * 1e-12;
-
-    cout << "spmv benchmark -------------" << endl;
+template <typename IndexType, typename ValueType>
+template <typename VectorType>
+void CSR<IndexType, ValueType>::SpMV_row(VectorType* y, const VectorType* x){
 #ifdef _OPENMP
-    cout << "thread count : " << omp_get_max_threads() << endl;
+    #pragma omp parallel for schedule(static)
 #endif
-    cout << "with out warm up : " << endl;
-    cout << "time : " << time_no_warm_up << endl;
-    cout << "FLOPs : " << FLOPs << endl;
-    cout << "TFLOPS : " << TFLOPS << endl;
-    cout << "with warm up and repeat : " << endl;
-    cout << "repeat_count : " << repeat_count << endl;
-    cout << "time : " << time_warm_up << endl;
-    cout << "FLOPs : " << FLOPs_repeat << endl;
-    cout << "TFLOPS : " << TFLOPS_repeat << endl;
-    cout << "----------------------------" << endl;
+    for(IndexType r = 0; r < row_; ++r){
+        VectorType sum = 0.;
+        for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
+            sum += static_cast<VectorType>(value_[idx]) * x[colidx_[idx]];
+        }
+        y[r] = sum;
+    }
 }
 
-
 template <typename IndexType, typename ValueType>
 void CSR<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueType>& x){
-#ifdef _OPENMP
-    #pragma omp parallel for 
-#endif
+    SpMV_row(y.data(), x.data());
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::SpMV_mixed(vector<double>& y, const vector<double>& x){
+    SpMV_row(y.data(), x.data());
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::SpMV_reference(vector<double>& y, const vector<double>& x) const {
+    y.resize(row_);
     for(IndexType r = 0; r < row_; ++r){
+        long double sum = 0.;
         for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
-            y[r] += value_[idx] * x[colidx_[idx]];
+            sum += static_cast<long double>(value_[idx]) * x[colidx_[idx]];
         }
+        y[r] = static_cast<double>(sum);
     }
 }
 
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
 template class CSR<int64_t, double>;
@@ -0,0 +1,121 @@
+#include "csr.hpp"
+#include "benchmark.hpp"
+
+template <typename IndexType, typename ValueType>
+double CSR<IndexType, ValueType>::SpMV_dot(vector<ValueType>& y, const vector<ValueType>& x){
+    assert(row_ == col_);
+    return SpMV_dot(y, x, x);
+}
+
+template <typename IndexType, typename ValueType>
+double CSR<IndexType, ValueType>::SpMV_dot(vector<ValueType>& y, const vector<ValueType>& x, const vector<ValueType>& r){
+    double dot = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:dot)
+#endif
+    for(IndexType row = 0; row < row_; ++row){
+        ValueType sum = 0.;
+        for(IndexType idx = rowptr_[row]; idx < rowptr_[row+1]; ++idx){
+            sum += value_[idx] * x[colidx_[idx]];
+        }
+        y[row] = sum;
+        dot += static_cast<double>(r[row]) * sum;
+    }
+    return dot;
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::SpMV_axpy(vector<ValueType>& z, ValueType alpha, const vector<ValueType>& x){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType row = 0; row < row_; ++row){
+        ValueType sum = 0.;
+        for(IndexType idx = rowptr_[row]; idx < rowptr_[row+1]; ++idx){
+            sum += value_[idx] * x[colidx_[idx]];
+        }
+        z[row] += alpha * sum;
+    }
+}
+
+template <typename ValueType>
+static double dot_product(const vector<ValueType>& a, const vector<ValueType>& b){
+    const int64_t n = a.size();
+    double dot = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:dot)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        dot += static_cast<double>(a[i]) * b[i];
+    }
+    return dot;
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::spmv_fused_benchmark(){
+    if(row_ != col_){
+        cout << "Warning : spmv_fused_benchmark needs a square matrix, skipped !!!" << endl;
+        return;
+    }
+    const double n = row_;
+    const double vector_bytes = n * sizeof(ValueType);
+    const string info = precision_info<IndexType, ValueType>();
+    vector<ValueType> x = benchmark_vector<ValueType>(col_);
+    vector<ValueType> r = benchmark_vector<ValueType>(row_);
+    std::reverse(r.begin(), r.end());
+    vector<ValueType> y(row_, 0.);
+    vector<ValueType> tmp(row_, 0.);
+    double dot_fused = 0.;
+    double dot = 0.;
+
+    // spmv + <x, y> : the separate pass reads x and y again
+    // the residual covers y and the dot, relative to <x, y_ref>
+    spmv_benchmark_run("spmv + dot(x, y) fused", info, 2. * nnz_ + 2. * n, matrix_bytes() + 2. * vector_bytes,
+        [&](){ dot_fused = SpMV_dot(y, x); },
+        [&](){ return std::max(benchmark_residual(y), benchmark_residual_dot(dot_fused, x)); }, benchmark_tolerance<ValueType>());
+    spmv_benchmark_run("spmv + dot(x, y) unfused", info, 2. * nnz_ + 2. * n, matrix_bytes() + 4. * vector_bytes,
+        [&](){ SpMV(y, x); dot = dot_product(x, y); },
+        [&](){ return std::max(benchmark_residual(y), benchmark_residual_dot(dot, x)); }, benchmark_tolerance<ValueType>());
+    cout << "dot fused : " << dot_fused << ", unfused : " << dot << ", reference : " << benchmark_dot_reference(x) << endl;
+
+    // spmv + <r, y>
+    spmv_benchmark_run("spmv + dot(r, y) fused", info, 2. * nnz_ + 2. * n, matrix_bytes() + 3. * vector_bytes,
+        [&](){ dot_fused = SpMV_dot(y, x, r); },
+        [&](){ return std::max(benchmark_residual(y), benchmark_residual_dot(dot_fused, r)); }, benchmark_tolerance<ValueType>());
+    spmv_benchmark_run("spmv + dot(r, y) unfused", info, 2. * nnz_ + 2. * n, matrix_bytes() + 4. * vector_bytes,
+        [&](){ SpMV(y, x); dot = dot_product(r, y); },
+        [&](){ return std::max(benchmark_residual(y), benchmark_residual_dot(dot, r)); }, benchmark_tolerance<ValueType>());
+    cout << "dot fused : " << dot_fused << ", unfused : " << dot << ", reference : " << benchmark_dot_reference(r) << endl;
+
+    // z += alpha * A * x, z read + write, the separate pass writes and reads tmp.
+    // y accumulates over the timed calls : the check starts again from y0 = r
+    const ValueType alpha = 0.5;
+    auto spmv_axpy_unfused = [&](){
+        SpMV(tmp, x);
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < row_; ++i){
+            y[i] += alpha * tmp[i];
+        }
+    };
+    spmv_benchmark_run("spmv + axpy fused", info, 2. * nnz_ + 2. * n, matrix_bytes() + 3. * vector_bytes,
+        [&](){ SpMV_axpy(y, alpha, x); },
+        [&](){
+            y = r;
+            SpMV_axpy(y, alpha, x);
+            return benchmark_residual_axpy(y, r, alpha);
+        }, benchmark_tolerance<ValueType>());
+    spmv_benchmark_run("spmv + axpy unfused", info, 2. * nnz_ + 2. * n, matrix_bytes() + 5. * vector_bytes,
+        spmv_axpy_unfused,
+        [&](){
+            y = r;
+            spmv_axpy_unfused();
+            return benchmark_residual_axpy(y, r, alpha);
+        }, benchmark_tolerance<ValueType>());
+}
+
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
+template class CSR<int64_t, double>;
@@ -0,0 +1,129 @@
+#include "csr.hpp"
+#include <iomanip>
+
+// Merge path SpMV (Merrill & Garland, SC16).
+// The rowptr_ end offsets (list A) and the nnz indices (list B) are merged
+// into one path of row_ + nnz_ items, which is cut into equal pieces.
+// Every thread gets the same amount of row + nnz work, no matter how skewed
+// the row lengths are.
+
+// find the coordinate (row, nnz) where the diagonal crosses the merge path
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::merge_path_search(IndexType diagonal, IndexType& row, IndexType& nnz) const {
+    IndexType x_min = std::max(diagonal - nnz_, static_cast<IndexType>(0));
+    IndexType x_max = std::min(diagonal, row_);
+    while(x_min < x_max){
+        IndexType pivot = x_min + (x_max - x_min) / 2;
+        if(rowptr_[pivot + 1] <= diagonal - pivot - 1){
+            x_min = pivot + 1;
+        }else{
+            x_max = pivot;
+        }
+    }
+    row = x_min;
+    nnz = diagonal - x_min;
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::build_merge_path_partition(int thread_count){
+    merge_path_thread_count_ = thread_count;
+    merge_path_row_.resize(thread_count + 1);
+    merge_path_nnz_.resize(thread_count + 1);
+    carry_row_.resize(thread_count);
+    carry_value_.resize(thread_count);
+
+    const IndexType path_len = row_ + nnz_;
+    for(int t = 0; t <= thread_count; ++t){
+        IndexType diagonal = static_cast<IndexType>(static_cast<int64_t>(path_len) * t / thread_count);
+        merge_path_search(diagonal, merge_path_row_[t], merge_path_nnz_[t]);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::SpMV_merge_path(vector<ValueType>& y, const vector<ValueType>& x){
+    const int thread_count = omp_get_max_threads();
+    if(merge_path_thread_count_ != thread_count){
+        build_merge_path_partition(thread_count);
+    }
+
+    #pragma omp parallel num_threads(thread_count)
+    {
+        const int t = omp_get_thread_num();
+        IndexType r = merge_path_row_[t];
+        IndexType idx = merge_path_nnz_[t];
+        const IndexType row_end = merge_path_row_[t + 1];
+        const IndexType nnz_end = merge_path_nnz_[t + 1];
+
+        // rows completed by this thread
+        for(; r < row_end; ++r){
+            ValueType sum = 0.;
+            for(; idx < rowptr_[r+1]; ++idx){
+                sum += value_[idx] * x[colidx_[idx]];
+            }
+            y[r] = sum;
+        }
+
+        // head of the row finished by the next thread(s)
+        ValueType sum = 0.;
+        for(; idx < nnz_end; ++idx){
+            sum += value_[idx] * x[colidx_[idx]];
+        }
+        carry_row_[t] = row_end;
+        carry_value_[t] = sum;
+    }
+
+    // carry out fix up
+    for(int t = 0; t < thread_count - 1; ++t){
+        if(carry_row_[t] < row_){
+            y[carry_row_[t]] += carry_value_[t];
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void CSR<IndexType, ValueType>::load_balance_report(int thread_count){
+    if(merge_path_thread_count_ != thread_count){
+        build_merge_path_partition(thread_count);
+    }
+
+    // row schedule : contiguous blocks of rows, as omp static schedule
+    vector<IndexType> row_rows(thread_count), row_nnz(thread_count);
+    vector<IndexType> merge_rows(thread_count), merge_nnz(thread_count);
+    for(int t = 0; t < thread_count; ++t){
+        IndexType rs = static_cast<IndexType>(static_cast<int64_t>(row_) * t / thread_count);
+        IndexType re = static_cast<IndexType>(static_cast<int64_t>(row_) * (t + 1) / thread_count);
+        row_rows[t] = re - rs;
+        row_nnz[t] = rowptr_[re] - rowptr_[rs];
+        merge_rows[t] = merge_path_row_[t + 1] - merge_path_row_[t];
+        merge_nnz[t] = merge_path_nnz_[t + 1] - merge_path_nnz_[t];
+    }
+
+    // imbalance = max / mean of (row + nnz) work per thread
+    auto imbalance = [&](const vector<IndexType>& rows, const vector<IndexType>& nnz){
+        double max_work = 0.;
+        for(int t = 0; t < thread_count; ++t){
+            max_work = std::max(max_work, static_cast<double>(rows[t] + nnz[t]));
+        }
+        double mean_work = static_cast<double>(row_ + nnz_) / thread_count;
+        return mean_work > 0. ? max_work / mean_work : 1.;
+    };
+
+    cout << "load balance report --------" << endl;
+    cout << "thread count : " << thread_count << endl;
+    cout << std::setw(8) << "thread"
+         << std::setw(14) << "row:rows" << std::setw(14) << "row:nnz"
+         << std::setw(14) << "merge:rows" << std::setw(14) << "merge:nnz" << endl;
+    for(int t = 0; t < thread_count; ++t){
+        cout << std::setw(8) << t
+             << std::setw(14) << row_rows[t] << std::setw(14) << row_nnz[t]
+             << std::setw(14) << merge_rows[t] << std::setw(14) << merge_nnz[t] << endl;
+    }
+    cout << "imbalance (max/mean work) row : " << imbalance(row_rows, row_nnz) << endl;
+    cout << "imbalance (max/mean work) merge : " << imbalance(merge_rows, merge_nnz) << endl;
+    cout << "----------------------------" << endl;
+}
+
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
+template class CSR<int64_t, double>;
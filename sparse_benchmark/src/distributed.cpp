@@ -0,0 +1,406 @@
+#include "distributed.hpp"
+#include "benchmark.hpp"
+
+#include <climits>
+
+// MPI counts are int, larger blocks are rejected instead of truncated
+static int mpi_count(int64_t n){
+    if(n > INT_MAX){
+        cerr << "In mpi_count(int64_t n), block of " << n << " entries does not fit an MPI count !!!" << endl;
+        throw std::overflow_error("MPI count overflow");
+    }
+    return static_cast<int>(n);
+}
+
+// rank 0 sends data[begin[p], begin[p] + count[p]) to rank p and copies its own block,
+// the other ranks receive into block, which is sized to their count. data / begin / count
+// are only read on rank 0
+template <typename T>
+static void scatter_block(const T* data, const vector<int64_t>& begin, const vector<int64_t>& count,
+    vector<T>& block, int tag, MPI_Comm comm){
+    int rank = 0;
+    int size = 1;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    if(rank != 0){
+        MPI_Recv(block.data(), mpi_count(block.size()), mpi_type<T>::get(), 0, tag, comm, MPI_STATUS_IGNORE);
+        return;
+    }
+    std::copy(data + begin[0], data + begin[0] + count[0], block.begin());
+    for(int p = 1; p < size; ++p){
+        MPI_Send(data + begin[p], mpi_count(count[p]), mpi_type<T>::get(), p, tag, comm);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+DistributedCSR<IndexType, ValueType>::DistributedCSR(const CSR<IndexType, ValueType>& global, MPI_Comm comm):comm_(comm){
+    MPI_Comm_rank(comm_, &rank_);
+    MPI_Comm_size(comm_, &size_);
+    int square = (rank_ != 0 || global.row_ == global.col_);
+    MPI_Bcast(&square, 1, MPI_INT, 0, comm_);
+    if(!square){
+        cerr << "In DistributedCSR<IndexType, ValueType>::DistributedCSR(const CSR<IndexType, ValueType>& global, MPI_Comm comm), matrix have to be square !!!" << endl;
+        throw std::invalid_argument("matrix is not square");
+    }
+
+    // row blocks of about nnz / size entries, split on rank 0
+    row_offset_.resize(size_ + 1);
+    if(rank_ == 0){
+        for(int p = 0; p <= size_; ++p){
+            const IndexType target = static_cast<IndexType>(static_cast<double>(global.nnz_) * p / size_);
+            row_offset_[p] = (p == size_) ? global.row_
+                : std::lower_bound(global.rowptr_.begin(), global.rowptr_.end() - 1, target) - global.rowptr_.begin();
+        }
+    }
+    MPI_Bcast(row_offset_.data(), size_ + 1, mpi_type<IndexType>::get(), 0, comm_);
+    row_begin_ = row_offset_[rank_];
+    row_count_ = row_offset_[rank_ + 1] - row_begin_;
+    const IndexType row_end = row_begin_ + row_count_;
+
+    // row block of this rank : rowptr (rebased to 0 below), then the colidx / value of its nnz
+    vector<int64_t> begin(size_, 0);
+    vector<int64_t> count(size_, 0);
+    if(rank_ == 0){
+        for(int p = 0; p < size_; ++p){
+            begin[p] = row_offset_[p];
+            count[p] = row_offset_[p + 1] - row_offset_[p] + 1;
+        }
+    }
+    vector<IndexType> rowptr(row_count_ + 1);
+    scatter_block(global.rowptr_.data(), begin, count, rowptr, 0, comm_);
+    const IndexType nnz_begin = rowptr[0];
+    for(IndexType i = 0; i <= row_count_; ++i){
+        rowptr[i] -= nnz_begin;
+    }
+    if(rank_ == 0){
+        for(int p = 0; p < size_; ++p){
+            begin[p] = global.rowptr_[row_offset_[p]];
+            count[p] = global.rowptr_[row_offset_[p + 1]] - begin[p];
+        }
+    }
+    vector<IndexType> colidx(rowptr[row_count_]);
+    vector<ValueType> value(rowptr[row_count_]);
+    scatter_block(global.colidx_.data(), begin, count, colidx, 1, comm_);
+    scatter_block(global.value_.data(), begin, count, value, 2, comm_);
+
+    // halo : sorted distinct columns outside the block
+    for(IndexType idx = 0; idx < rowptr[row_count_]; ++idx){
+        const IndexType j = colidx[idx];
+        if(j < row_begin_ || j >= row_end){
+            halo_col_.push_back(j);
+        }
+    }
+    std::sort(halo_col_.begin(), halo_col_.end());
+    halo_col_.erase(std::unique(halo_col_.begin(), halo_col_.end()), halo_col_.end());
+    const IndexType halo_count = halo_col_.size();
+
+    // local / remote split, columns stay sorted : both renumberings keep the order
+    vector<IndexType> local_rowptr(row_count_ + 1, 0);
+    vector<IndexType> remote_rowptr(row_count_ + 1, 0);
+    for(IndexType i = 0; i < row_count_; ++i){
+        IndexType local_count = 0;
+        for(IndexType idx = rowptr[i]; idx < rowptr[i+1]; ++idx){
+            const IndexType j = colidx[idx];
+            local_count += (j >= row_begin_ && j < row_end);
+        }
+        local_rowptr[i + 1] = local_rowptr[i] + local_count;
+        remote_rowptr[i + 1] = remote_rowptr[i] + (rowptr[i+1] - rowptr[i] - local_count);
+    }
+    vector<IndexType> local_colidx(local_rowptr[row_count_]);
+    vector<ValueType> local_value(local_rowptr[row_count_]);
+    vector<IndexType> remote_colidx(remote_rowptr[row_count_]);
+    vector<ValueType> remote_value(remote_rowptr[row_count_]);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < row_count_; ++i){
+        IndexType l = local_rowptr[i];
+        IndexType r = remote_rowptr[i];
+        for(IndexType idx = rowptr[i]; idx < rowptr[i+1]; ++idx){
+            const IndexType j = colidx[idx];
+            if(j >= row_begin_ && j < row_end){
+                local_colidx[l] = j - row_begin_;
+                local_value[l++] = value[idx];
+            }else{
+                remote_colidx[r] = std::lower_bound(halo_col_.begin(), halo_col_.end(), j) - halo_col_.begin();
+                remote_value[r++] = value[idx];
+            }
+        }
+    }
+    local_ = CSR<IndexType, ValueType>(row_count_, row_count_, local_rowptr, local_colidx, local_value);
+    remote_ = CSR<IndexType, ValueType>(row_count_, halo_count, remote_rowptr, remote_colidx, remote_value);
+
+    // receive lists, the halo is grouped by owner
+    vector<int> recv_count(size_, 0);
+    vector<int> recv_displ(size_ + 1, 0);
+    for(IndexType h = 0; h < halo_count; ++h){
+        const int owner = std::upper_bound(row_offset_.begin(), row_offset_.end(), halo_col_[h]) - row_offset_.begin() - 1;
+        recv_count[owner] += 1;
+    }
+    recv_ptr_.push_back(0);
+    for(int p = 0; p < size_; ++p){
+        recv_displ[p + 1] = recv_displ[p] + recv_count[p];
+        if(recv_count[p] > 0){
+            recv_rank_.push_back(p);
+            recv_ptr_.push_back(recv_displ[p + 1]);
+        }
+    }
+
+    // send lists : every owner learns which of its rows the others need
+    vector<int> send_count(size_, 0);
+    vector<int> send_displ(size_ + 1, 0);
+    MPI_Alltoall(recv_count.data(), 1, MPI_INT, send_count.data(), 1, MPI_INT, comm_);
+    for(int p = 0; p < size_; ++p){
+        send_displ[p + 1] = send_displ[p] + send_count[p];
+    }
+    vector<IndexType> requested(send_displ[size_]);
+    MPI_Alltoallv(halo_col_.data(), recv_count.data(), recv_displ.data(), mpi_type<IndexType>::get(),
+        requested.data(), send_count.data(), send_displ.data(), mpi_type<IndexType>::get(), comm_);
+    send_ptr_.push_back(0);
+    for(int p = 0; p < size_; ++p){
+        if(send_count[p] > 0){
+            send_rank_.push_back(p);
+            send_ptr_.push_back(send_displ[p + 1]);
+        }
+    }
+    send_index_.resize(requested.size());
+    for(size_t k = 0; k < requested.size(); ++k){
+        send_index_[k] = requested[k] - row_begin_;
+    }
+
+    send_buffer_.resize(send_index_.size());
+    halo_.resize(halo_count);
+    requests_.resize(recv_rank_.size() + send_rank_.size());
+    reset_timers();
+}
+
+template <typename IndexType, typename ValueType>
+void DistributedCSR<IndexType, ValueType>::reset_timers(){
+    time_exchange_start_ = 0.;
+    time_local_ = 0.;
+    time_wait_ = 0.;
+    time_remote_ = 0.;
+    spmv_count_ = 0;
+}
+
+template <typename IndexType, typename ValueType>
+void DistributedCSR<IndexType, ValueType>::start_exchange(const vector<ValueType>& x){
+    const int recv_neighbour = recv_rank_.size();
+    for(int n = 0; n < recv_neighbour; ++n){
+        MPI_Irecv(halo_.data() + recv_ptr_[n], recv_ptr_[n+1] - recv_ptr_[n], mpi_type<ValueType>::get(),
+            recv_rank_[n], 0, comm_, &requests_[n]);
+    }
+    const IndexType send_total = send_index_.size();
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType k = 0; k < send_total; ++k){
+        send_buffer_[k] = x[send_index_[k]];
+    }
+    for(size_t n = 0; n < send_rank_.size(); ++n){
+        MPI_Isend(send_buffer_.data() + send_ptr_[n], send_ptr_[n+1] - send_ptr_[n], mpi_type<ValueType>::get(),
+            send_rank_[n], 0, comm_, &requests_[recv_neighbour + n]);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void DistributedCSR<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueType>& x){
+    double t = omp_get_wtime();
+    start_exchange(x);
+    time_exchange_start_ += omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    local_.SpMV(y, x);
+    time_local_ += omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+    time_wait_ += omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    if(remote_.nnz_ > 0){
+        remote_.SpMV_axpy(y, 1., halo_);
+    }
+    time_remote_ += omp_get_wtime() - t;
+    spmv_count_ += 1;
+}
+
+template <typename IndexType, typename ValueType>
+void DistributedCSR<IndexType, ValueType>::SpMV_blocking(vector<ValueType>& y, const vector<ValueType>& x){
+    double t = omp_get_wtime();
+    start_exchange(x);
+    time_exchange_start_ += omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    MPI_Waitall(requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+    time_wait_ += omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    local_.SpMV(y, x);
+    time_local_ += omp_get_wtime() - t;
+
+    t = omp_get_wtime();
+    if(remote_.nnz_ > 0){
+        remote_.SpMV_axpy(y, 1., halo_);
+    }
+    time_remote_ += omp_get_wtime() - t;
+    spmv_count_ += 1;
+}
+
+// min / max of value over the ranks
+static void distributed_min_max(double value, double& min, double& max, MPI_Comm comm){
+    MPI_Allreduce(&value, &min, 1, MPI_DOUBLE, MPI_MIN, comm);
+    MPI_Allreduce(&value, &max, 1, MPI_DOUBLE, MPI_MAX, comm);
+}
+
+template <typename IndexType, typename ValueType>
+void DistributedCSR<IndexType, ValueType>::print_info() const {
+    const double values[] = {static_cast<double>(row_count_), static_cast<double>(local_.nnz_), static_cast<double>(remote_.nnz_),
+        static_cast<double>(halo_col_.size()), static_cast<double>(recv_rank_.size()), static_cast<double>(send_index_.size())};
+    const char* names[] = {"rows", "local nnz", "remote nnz", "halo", "neighbours", "send"};
+    double min[6];
+    double max[6];
+    for(int k = 0; k < 6; ++k){
+        distributed_min_max(values[k], min[k], max[k], comm_);
+    }
+    if(rank_ != 0){
+        return;
+    }
+    cout << "DistributedCSR" << endl;
+    cout << "ranks : " << size_ << ", rows : " << row_offset_[size_] << endl;
+    for(int k = 0; k < 6; ++k){
+        cout << names[k] << " min / max : " << min[k] << " / " << max[k] << endl;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void DistributedCSR<IndexType, ValueType>::benchmark(){
+    const int repeat_count = std::max(1, env_get_int("REPEAT_COUNT", 10));
+    // owned entries of benchmark_vector, x[i] = 1 + ((row_begin_ + i) % 16) / 16
+    vector<ValueType> x(row_count_);
+    for(IndexType i = 0; i < row_count_; ++i){
+        x[i] = 1. + ((row_begin_ + i) % 16) / 16.;
+    }
+    vector<ValueType> y(row_count_, 0.);
+
+    // owned rows of the reference, set on rank 0 only
+    const vector<double>& y_ref_global = benchmark_reference();
+    int has_reference = (rank_ == 0 && static_cast<IndexType>(y_ref_global.size()) == row_offset_[size_]);
+    MPI_Bcast(&has_reference, 1, MPI_INT, 0, comm_);
+    vector<double> y_ref;
+    if(has_reference){
+        vector<int64_t> begin(size_, 0);
+        vector<int64_t> count(size_, 0);
+        for(int p = 0; p < size_ && rank_ == 0; ++p){
+            begin[p] = row_offset_[p];
+            count[p] = row_offset_[p + 1] - row_offset_[p];
+        }
+        y_ref.resize(row_count_);
+        scatter_block(y_ref_global.data(), begin, count, y_ref, 3, comm_);
+    }
+
+    double FLOPs = 2. * (local_.nnz_ + remote_.nnz_);
+    double bytes = local_.matrix_bytes() + remote_.matrix_bytes()
+        + (2. * row_count_ + halo_.size() + 2. * send_index_.size()) * sizeof(ValueType);
+    MPI_Allreduce(MPI_IN_PLACE, &FLOPs, 1, MPI_DOUBLE, MPI_SUM, comm_);
+    MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPI_DOUBLE, MPI_SUM, comm_);
+
+    for(int overlap = 1; overlap >= 0; --overlap){
+        auto spmv = [&](){
+            if(overlap){
+                SpMV(y, x);
+            }else{
+                SpMV_blocking(y, x);
+            }
+        };
+        MPI_Barrier(comm_);
+        double t = omp_get_wtime();
+        spmv();
+        double time_no_warm_up = omp_get_wtime() - t;
+        MPI_Allreduce(MPI_IN_PLACE, &time_no_warm_up, 1, MPI_DOUBLE, MPI_MAX, comm_);
+
+        reset_timers();
+        vector<double> times(repeat_count);
+        for(int repeat = 0; repeat < repeat_count; ++repeat){
+            MPI_Barrier(comm_);
+            t = omp_get_wtime();
+            spmv();
+            times[repeat] = omp_get_wtime() - t;
+        }
+        MPI_Allreduce(MPI_IN_PLACE, times.data(), repeat_count, MPI_DOUBLE, MPI_MAX, comm_);
+        double time_total = 0.;
+        for(int repeat = 0; repeat < repeat_count; ++repeat){
+            time_total += times[repeat];
+        }
+        std::sort(times.begin(), times.end());
+
+        // per call time split, average and max over the ranks
+        const double split[] = {time_exchange_start_ / spmv_count_, time_local_ / spmv_count_,
+            time_wait_ / spmv_count_, time_remote_ / spmv_count_};
+        double split_avg[4];
+        double split_max[4];
+        MPI_Allreduce(split, split_avg, 4, MPI_DOUBLE, MPI_SUM, comm_);
+        MPI_Allreduce(split, split_max, 4, MPI_DOUBLE, MPI_MAX, comm_);
+        for(int k = 0; k < 4; ++k){
+            split_avg[k] /= size_;
+        }
+
+        // owned rows against the reference of the global matrix
+        double diff = 0.;
+        double norm = 0.;
+        if(has_reference){
+            for(IndexType i = 0; i < row_count_; ++i){
+                diff = std::max(diff, std::abs(static_cast<double>(y[i]) - y_ref[i]));
+                norm = std::max(norm, std::abs(y_ref[i]));
+            }
+        }else{
+            diff = -1.;
+        }
+        MPI_Allreduce(MPI_IN_PLACE, &diff, 1, MPI_DOUBLE, MPI_MAX, comm_);
+        MPI_Allreduce(MPI_IN_PLACE, &norm, 1, MPI_DOUBLE, MPI_MAX, comm_);
+
+        if(rank_ != 0){
+            continue;
+        }
+        BenchmarkResult result;
+        result.title_ = overlap ? "distributed spmv overlap" : "distributed spmv blocking";
+        result.info_ = precision_info<IndexType, ValueType>() + "\nranks : " + std::to_string(size_);
+        result.thread_count_ = omp_get_max_threads();
+        result.repeat_count_ = repeat_count;
+        result.FLOPs_ = FLOPs;
+        result.bytes_ = bytes;
+        result.time_no_warm_up_ = time_no_warm_up;
+        result.time_total_ = time_total;
+        result.time_min_ = times.front();
+        result.time_max_ = times.back();
+        result.time_median_ = times[repeat_count / 2];
+        result.residual_ = (diff >= 0. && norm > 0.) ? diff / norm : diff;
+        result.tolerance_ = benchmark_tolerance<ValueType>();
+        benchmark_results().push_back(result);
+
+        const double communication = split_avg[0] + split_avg[2];
+        const double compute = split_avg[1] + split_avg[3];
+        cout << result.title_ << " benchmark -------------" << endl;
+        cout << "thread count : " << result.thread_count_ << endl;
+        cout << result.info_ << endl;
+        cout << "repeat_count : " << repeat_count << endl;
+        cout << "time min / median / max : " << result.time_min_ << " / " << result.time_median_ << " / " << result.time_max_ << endl;
+        cout << "TFLOPS (median) : " << FLOPs / result.time_median_ * 1e-12 << ", GB/s (median) : " << bytes / result.time_median_ * 1e-9 << endl;
+        cout << "per call, avg / max over ranks :" << endl;
+        cout << "  exchange start (pack + post) : " << split_avg[0] << " / " << split_max[0] << endl;
+        cout << "  local block : " << split_avg[1] << " / " << split_max[1] << endl;
+        cout << "  wait : " << split_avg[2] << " / " << split_max[2] << endl;
+        cout << "  remote block : " << split_avg[3] << " / " << split_max[3] << endl;
+        cout << "communication : " << communication << " (" << 100. * communication / (communication + compute)
+             << "%), compute : " << compute << " (" << 100. * compute / (communication + compute) << "%)" << endl;
+        if(result.residual_ >= 0.){
+            cout << "residual : " << result.residual_ << (result.residual_ <= result.tolerance_ ? " (passed)" : " (FAILED)") << endl;
+        }
+        cout << "----------------------------" << endl;
+    }
+}
+
+template class DistributedCSR<int32_t, float>;
+template class DistributedCSR<int32_t, double>;
+template class DistributedCSR<int64_t, float>;
+template class DistributedCSR<int64_t, double>;
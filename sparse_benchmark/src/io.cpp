@@ -1,35 +1,371 @@
 #include "mmio.h"
 #include "io.hpp"
+#include "parallel.hpp"
+#include <cstdio>
+#include <cstring>
+#include <cinttypes>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define CSR_BINARY_MAGIC 0x5243534253505342LL // "BSPSBSCR"
+#define CSR_BINARY_VERSION 2
+#define CSR_BINARY_HEADER 9
 
 COO<int64_t, double> read_coo_from_pattern_mtx(string filename){
+    return read_coo_from_mtx(filename);
+}
+
+static inline bool is_space(char c){
+    return c == ' ' || c == '\t' || c == '\r';
+}
+
+static inline const char* skip_space(const char* p, const char* end){
+    while(p < end && is_space(*p)){
+        ++p;
+    }
+    return p;
+}
+
+static inline const char* next_line(const char* p, const char* end){
+    const char* q = static_cast<const char*>(memchr(p, '\n', end - p));
+    return q == NULL ? end : q + 1;
+}
+
+// a data line holds an entry, blank and comment lines do not
+static inline bool is_entry_line(const char* p, const char* end){
+    p = skip_space(p, end);
+    return p < end && *p != '\n' && *p != '%';
+}
+
+static inline const char* parse_int64(const char* p, const char* end, int64_t& value){
+    p = skip_space(p, end);
+    bool negative = false;
+    if(p < end && (*p == '-' || *p == '+')){
+        negative = (*p == '-');
+        ++p;
+    }
+    int64_t v = 0;
+    while(p < end && *p >= '0' && *p <= '9'){
+        v = v * 10 + (*p - '0');
+        ++p;
+    }
+    value = negative ? -v : v;
+    return p;
+}
+
+// mm_read_mtx_crd_size with int64 sizes, comment and blank lines are skipped
+static int read_mtx_crd_size(FILE* f, int64_t& M, int64_t& N, int64_t& nz){
+    char line[MM_MAX_LINE_LENGTH];
+    M = N = nz = 0;
+    do{
+        if(fgets(line, MM_MAX_LINE_LENGTH, f) == NULL){
+            return MM_PREMATURE_EOF;
+        }
+    }while(line[0] == '%' || line[strspn(line, " \t\r\n")] == '\0');
+    if(sscanf(line, "%" SCNd64 " %" SCNd64 " %" SCNd64, &M, &N, &nz) != 3 || M < 0 || N < 0 || nz < 0){
+        return MM_PREMATURE_EOF;
+    }
+    return 0;
+}
+
+// the mapping is not NUL terminated, copy the token before strtod
+static inline const char* parse_double(const char* p, const char* end, double& value){
+    p = skip_space(p, end);
+    char token[MM_MAX_TOKEN_LENGTH];
+    int len = 0;
+    while(p < end && len < MM_MAX_TOKEN_LENGTH - 1 && !is_space(*p) && *p != '\n'){
+        token[len++] = *p++;
+    }
+    token[len] = '\0';
+    value = strtod(token, NULL);
+    return p;
+}
+
+COO<int64_t, double> read_coo_from_mtx(string filename){
 
-    int M,N,nz,*I,*J;
+    omp_timer timer;
 
-    mm_read_unsymmetric_sparse_pattern(filename.c_str(), &M, &N, &nz, &I, &J);
-    
-    int64_t row, col, nnz;
-    row = M;
-    col = N;
-    nnz = nz;
+    // banner and size line with mmio, the data section is parsed from the mapping
+    FILE* f = fopen(filename.c_str(), "r");
+    if(f == NULL){
+        cerr << "In read_coo_from_mtx, can not open " << filename << " !!!" << endl;
+        throw std::runtime_error("can not open mtx file");
+    }
+    MM_typecode matcode;
+    if(mm_read_banner(f, &matcode) != 0){
+        fclose(f);
+        cerr << "In read_coo_from_mtx, can not process Matrix Market banner of " << filename << " !!!" << endl;
+        throw std::runtime_error("bad mtx banner");
+    }
+    if(!(mm_is_matrix(matcode) && mm_is_coordinate(matcode))){
+        fclose(f);
+        cerr << "In read_coo_from_mtx, unsupported Matrix Market type [" << mm_typecode_to_str(matcode) << "] !!!" << endl;
+        throw std::runtime_error("unsupported mtx type");
+    }
+    int64_t M, N, nz;
+    if(read_mtx_crd_size(f, M, N, nz) != 0){
+        fclose(f);
+        cerr << "In read_coo_from_mtx, can not parse matrix size of " << filename << " !!!" << endl;
+        throw std::runtime_error("bad mtx size line");
+    }
+    const long data_offset = ftell(f);
+    fclose(f);
+
+    const bool pattern = mm_is_pattern(matcode);
+    const bool complex_value = mm_is_complex(matcode);
+    const bool mirror = mm_is_symmetric(matcode) || mm_is_skew(matcode) || mm_is_hermitian(matcode);
+    const double mirror_sign = mm_is_skew(matcode) ? -1. : 1.;
+    if(complex_value){
+        cout << "Warning : complex mtx, only the real part is kept !!!" << endl;
+    }
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if(fd < 0){
+        cerr << "In read_coo_from_mtx, can not open " << filename << " !!!" << endl;
+        throw std::runtime_error("can not open mtx file");
+    }
+    struct stat st;
+    if(fstat(fd, &st) != 0){
+        close(fd);
+        cerr << "In read_coo_from_mtx, fstat " << filename << " failed !!!" << endl;
+        throw std::runtime_error("fstat failed");
+    }
+    const size_t file_size = st.st_size;
+    void* map = mmap(NULL, file_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if(map == MAP_FAILED){
+        close(fd);
+        cerr << "In read_coo_from_mtx, mmap " << filename << " failed !!!" << endl;
+        throw std::runtime_error("mmap failed");
+    }
+    madvise(map, file_size, MADV_SEQUENTIAL);
+    const char* data_begin = static_cast<const char*>(map) + data_offset;
+    const char* data_end = static_cast<const char*>(map) + file_size;
+
+    // split the data section at line boundaries, one chunk per thread
+    const int thread_count = omp_get_max_threads();
+    vector<const char*> chunk(thread_count + 1);
+    chunk[0] = data_begin;
+    chunk[thread_count] = data_end;
+    for(int t = 1; t < thread_count; ++t){
+        const char* p = data_begin + (data_end - data_begin) * t / thread_count;
+        p = std::max(p, chunk[t - 1]);
+        chunk[t] = (p == data_begin) ? p : next_line(p - 1, data_end);
+    }
 
+    // pass 1 : entries per chunk
+    vector<int64_t> chunk_offset(thread_count + 1, 0);
+    #pragma omp parallel num_threads(thread_count)
+    {
+        const int t = omp_get_thread_num();
+        int64_t count = 0;
+        for(const char* p = chunk[t]; p < chunk[t + 1]; p = next_line(p, chunk[t + 1])){
+            if(is_entry_line(p, chunk[t + 1])){
+                ++count;
+            }
+        }
+        chunk_offset[t] = count;
+    }
+    const int64_t entry_count = parallel_exclusive_scan(chunk_offset.data(), static_cast<int64_t>(thread_count) + 1);
+    if(entry_count != nz){
+        munmap(map, file_size);
+        close(fd);
+        cerr << "In read_coo_from_mtx, expect " << nz << " entries but found " << entry_count << " !!!" << endl;
+        throw std::runtime_error("bad mtx entry count");
+    }
+
+    // pass 2 : parse
+    int64_t row = M;
+    int64_t col = N;
+    int64_t nnz = entry_count;
     vector<int64_t> rowidx(nnz);
     vector<int64_t> colidx(nnz);
     vector<double> value(nnz);
+    vector<int64_t> mirror_count(thread_count + 1, 0);
+    // entries out of [1, M] x [1, N] (or not parsed), no throw inside the region
+    int64_t bad_count = 0;
+    #pragma omp parallel num_threads(thread_count) reduction(+:bad_count)
+    {
+        const int t = omp_get_thread_num();
+        int64_t i = chunk_offset[t];
+        int64_t off_diag = 0;
+        for(const char* p = chunk[t]; p < chunk[t + 1]; p = next_line(p, chunk[t + 1])){
+            if(!is_entry_line(p, chunk[t + 1])){
+                continue;
+            }
+            int64_t r, c;
+            double v = 1.;
+            const char* q = parse_int64(p, chunk[t + 1], r);
+            q = parse_int64(q, chunk[t + 1], c);
+            if(!pattern){
+                parse_double(q, chunk[t + 1], v);
+            }
+            if(r < 1 || r > M || c < 1 || c > N){
+                ++bad_count;
+                r = c = 1;
+            }
+            rowidx[i] = r - 1;
+            colidx[i] = c - 1;
+            value[i] = v;
+            off_diag += (r != c);
+            ++i;
+        }
+        mirror_count[t] = off_diag;
+    }
+    if(bad_count != 0){
+        munmap(map, file_size);
+        close(fd);
+        cerr << "In read_coo_from_mtx, " << bad_count << " entries of " << filename << " are not in [1, " << M << "] x [1, " << N << "] !!!" << endl;
+        throw std::runtime_error("bad mtx entry index");
+    }
+    double parse_time = timer.timeIncrement();
 
-    for(int64_t i = 0; i < nnz; ++i){
-        rowidx[i] = I[i];
-        colidx[i] = J[i];
-        value[i] = 1.;
+    // expand symmetric storage : append the mirrored off diagonal entries
+    if(mirror){
+        const int64_t mirror_total = parallel_exclusive_scan(mirror_count.data(), static_cast<int64_t>(thread_count) + 1);
+        rowidx.resize(nnz + mirror_total);
+        colidx.resize(nnz + mirror_total);
+        value.resize(nnz + mirror_total);
+        #pragma omp parallel num_threads(thread_count)
+        {
+            const int t = omp_get_thread_num();
+            int64_t m = nnz + mirror_count[t];
+            for(int64_t i = chunk_offset[t]; i < chunk_offset[t + 1]; ++i){
+                if(rowidx[i] != colidx[i]){
+                    rowidx[m] = colidx[i];
+                    colidx[m] = rowidx[i];
+                    value[m] = mirror_sign * value[i];
+                    ++m;
+                }
+            }
+        }
+        nnz += mirror_total;
     }
 
-    free(I);
-    free(J);
+    munmap(map, file_size);
+    close(fd);
 
-    COO<int64_t, double> ret(row, col, nnz, rowidx, colidx, value);
-    // if(!ret.check_sorted()){
+    COO<int64_t, double> ret(row, col, nnz, std::move(rowidx), std::move(colidx), std::move(value));
+    if(!ret.check_sorted()){
         ret.sort();
-    // }
+    }
     ret.check_sorted();
+
+    double sort_time = timer.timeIncrement();
+
     ret.print_info();
+    cout << "mtx type : " << mm_typecode_to_str(matcode) << endl;
+    cout << "read time : " << parse_time << endl;
+    cout << "sort time : " << sort_time << endl;
+    return ret;
+}
+
+string csr_binary_filename(const string& filename){
+    return filename + ".csr.bin";
+}
+
+// size and mtime of the mtx file the sidecar was built from
+static bool source_stat(const string& source, int64_t& size, int64_t& mtime){
+    struct stat st;
+    if(stat(source.c_str(), &st) != 0){
+        return false;
+    }
+    size = static_cast<int64_t>(st.st_size);
+    mtime = static_cast<int64_t>(st.st_mtime);
+    return true;
+}
+
+void write_csr_binary(const CSR<int64_t, double>& csr, string filename, string source){
+    int64_t source_size, source_mtime;
+    if(!source_stat(source, source_size, source_mtime)){
+        cout << "Warning : can not stat " << source << ", csr binary not written !!!" << endl;
+        return;
+    }
+    FILE* f = fopen(filename.c_str(), "wb");
+    if(f == NULL){
+        cout << "Warning : can not write csr binary " << filename << " !!!" << endl;
+        return;
+    }
+    int64_t header[CSR_BINARY_HEADER] = {CSR_BINARY_MAGIC, CSR_BINARY_VERSION,
+        static_cast<int64_t>(sizeof(int64_t)), static_cast<int64_t>(sizeof(double)),
+        source_size, source_mtime, csr.row_, csr.col_, csr.nnz_};
+    bool ok = fwrite(header, sizeof(header), 1, f) == 1;
+    ok = ok && fwrite(csr.rowptr_.data(), sizeof(int64_t), csr.row_ + 1, f) == static_cast<size_t>(csr.row_ + 1);
+    ok = ok && fwrite(csr.colidx_.data(), sizeof(int64_t), csr.nnz_, f) == static_cast<size_t>(csr.nnz_);
+    ok = ok && fwrite(csr.value_.data(), sizeof(double), csr.nnz_, f) == static_cast<size_t>(csr.nnz_);
+    fclose(f);
+    if(!ok){
+        cout << "Warning : writing csr binary " << filename << " failed !!!" << endl;
+        remove(filename.c_str());
+    }
+}
+
+bool read_csr_binary(CSR<int64_t, double>& csr, string filename, string source){
+    int64_t source_size, source_mtime;
+    if(!source_stat(source, source_size, source_mtime)){
+        return false;
+    }
+    FILE* f = fopen(filename.c_str(), "rb");
+    if(f == NULL){
+        return false;
+    }
+    int64_t header[CSR_BINARY_HEADER];
+    if(fread(header, sizeof(header), 1, f) != 1
+        || header[0] != CSR_BINARY_MAGIC || header[1] != CSR_BINARY_VERSION
+        || header[2] != static_cast<int64_t>(sizeof(int64_t)) || header[3] != static_cast<int64_t>(sizeof(double))
+        || header[4] != source_size || header[5] != source_mtime
+        || header[6] < 0 || header[7] < 0 || header[8] < 0){
+        fclose(f);
+        return false;
+    }
+    csr.row_ = header[6];
+    csr.col_ = header[7];
+    csr.nnz_ = header[8];
+    csr.rowptr_.resize(csr.row_ + 1);
+    csr.colidx_.resize(csr.nnz_);
+    csr.value_.resize(csr.nnz_);
+    // place the pages before fread writes them from this thread
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for(int64_t r = 0; r <= csr.row_; ++r){
+        csr.rowptr_[r] = 0;
+    }
+    bool ok = fread(csr.rowptr_.data(), sizeof(int64_t), csr.row_ + 1, f) == static_cast<size_t>(csr.row_ + 1);
+    ok = ok && csr.rowptr_[0] == 0 && csr.rowptr_[csr.row_] == csr.nnz_;
+    if(ok){
+        csr.first_touch();
+    }
+    ok = ok && fread(csr.colidx_.data(), sizeof(int64_t), csr.nnz_, f) == static_cast<size_t>(csr.nnz_);
+    ok = ok && fread(csr.value_.data(), sizeof(double), csr.nnz_, f) == static_cast<size_t>(csr.nnz_);
+    fclose(f);
+    // the sorted flag is not stored, it comes from the loaded columns
+    ok = ok && csr.check_sorted();
+    return ok;
+}
+
+CSR<int64_t, double> read_csr_from_mtx(string filename){
+    const bool use_cache = env_get_bool("MTX_BINARY_CACHE", true);
+    const string binary_filename = csr_binary_filename(filename);
+
+    omp_timer timer;
+    CSR<int64_t, double> ret;
+
+    bool cached = false;
+    if(use_cache){
+        cached = read_csr_binary(ret, binary_filename, filename);
+    }
+
+    if(cached){
+        cout << "load csr binary : " << binary_filename << endl;
+        cout << "load time : " << timer.timeIncrement() << endl;
+    }else{
+        COO<int64_t, double> coo = read_coo_from_mtx(filename);
+        ret = CSR<int64_t, double>(coo);
+        if(use_cache){
+            write_csr_binary(ret, binary_filename, filename);
+        }
+    }
     return ret;
 }
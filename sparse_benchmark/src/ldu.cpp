@@ -0,0 +1,181 @@
+#include "ldu.hpp"
+
+// binary search A(r, c) in a CSR with sorted rows, 0 if absent
+template<typename IndexType, typename ValueType>
+static ValueType csr_value_at(const CSR<IndexType,ValueType>& csr, IndexType r, IndexType c){
+    const IndexType* begin = csr.colidx_.data() + csr.rowptr_[r];
+    const IndexType* end = csr.colidx_.data() + csr.rowptr_[r + 1];
+    const IndexType* it = std::lower_bound(begin, end, c);
+    if(it != end && *it == c){
+        return csr.value_[it - csr.colidx_.data()];
+    }
+    return 0.;
+}
+
+template<typename IndexType, typename ValueType>
+LDU<IndexType, ValueType>::LDU(const CSR<IndexType,ValueType>& csr, bool detect_symmetric)
+    :partition_thread_count_(0), symmetric_(false){
+    if(csr.row_ != csr.col_){
+        cerr << "In LDU<IndexType, ValueType>::LDU(const CSR<IndexType,ValueType>& csr), csr have to be square !!!" << endl;
+        throw std::invalid_argument("csr is not square");
+    }
+    cell_count_ = csr.row_;
+
+    // (owner, neighbour) of every off diagonal entry, sorted and unique
+    IndexType off_diag_count = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:off_diag_count)
+#endif
+    for(IndexType r = 0; r < cell_count_; ++r){
+        for(IndexType idx = csr.rowptr_[r]; idx < csr.rowptr_[r + 1]; ++idx){
+            off_diag_count += (csr.colidx_[idx] != r);
+        }
+    }
+    vector<IndexType> owner(off_diag_count), neighbour(off_diag_count);
+    vector<ValueType> unused(off_diag_count);
+    IndexType pos = 0;
+    for(IndexType r = 0; r < cell_count_; ++r){
+        for(IndexType idx = csr.rowptr_[r]; idx < csr.rowptr_[r + 1]; ++idx){
+            IndexType c = csr.colidx_[idx];
+            if(c != r){
+                owner[pos] = std::min(r, c);
+                neighbour[pos] = std::max(r, c);
+                ++pos;
+            }
+        }
+    }
+    COO<IndexType,ValueType> face(cell_count_, cell_count_, off_diag_count, std::move(owner), std::move(neighbour), std::move(unused));
+    face.sort();
+
+    face_count_ = 0;
+    lower_addr_.resize(off_diag_count);
+    upper_addr_.resize(off_diag_count);
+    for(IndexType i = 0; i < off_diag_count; ++i){
+        if(i > 0 && face.rowidx_[i] == face.rowidx_[i - 1] && face.colidx_[i] == face.colidx_[i - 1]){
+            continue;
+        }
+        lower_addr_[face_count_] = face.rowidx_[i];
+        upper_addr_[face_count_] = face.colidx_[i];
+        ++face_count_;
+    }
+    lower_addr_.resize(face_count_);
+    upper_addr_.resize(face_count_);
+
+    // coefficients
+    diag_.resize(cell_count_);
+    upper_.resize(face_count_);
+    lower_.resize(face_count_);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType c = 0; c < cell_count_; ++c){
+        diag_[c] = csr_value_at(csr, c, c);
+    }
+    IndexType asymmetric = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:asymmetric)
+#endif
+    for(IndexType f = 0; f < face_count_; ++f){
+        upper_[f] = csr_value_at(csr, lower_addr_[f], upper_addr_[f]);
+        lower_[f] = csr_value_at(csr, upper_addr_[f], lower_addr_[f]);
+        asymmetric += (upper_[f] != lower_[f]);
+    }
+
+    if(detect_symmetric && asymmetric == 0){
+        symmetric_ = true;
+        vector<ValueType>().swap(lower_);
+    }
+}
+
+template<typename IndexType, typename ValueType>
+CSR<IndexType,ValueType> LDU<IndexType, ValueType>::to_csr() const {
+    const IndexType nnz = cell_count_ + 2 * face_count_;
+    const vector<ValueType>& lower_value = lower();
+    vector<IndexType> rowidx(nnz), colidx(nnz);
+    vector<ValueType> value(nnz);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType c = 0; c < cell_count_; ++c){
+        rowidx[c] = c;
+        colidx[c] = c;
+        value[c] = diag_[c];
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType f = 0; f < face_count_; ++f){
+        IndexType u = cell_count_ + 2 * f;
+        rowidx[u] = lower_addr_[f];
+        colidx[u] = upper_addr_[f];
+        value[u] = upper_[f];
+        rowidx[u + 1] = upper_addr_[f];
+        colidx[u + 1] = lower_addr_[f];
+        value[u + 1] = lower_value[f];
+    }
+    COO<IndexType,ValueType> coo(cell_count_, cell_count_, nnz, std::move(rowidx), std::move(colidx), std::move(value));
+    coo.sort();
+    return CSR<IndexType,ValueType>(coo);
+}
+
+template<typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::build_partition(int thread_count){
+    partition_thread_count_ = thread_count;
+    thread_cell_start_.resize(thread_count + 1);
+    thread_face_start_.resize(thread_count + 1);
+    for(int t = 0; t <= thread_count; ++t){
+        thread_cell_start_[t] = static_cast<IndexType>(static_cast<int64_t>(cell_count_) * t / thread_count);
+        // faces are ordered by owner
+        thread_face_start_[t] = std::lower_bound(lower_addr_.begin(), lower_addr_.end(), thread_cell_start_[t]) - lower_addr_.begin();
+    }
+
+    // faces crossing into another thread, grouped by the neighbour's thread
+    auto thread_of = [&](IndexType cell){
+        return static_cast<int>(std::upper_bound(thread_cell_start_.begin(), thread_cell_start_.end(), cell) - thread_cell_start_.begin()) - 1;
+    };
+    incoming_ptr_.assign(thread_count + 1, 0);
+    for(int t = 0; t < thread_count; ++t){
+        IndexType cell_end = thread_cell_start_[t + 1];
+        for(IndexType f = thread_face_start_[t]; f < thread_face_start_[t + 1]; ++f){
+            if(upper_addr_[f] >= cell_end){
+                incoming_ptr_[thread_of(upper_addr_[f]) + 1] += 1;
+            }
+        }
+    }
+    for(int t = 0; t < thread_count; ++t){
+        incoming_ptr_[t + 1] += incoming_ptr_[t];
+    }
+    incoming_face_.resize(incoming_ptr_[thread_count]);
+    vector<IndexType> cursor(incoming_ptr_.begin(), incoming_ptr_.end() - 1);
+    for(int t = 0; t < thread_count; ++t){
+        IndexType cell_end = thread_cell_start_[t + 1];
+        for(IndexType f = thread_face_start_[t]; f < thread_face_start_[t + 1]; ++f){
+            if(upper_addr_[f] >= cell_end){
+                incoming_face_[cursor[thread_of(upper_addr_[f])]++] = f;
+            }
+        }
+    }
+}
+
+template<typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::print_info(){
+    const double ldu_bytes = matrix_bytes();
+    const double csr_bytes = static_cast<double>(cell_count_ + 2 * face_count_) * (sizeof(IndexType) + sizeof(ValueType))
+        + (cell_count_ + 1.) * sizeof(IndexType);
+    cout << "LDU" << endl;
+    cout << "cell count : " << cell_count_ << endl;
+    cout << "face count : " << face_count_ << endl;
+    cout << "symmetric : " << symmetric_ << endl;
+    cout << "matrix bytes CSR : " << csr_bytes << ", LDU : " << ldu_bytes << ", ratio : " << ldu_bytes / csr_bytes << endl;
+}
+
+template<typename IndexType, typename ValueType>
+double LDU<IndexType, ValueType>::matrix_bytes() const {
+    return static_cast<double>(cell_count_) * sizeof(ValueType)
+        + static_cast<double>(face_count_) * (2 * sizeof(IndexType) + (symmetric_ ? 1 : 2) * sizeof(ValueType));
+}
+
+template class LDU<int32_t, float>;
+template class LDU<int32_t, double>;
+template class LDU<int64_t, float>;
+template class LDU<int64_t, double>;
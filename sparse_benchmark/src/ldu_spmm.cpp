@@ -0,0 +1,96 @@
+#include "ldu.hpp"
+#include "spmm.hpp"
+#include "benchmark.hpp"
+
+// same face partition as Amul, k coefficients per cell
+template <typename IndexType, typename ValueType>
+template <int K>
+void LDU<IndexType, ValueType>::SpMM_kernel(ValueType* Y, const ValueType* X, int k){
+    const int width = K > 0 ? K : k;
+    const IndexType* l = lower_addr_.data();
+    const IndexType* u = upper_addr_.data();
+    const ValueType* diag = diag_.data();
+    const ValueType* upper = upper_.data();
+    const ValueType* lower_value = lower().data();
+
+    #pragma omp parallel num_threads(partition_thread_count_)
+    {
+        const int t = omp_get_thread_num();
+        const IndexType cell_start = thread_cell_start_[t];
+        const IndexType cell_end = thread_cell_start_[t + 1];
+
+        for(IndexType c = cell_start; c < cell_end; ++c){
+            const ValueType d = diag[c];
+            #pragma omp simd
+            for(int j = 0; j < width; ++j){
+                Y[static_cast<int64_t>(c) * width + j] = d * X[static_cast<int64_t>(c) * width + j];
+            }
+        }
+
+        for(IndexType f = thread_face_start_[t]; f < thread_face_start_[t + 1]; ++f){
+            ValueType* yl = Y + static_cast<int64_t>(l[f]) * width;
+            const ValueType* xu = X + static_cast<int64_t>(u[f]) * width;
+            const ValueType uf = upper[f];
+            #pragma omp simd
+            for(int j = 0; j < width; ++j){
+                yl[j] += uf * xu[j];
+            }
+            if(u[f] < cell_end){
+                ValueType* yu = Y + static_cast<int64_t>(u[f]) * width;
+                const ValueType* xl = X + static_cast<int64_t>(l[f]) * width;
+                const ValueType lf = lower_value[f];
+                #pragma omp simd
+                for(int j = 0; j < width; ++j){
+                    yu[j] += lf * xl[j];
+                }
+            }
+        }
+
+        for(IndexType i = incoming_ptr_[t]; i < incoming_ptr_[t + 1]; ++i){
+            IndexType f = incoming_face_[i];
+            ValueType* yu = Y + static_cast<int64_t>(u[f]) * width;
+            const ValueType* xl = X + static_cast<int64_t>(l[f]) * width;
+            const ValueType lf = lower_value[f];
+            #pragma omp simd
+            for(int j = 0; j < width; ++j){
+                yu[j] += lf * xl[j];
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::SpMM(vector<ValueType>& Y, const vector<ValueType>& X, int k){
+    assert(static_cast<int64_t>(X.size()) >= static_cast<int64_t>(cell_count_) * k);
+    assert(static_cast<int64_t>(Y.size()) >= static_cast<int64_t>(cell_count_) * k);
+    const int thread_count = omp_get_max_threads();
+    if(partition_thread_count_ != thread_count){
+        build_partition(thread_count);
+    }
+#define LDU_SPMM_KERNEL(K) SpMM_kernel<K>(Y.data(), X.data(), k)
+    SPMM_DISPATCH(k, LDU_SPMM_KERNEL)
+#undef LDU_SPMM_KERNEL
+}
+
+template <typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::spmm_benchmark(int k){
+    vector<ValueType> X = benchmark_block<ValueType>(cell_count_, k);
+    vector<ValueType> Y(static_cast<int64_t>(cell_count_) * k, 0.);
+    vector<vector<ValueType>> x = benchmark_columns<ValueType>(cell_count_, k);
+    vector<vector<ValueType>> y(k, vector<ValueType>(cell_count_, 0.));
+    double vector_bytes = 2. * cell_count_ * sizeof(ValueType);
+    spmm_benchmark_run("ldu", precision_info<IndexType, ValueType>(), 2. * (cell_count_ + 2. * face_count_), k, matrix_bytes(), vector_bytes,
+        [&](){ SpMM(Y, X, k); },
+        [&](){
+            for(int j = 0; j < k; ++j){
+                Amul(y[j], x[j]);
+            }
+        },
+        [&](){ return benchmark_residual_block(Y, k); },
+        [&](){ return benchmark_residual_block(y); }, benchmark_tolerance<ValueType>());
+}
+
+template class LDU<int32_t, float>;
+template class LDU<int32_t, double>;
+template class LDU<int64_t, float>;
+template class LDU<int64_t, double>;
@@ -0,0 +1,78 @@
+#include "ldu.hpp"
+#include "benchmark.hpp"
+
+template <typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::spmv_benchmark(){
+    // init x y
+    vector<ValueType> x = benchmark_vector<ValueType>(cell_count_);
+    vector<ValueType> y(cell_count_, 0.);
+    spmv_benchmark_run("ldu amul", precision_info<IndexType, ValueType>() + "\nsymmetric : " + (symmetric_ ? "1" : "0"),
+        2. * (cell_count_ + 2. * face_count_), matrix_bytes() + 2. * cell_count_ * sizeof(ValueType), [&](){ Amul(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
+
+template <typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::spmv_benchmark_mixed(){
+    vector<double> x = benchmark_vector<double>(cell_count_);
+    vector<double> y(cell_count_, 0.);
+    spmv_benchmark_run("ldu amul mixed", precision_info<IndexType, ValueType>() + ", vector / accumulate : double",
+        2. * (cell_count_ + 2. * face_count_), matrix_bytes() + 2. * cell_count_ * sizeof(double), [&](){ Amul_mixed(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
+
+template <typename IndexType, typename ValueType>
+template <typename VectorType>
+void LDU<IndexType, ValueType>::Amul_kernel(VectorType* y, const VectorType* x){
+    const int thread_count = omp_get_max_threads();
+    if(partition_thread_count_ != thread_count){
+        build_partition(thread_count);
+    }
+
+    const IndexType* l = lower_addr_.data();
+    const IndexType* u = upper_addr_.data();
+    const ValueType* diag = diag_.data();
+    const ValueType* upper = upper_.data();
+    const ValueType* lower_value = lower().data();
+    const VectorType* x_ptr = x;
+    VectorType* y_ptr = y;
+
+    #pragma omp parallel num_threads(thread_count)
+    {
+        const int t = omp_get_thread_num();
+        const IndexType cell_start = thread_cell_start_[t];
+        const IndexType cell_end = thread_cell_start_[t + 1];
+
+        for(IndexType c = cell_start; c < cell_end; ++c){
+            y_ptr[c] = static_cast<VectorType>(diag[c]) * x_ptr[c];
+        }
+
+        // face loop over the faces owned by this thread
+        for(IndexType f = thread_face_start_[t]; f < thread_face_start_[t + 1]; ++f){
+            y_ptr[l[f]] += static_cast<VectorType>(upper[f]) * x_ptr[u[f]];
+            if(u[f] < cell_end){
+                y_ptr[u[f]] += static_cast<VectorType>(lower_value[f]) * x_ptr[l[f]];
+            }
+        }
+
+        // lower coefficients of faces owned by earlier threads
+        for(IndexType i = incoming_ptr_[t]; i < incoming_ptr_[t + 1]; ++i){
+            IndexType f = incoming_face_[i];
+            y_ptr[u[f]] += static_cast<VectorType>(lower_value[f]) * x_ptr[l[f]];
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::Amul(vector<ValueType>& y, const vector<ValueType>& x){
+    Amul_kernel(y.data(), x.data());
+}
+
+template <typename IndexType, typename ValueType>
+void LDU<IndexType, ValueType>::Amul_mixed(vector<double>& y, const vector<double>& x){
+    Amul_kernel(y.data(), x.data());
+}
+
+template class LDU<int32_t, float>;
+template class LDU<int32_t, double>;
+template class LDU<int64_t, float>;
+template class LDU<int64_t, double>;
@@ -0,0 +1,109 @@
+#include "numa.hpp"
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+// set by numa_pin_threads
+static bool numa_pinned = false;
+
+NumaPlacement numa_placement_from_string(const string& name){
+    if(name == "master"){
+        return NUMA_PLACEMENT_MASTER;
+    }
+    if(name == "first_touch"){
+        return NUMA_PLACEMENT_FIRST_TOUCH;
+    }
+    cerr << "unknown numa placement : " << name << ", expect master or first_touch" << endl;
+    throw std::invalid_argument("unknown numa placement");
+}
+
+string numa_placement_to_string(NumaPlacement placement){
+    switch(placement){
+        case NUMA_PLACEMENT_MASTER : return "master";
+        case NUMA_PLACEMENT_FIRST_TOUCH : return "first_touch";
+    }
+    return "unknown";
+}
+
+int numa_current_node(){
+#ifdef SYS_getcpu
+    unsigned cpu = 0;
+    unsigned node = 0;
+    if(syscall(SYS_getcpu, &cpu, &node, NULL) == 0){
+        return node;
+    }
+#endif
+    return 0;
+}
+
+void numa_page_nodes(const void* const* pages, int64_t count, int* nodes){
+#ifdef SYS_move_pages
+    // nodes == NULL : only report the node of each page in status
+    if(syscall(SYS_move_pages, 0, static_cast<unsigned long>(count), pages, NULL, nodes, 0) == 0){
+        for(int64_t i = 0; i < count; ++i){
+            nodes[i] = std::max(nodes[i], -1);
+        }
+        return;
+    }
+#endif
+    std::fill(nodes, nodes + count, -1);
+}
+
+bool numa_pin_threads(){
+    if(!env_get_bool("NUMA_PIN", false)){
+        return false;
+    }
+    if(getenv("OMP_PLACES") != NULL || omp_get_proc_bind() != omp_proc_bind_false){
+        cout << "Warning : NUMA_PIN is ignored, the OpenMP runtime binds the threads (OMP_PLACES / OMP_PROC_BIND) !!!" << endl;
+        return false;
+    }
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if(sched_getaffinity(0, sizeof(mask), &mask) != 0){
+        cout << "Warning : NUMA_PIN, sched_getaffinity failed !!!" << endl;
+        return false;
+    }
+    vector<int> cpus;
+    for(int c = 0; c < CPU_SETSIZE; ++c){
+        if(CPU_ISSET(c, &mask)){
+            cpus.push_back(c);
+        }
+    }
+    int failed = 0;
+    #pragma omp parallel reduction(+:failed)
+    {
+        cpu_set_t own;
+        CPU_ZERO(&own);
+        CPU_SET(cpus[omp_get_thread_num() % cpus.size()], &own);
+        failed += sched_setaffinity(0, sizeof(own), &own) != 0;
+    }
+    if(failed > 0){
+        cout << "Warning : NUMA_PIN, " << failed << " threads could not be pinned !!!" << endl;
+    }
+    numa_pinned = failed == 0;
+    return numa_pinned;
+}
+
+void numa_print_binding(){
+    const int thread_count = omp_get_max_threads();
+    vector<int> place(thread_count, -1);
+    vector<int> cpu(thread_count, -1);
+    vector<int> node(thread_count, 0);
+    #pragma omp parallel
+    {
+        const int t = omp_get_thread_num();
+        place[t] = omp_get_place_num();
+        cpu[t] = sched_getcpu();
+        node[t] = numa_current_node();
+    }
+    cout << "numa binding ---------------" << endl;
+    cout << "thread count : " << thread_count << ", places : " << omp_get_num_places()
+         << ", proc bind : " << static_cast<int>(omp_get_proc_bind()) << ", pinned by NUMA_PIN : " << numa_pinned << endl;
+    if(omp_get_proc_bind() == omp_proc_bind_false && !numa_pinned){
+        cout << "Warning : threads are not bound (set OMP_PLACES / OMP_PROC_BIND or NUMA_PIN), first touch placement may be lost !!!" << endl;
+    }
+    for(int t = 0; t < thread_count; ++t){
+        cout << "thread " << t << " : place " << place[t] << ", cpu " << cpu[t] << ", node " << node[t] << endl;
+    }
+    cout << "----------------------------" << endl;
+}
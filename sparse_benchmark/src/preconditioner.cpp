@@ -0,0 +1,157 @@
+#include "preconditioner.hpp"
+
+PreconditionerType preconditioner_type_from_string(const string& name){
+    if(name == "none"){
+        return PRECONDITIONER_NONE;
+    }
+    if(name == "jacobi" || name == "diagonal"){
+        return PRECONDITIONER_JACOBI;
+    }
+    if(name == "dic" || name == "DIC"){
+        return PRECONDITIONER_DIC;
+    }
+    if(name == "dilu" || name == "DILU"){
+        return PRECONDITIONER_DILU;
+    }
+    if(name == "sgs" || name == "SGS"){
+        return PRECONDITIONER_SGS;
+    }
+    cerr << "unknown preconditioner : " << name << ", expect none, jacobi, dic, dilu or sgs" << endl;
+    throw std::invalid_argument("unknown preconditioner");
+}
+
+string preconditioner_type_to_string(PreconditionerType type){
+    switch(type){
+        case PRECONDITIONER_NONE : return "none";
+        case PRECONDITIONER_JACOBI : return "jacobi";
+        case PRECONDITIONER_DIC : return "dic";
+        case PRECONDITIONER_DILU : return "dilu";
+        case PRECONDITIONER_SGS : return "sgs";
+    }
+    return "unknown";
+}
+
+template <typename IndexType, typename ValueType>
+Preconditioner<IndexType, ValueType>::Preconditioner(const CSR<IndexType, ValueType>& A, PreconditionerType type, TriangularSchedule schedule)
+    :type_(type), A_(A), schedule_(schedule), triangular_(NULL){
+    if(A.row_ != A.col_){
+        cerr << "In Preconditioner<IndexType, ValueType>::Preconditioner(const CSR<IndexType, ValueType>& A, PreconditionerType type), matrix have to be square !!!" << endl;
+        throw std::invalid_argument("matrix is not square");
+    }
+    if(type_ == PRECONDITIONER_NONE){
+        return;
+    }
+    const IndexType n = A.row_;
+    const IndexType* rowptr = A.rowptr_.data();
+    const IndexType* colidx = A.colidx_.data();
+    const ValueType* value = A.value_.data();
+
+    diag_pos_.resize(n);
+    rD_.resize(n);
+    IndexType missing = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:missing)
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        const IndexType* pos = std::lower_bound(colidx + rowptr[i], colidx + rowptr[i+1], i);
+        if(pos == colidx + rowptr[i+1] || *pos != i || value[pos - colidx] == 0.){
+            missing += 1;
+            continue;
+        }
+        diag_pos_[i] = pos - colidx;
+        rD_[i] = value[diag_pos_[i]];
+    }
+    if(missing > 0){
+        cerr << "In Preconditioner<IndexType, ValueType>::Preconditioner(const CSR<IndexType, ValueType>& A, PreconditionerType type), "
+             << missing << " rows have no (nonzero) diagonal !!!" << endl;
+        throw std::invalid_argument("missing diagonal");
+    }
+
+    // D_i depends on D_j, j < i : serial in row order
+    if(type_ == PRECONDITIONER_DIC){
+        for(IndexType i = 0; i < n; ++i){
+            for(IndexType idx = rowptr[i]; idx < diag_pos_[i]; ++idx){
+                rD_[i] -= value[idx] * value[idx] / rD_[colidx[idx]];
+            }
+        }
+    }else if(type_ == PRECONDITIONER_DILU){
+        for(IndexType i = 0; i < n; ++i){
+            for(IndexType idx = rowptr[i]; idx < diag_pos_[i]; ++idx){
+                const IndexType j = colidx[idx];
+                // a_ji, upper part of row j
+                const IndexType* pos = std::lower_bound(colidx + diag_pos_[j] + 1, colidx + rowptr[j+1], i);
+                if(pos != colidx + rowptr[j+1] && *pos == i){
+                    rD_[i] -= value[idx] * value[pos - colidx] / rD_[j];
+                }
+            }
+        }
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        rD_[i] = 1. / rD_[i];
+    }
+
+    if(type_ != PRECONDITIONER_JACOBI){
+        triangular_ = new Triangular<IndexType, ValueType>(A);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void Preconditioner<IndexType, ValueType>::precondition(vector<ValueType>& w, const vector<ValueType>& r) const {
+    const IndexType n = A_.row_;
+    w.resize(n);
+    if(type_ == PRECONDITIONER_NONE){
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            w[i] = r[i];
+        }
+        return;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        w[i] = rD_[i] * r[i];
+    }
+    if(triangular_ != NULL){
+        // w_i -= rD_i * sum_{j<i} a_ij w_j, then w_i -= rD_i * sum_{j>i} a_ij w_j
+        triangular_->lower_solve(w.data(), w.data(), NULL, rD_.data(), schedule_);
+        triangular_->upper_solve(w.data(), w.data(), NULL, rD_.data(), schedule_);
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void Preconditioner<IndexType, ValueType>::smooth(vector<ValueType>& x, const vector<ValueType>& b, int sweeps,
+    vector<ValueType>& r, vector<ValueType>& w) const {
+    const IndexType n = A_.row_;
+    r.resize(n);
+    for(int sweep = 0; sweep < sweeps; ++sweep){
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            ValueType sum = 0.;
+            for(IndexType idx = A_.rowptr_[i]; idx < A_.rowptr_[i+1]; ++idx){
+                sum += A_.value_[idx] * x[A_.colidx_[idx]];
+            }
+            r[i] = b[i] - sum;
+        }
+        precondition(w, r);
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            x[i] += w[i];
+        }
+    }
+}
+
+template class Preconditioner<int32_t, float>;
+template class Preconditioner<int32_t, double>;
+template class Preconditioner<int64_t, float>;
+template class Preconditioner<int64_t, double>;
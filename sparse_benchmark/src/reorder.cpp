@@ -0,0 +1,420 @@
+#include "reorder.hpp"
+#include "parallel.hpp"
+
+ReorderMethod reorder_method_from_string(const string& name){
+    if(name == "none"){
+        return REORDER_NONE;
+    }
+    if(name == "rcm"){
+        return REORDER_RCM;
+    }
+    if(name == "bisection"){
+        return REORDER_BISECTION;
+    }
+    if(name == "multicolor"){
+        return REORDER_MULTICOLOR;
+    }
+    cerr << "unknown reorder method : " << name << ", expect none, rcm, bisection or multicolor" << endl;
+    throw std::invalid_argument("unknown reorder method");
+}
+
+string reorder_method_to_string(ReorderMethod method){
+    switch(method){
+        case REORDER_NONE : return "none";
+        case REORDER_RCM : return "rcm";
+        case REORDER_BISECTION : return "bisection";
+        case REORDER_MULTICOLOR : return "multicolor";
+    }
+    return "unknown";
+}
+
+// adjacency of A + A^T without the diagonal, sorted and unique per node
+template <typename IndexType>
+struct ReorderGraph{
+    IndexType node_count_;
+    vector<IndexType> ptr_;
+    vector<IndexType> adj_;
+
+    IndexType degree(IndexType v) const {return ptr_[v + 1] - ptr_[v];}
+};
+
+template <typename IndexType, typename ValueType>
+static ReorderGraph<IndexType> build_reorder_graph(const CSR<IndexType, ValueType>& csr){
+    if(csr.row_ != csr.col_){
+        cerr << "In build_reorder_graph(const CSR<IndexType, ValueType>& csr), matrix have to be square !!!" << endl;
+        throw std::invalid_argument("matrix is not square");
+    }
+    const IndexType n = csr.row_;
+    ReorderGraph<IndexType> g;
+    g.node_count_ = n;
+
+    // count both directions, duplicates are removed below
+    vector<IndexType> cursor(n + 1, 0);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType r = 0; r < n; ++r){
+        for(IndexType idx = csr.rowptr_[r]; idx < csr.rowptr_[r+1]; ++idx){
+            IndexType c = csr.colidx_[idx];
+            if(c == r) continue;
+            #pragma omp atomic
+            cursor[r] += 1;
+            #pragma omp atomic
+            cursor[c] += 1;
+        }
+    }
+    parallel_exclusive_scan(cursor.data(), static_cast<int64_t>(n) + 1);
+    vector<IndexType> start(cursor);
+    vector<IndexType> adj(cursor[n]);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType r = 0; r < n; ++r){
+        for(IndexType idx = csr.rowptr_[r]; idx < csr.rowptr_[r+1]; ++idx){
+            IndexType c = csr.colidx_[idx];
+            if(c == r) continue;
+            IndexType pos;
+            #pragma omp atomic capture
+            pos = cursor[r]++;
+            adj[pos] = c;
+            #pragma omp atomic capture
+            pos = cursor[c]++;
+            adj[pos] = r;
+        }
+    }
+
+    // sort + unique per node, then compact
+    g.ptr_.resize(n + 1);
+    g.ptr_[n] = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType v = 0; v < n; ++v){
+        std::sort(adj.begin() + start[v], adj.begin() + start[v + 1]);
+        g.ptr_[v] = std::unique(adj.begin() + start[v], adj.begin() + start[v + 1]) - (adj.begin() + start[v]);
+    }
+    parallel_exclusive_scan(g.ptr_.data(), static_cast<int64_t>(n) + 1);
+    g.adj_.resize(g.ptr_[n]);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType v = 0; v < n; ++v){
+        std::copy(adj.begin() + start[v], adj.begin() + start[v] + g.degree(v), g.adj_.begin() + g.ptr_[v]);
+    }
+    return g;
+}
+
+// Cuthill-McKee ordering of the nodes with part[v] == p
+// mark_ / placed_ hold stamps, so nothing is cleared between searches
+template <typename IndexType>
+class CuthillMcKee{
+private:
+    const ReorderGraph<IndexType>& g_;
+    vector<IndexType> mark_;
+    vector<IndexType> placed_;
+    IndexType stamp_;
+
+    // breadth first search from start, neighbours in increasing degree order
+    // appends to order, returns the level count, last_level = first node of the last level
+    IndexType bfs(IndexType start, const IndexType* part, IndexType p, vector<IndexType>& order, size_t& last_level){
+        const IndexType stamp = ++stamp_;
+        const size_t begin = order.size();
+        order.push_back(start);
+        mark_[start] = stamp;
+        size_t level_begin = begin;
+        size_t level_end = order.size();
+        IndexType level_count = 0;
+        while(level_begin < level_end){
+            ++level_count;
+            last_level = level_begin;
+            for(size_t i = level_begin; i < level_end; ++i){
+                IndexType v = order[i];
+                size_t first = order.size();
+                for(IndexType idx = g_.ptr_[v]; idx < g_.ptr_[v + 1]; ++idx){
+                    IndexType w = g_.adj_[idx];
+                    if(part[w] != p || mark_[w] == stamp) continue;
+                    mark_[w] = stamp;
+                    order.push_back(w);
+                }
+                std::sort(order.begin() + first, order.end(), [this](IndexType a, IndexType b){
+                    return g_.degree(a) < g_.degree(b) || (g_.degree(a) == g_.degree(b) && a < b);
+                });
+            }
+            level_begin = level_end;
+            level_end = order.size();
+        }
+        return level_count;
+    }
+
+    // George-Liu : restart from a minimum degree node of the last level
+    // while the eccentricity grows
+    IndexType pseudo_peripheral(IndexType start, const IndexType* part, IndexType p, vector<IndexType>& scratch){
+        size_t last_level = 0;
+        scratch.clear();
+        IndexType eccentricity = bfs(start, part, p, scratch, last_level);
+        while(true){
+            IndexType candidate = scratch[last_level];
+            for(size_t i = last_level; i < scratch.size(); ++i){
+                if(g_.degree(scratch[i]) < g_.degree(candidate)){
+                    candidate = scratch[i];
+                }
+            }
+            scratch.clear();
+            IndexType candidate_eccentricity = bfs(candidate, part, p, scratch, last_level);
+            if(candidate_eccentricity <= eccentricity){
+                return start;
+            }
+            start = candidate;
+            eccentricity = candidate_eccentricity;
+        }
+    }
+
+public:
+    CuthillMcKee(const ReorderGraph<IndexType>& g):g_(g), mark_(g.node_count_, 0), placed_(g.node_count_, 0), stamp_(0){}
+
+    // orders nodes [begin, end) (all with part[v] == p) in place, one search per connected component
+    void order(IndexType* begin, IndexType* end, const IndexType* part, IndexType p){
+        const IndexType placed = ++stamp_;
+        vector<IndexType> order;
+        vector<IndexType> scratch;
+        order.reserve(end - begin);
+        // low degree nodes first, they are good start candidates
+        vector<IndexType> candidate(begin, end);
+        std::sort(candidate.begin(), candidate.end(), [this](IndexType a, IndexType b){
+            return g_.degree(a) < g_.degree(b) || (g_.degree(a) == g_.degree(b) && a < b);
+        });
+        for(IndexType v : candidate){
+            if(placed_[v] == placed) continue;
+            IndexType start = pseudo_peripheral(v, part, p, scratch);
+            size_t component_begin = order.size();
+            size_t last_level = 0;
+            bfs(start, part, p, order, last_level);
+            for(size_t i = component_begin; i < order.size(); ++i){
+                placed_[order[i]] = placed;
+            }
+        }
+        std::copy(order.begin(), order.end(), begin);
+    }
+};
+
+template <typename IndexType, typename ValueType>
+vector<IndexType> rcm_ordering(const CSR<IndexType, ValueType>& csr){
+    ReorderGraph<IndexType> g = build_reorder_graph(csr);
+    vector<IndexType> part(g.node_count_, 0);
+    vector<IndexType> perm(g.node_count_);
+    for(IndexType v = 0; v < g.node_count_; ++v){
+        perm[v] = v;
+    }
+    CuthillMcKee<IndexType> cm(g);
+    cm.order(perm.data(), perm.data() + g.node_count_, part.data(), 0);
+    std::reverse(perm.begin(), perm.end());
+    return perm;
+}
+
+// split the level structure of each part at its middle until parts have at
+// most part_size nodes, leaves are RCM ordered, so the x entries touched by
+// one part stay close together
+// part[v] is the first position of the part of v in perm
+template <typename IndexType, typename ValueType>
+vector<IndexType> bisection_ordering(const CSR<IndexType, ValueType>& csr, IndexType part_size){
+    if(part_size < 1){
+        cerr << "In bisection_ordering(const CSR<IndexType, ValueType>& csr, IndexType part_size), part_size have to be positive !!!" << endl;
+        throw std::invalid_argument("part_size is not positive");
+    }
+    ReorderGraph<IndexType> g = build_reorder_graph(csr);
+    const IndexType n = g.node_count_;
+    vector<IndexType> part(n, 0);
+    vector<IndexType> perm(n);
+    for(IndexType v = 0; v < n; ++v){
+        perm[v] = v;
+    }
+    CuthillMcKee<IndexType> cm(g);
+
+    vector<std::pair<IndexType, IndexType>> stack;
+    stack.push_back(std::make_pair(static_cast<IndexType>(0), n));
+    while(!stack.empty()){
+        IndexType begin = stack.back().first;
+        IndexType end = stack.back().second;
+        stack.pop_back();
+        cm.order(perm.data() + begin, perm.data() + end, part.data(), begin);
+        if(end - begin <= part_size){
+            std::reverse(perm.begin() + begin, perm.begin() + end);
+            continue;
+        }
+        IndexType middle = begin + (end - begin) / 2;
+        for(IndexType i = middle; i < end; ++i){
+            part[perm[i]] = middle;
+        }
+        stack.push_back(std::make_pair(middle, end));
+        stack.push_back(std::make_pair(begin, middle));
+    }
+    return perm;
+}
+
+// colour of a node is the smallest one none of its (already coloured)
+// neighbours has, mark[c] == v flags colour c as taken for node v
+template <typename IndexType, typename ValueType>
+vector<IndexType> multicolor_ordering(const CSR<IndexType, ValueType>& csr, IndexType& color_count){
+    ReorderGraph<IndexType> g = build_reorder_graph(csr);
+    const IndexType n = g.node_count_;
+    vector<IndexType> color(n, -1);
+    vector<IndexType> mark;
+    color_count = 0;
+    for(IndexType v = 0; v < n; ++v){
+        for(IndexType idx = g.ptr_[v]; idx < g.ptr_[v + 1]; ++idx){
+            IndexType c = color[g.adj_[idx]];
+            if(c >= 0){
+                mark[c] = v;
+            }
+        }
+        IndexType c = 0;
+        while(c < color_count && mark[c] == v){
+            ++c;
+        }
+        if(c == color_count){
+            color_count += 1;
+            mark.push_back(-1);
+        }
+        color[v] = c;
+    }
+
+    // stable counting sort by colour
+    vector<IndexType> cursor(color_count + 1, 0);
+    for(IndexType v = 0; v < n; ++v){
+        cursor[color[v] + 1] += 1;
+    }
+    for(IndexType c = 0; c < color_count; ++c){
+        cursor[c + 1] += cursor[c];
+    }
+    vector<IndexType> perm(n);
+    for(IndexType v = 0; v < n; ++v){
+        perm[cursor[color[v]]++] = v;
+    }
+    return perm;
+}
+
+template <typename IndexType, typename ValueType>
+COO<IndexType, ValueType> permute_symmetric(const CSR<IndexType, ValueType>& csr, const vector<IndexType>& perm){
+    if(static_cast<int64_t>(perm.size()) != static_cast<int64_t>(csr.row_) || csr.row_ != csr.col_){
+        cerr << "In permute_symmetric(const CSR<IndexType, ValueType>& csr, const vector<IndexType>& perm), perm size have to match the square matrix !!!" << endl;
+        throw std::invalid_argument("perm size mismatch");
+    }
+    const IndexType n = csr.row_;
+    vector<IndexType> inverse(n);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        inverse[perm[i]] = i;
+    }
+    vector<IndexType> rowidx(csr.nnz_);
+    vector<IndexType> colidx(csr.nnz_);
+    vector<ValueType> value(csr.nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType r = 0; r < n; ++r){
+        for(IndexType idx = csr.rowptr_[r]; idx < csr.rowptr_[r+1]; ++idx){
+            rowidx[idx] = inverse[r];
+            colidx[idx] = inverse[csr.colidx_[idx]];
+            value[idx] = csr.value_[idx];
+        }
+    }
+    return COO<IndexType, ValueType>(n, n, csr.nnz_, std::move(rowidx), std::move(colidx), std::move(value));
+}
+
+template <typename IndexType, typename ValueType>
+void bandwidth_profile(const CSR<IndexType, ValueType>& csr, IndexType& bandwidth, double& profile){
+    IndexType max_distance = 0;
+    double envelope = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(max:max_distance) reduction(+:envelope)
+#endif
+    for(IndexType r = 0; r < csr.row_; ++r){
+        IndexType first = r;
+        for(IndexType idx = csr.rowptr_[r]; idx < csr.rowptr_[r+1]; ++idx){
+            IndexType c = csr.colidx_[idx];
+            max_distance = std::max(max_distance, c > r ? c - r : r - c);
+            first = std::min(first, c);
+        }
+        envelope += r - first;
+    }
+    bandwidth = max_distance;
+    profile = envelope;
+}
+
+template <typename IndexType, typename ValueType>
+CSR<IndexType, ValueType> reorder(const CSR<IndexType, ValueType>& csr, ReorderMethod method, IndexType part_size){
+    omp_timer timer;
+    vector<IndexType> perm;
+    IndexType color_count = 0;
+    switch(method){
+        case REORDER_RCM : perm = rcm_ordering(csr); break;
+        case REORDER_BISECTION : perm = bisection_ordering(csr, part_size); break;
+        case REORDER_MULTICOLOR : perm = multicolor_ordering(csr, color_count); break;
+        case REORDER_NONE :
+            perm.resize(csr.row_);
+            for(IndexType i = 0; i < csr.row_; ++i){
+                perm[i] = i;
+            }
+            break;
+    }
+    double ordering_time = timer.timeIncrement();
+
+    COO<IndexType, ValueType> coo = permute_symmetric(csr, perm);
+    coo.sort();
+    CSR<IndexType, ValueType> ret(coo);
+    double permute_time = timer.timeIncrement();
+
+    IndexType bandwidth_before, bandwidth_after;
+    double profile_before, profile_after;
+    bandwidth_profile(csr, bandwidth_before, profile_before);
+    bandwidth_profile(ret, bandwidth_after, profile_after);
+
+    cout << "reorder --------------------" << endl;
+    cout << "method : " << reorder_method_to_string(method) << endl;
+    if(method == REORDER_BISECTION){
+        cout << "part size : " << part_size << endl;
+    }
+    if(method == REORDER_MULTICOLOR){
+        cout << "color count : " << color_count << endl;
+    }
+    cout << "ordering time : " << ordering_time << endl;
+    cout << "permute + sort + coo -> csr time : " << permute_time << endl;
+    cout << "bandwidth before : " << bandwidth_before << ", after : " << bandwidth_after << endl;
+    cout << "profile before : " << profile_before << ", after : " << profile_after << endl;
+    // x entries one row can reach, what has to stay in cache between rows
+    cout << "x window after (2 * bandwidth * sizeof value) : " << 2. * bandwidth_after * sizeof(ValueType) / 1024. << " KiB" << endl;
+    cout << "----------------------------" << endl;
+    return ret;
+}
+
+template vector<int32_t> rcm_ordering(const CSR<int32_t, float>& csr);
+template vector<int32_t> rcm_ordering(const CSR<int32_t, double>& csr);
+template vector<int64_t> rcm_ordering(const CSR<int64_t, float>& csr);
+template vector<int64_t> rcm_ordering(const CSR<int64_t, double>& csr);
+
+template vector<int32_t> bisection_ordering(const CSR<int32_t, float>& csr, int32_t part_size);
+template vector<int32_t> bisection_ordering(const CSR<int32_t, double>& csr, int32_t part_size);
+template vector<int64_t> bisection_ordering(const CSR<int64_t, float>& csr, int64_t part_size);
+template vector<int64_t> bisection_ordering(const CSR<int64_t, double>& csr, int64_t part_size);
+
+template vector<int32_t> multicolor_ordering(const CSR<int32_t, float>& csr, int32_t& color_count);
+template vector<int32_t> multicolor_ordering(const CSR<int32_t, double>& csr, int32_t& color_count);
+template vector<int64_t> multicolor_ordering(const CSR<int64_t, float>& csr, int64_t& color_count);
+template vector<int64_t> multicolor_ordering(const CSR<int64_t, double>& csr, int64_t& color_count);
+
+template COO<int32_t, float> permute_symmetric(const CSR<int32_t, float>& csr, const vector<int32_t>& perm);
+template COO<int32_t, double> permute_symmetric(const CSR<int32_t, double>& csr, const vector<int32_t>& perm);
+template COO<int64_t, float> permute_symmetric(const CSR<int64_t, float>& csr, const vector<int64_t>& perm);
+template COO<int64_t, double> permute_symmetric(const CSR<int64_t, double>& csr, const vector<int64_t>& perm);
+
+template void bandwidth_profile(const CSR<int32_t, float>& csr, int32_t& bandwidth, double& profile);
+template void bandwidth_profile(const CSR<int32_t, double>& csr, int32_t& bandwidth, double& profile);
+template void bandwidth_profile(const CSR<int64_t, float>& csr, int64_t& bandwidth, double& profile);
+template void bandwidth_profile(const CSR<int64_t, double>& csr, int64_t& bandwidth, double& profile);
+
+template CSR<int32_t, float> reorder(const CSR<int32_t, float>& csr, ReorderMethod method, int32_t part_size);
+template CSR<int32_t, double> reorder(const CSR<int32_t, double>& csr, ReorderMethod method, int32_t part_size);
+template CSR<int64_t, float> reorder(const CSR<int64_t, float>& csr, ReorderMethod method, int64_t part_size);
+template CSR<int64_t, double> reorder(const CSR<int64_t, double>& csr, ReorderMethod method, int64_t part_size);
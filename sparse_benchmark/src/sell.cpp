@@ -0,0 +1,116 @@
+#include "sell.hpp"
+
+template<typename IndexType, typename ValueType>
+SELL<IndexType, ValueType>::SELL(const CSR<IndexType,ValueType>& csr, IndexType sigma)
+    :chunk_size_(SELL_CHUNK), sigma_(sigma){
+    build(csr);
+}
+
+template<typename IndexType, typename ValueType>
+SELL<IndexType, ValueType>::SELL(const COO<IndexType,ValueType>& coo, IndexType sigma)
+    :chunk_size_(SELL_CHUNK), sigma_(sigma){
+    CSR<IndexType,ValueType> csr(coo);
+    build(csr);
+}
+
+template<typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::build(const CSR<IndexType,ValueType>& csr){
+    if(sigma_ < chunk_size_ || sigma_ % chunk_size_ != 0){
+        cerr << "In SELL<IndexType, ValueType>::build, sigma have to be a multiple of chunk size " << chunk_size_ << " !!!" << endl;
+        throw std::invalid_argument("sigma is not a multiple of chunk size");
+    }
+
+    row_ = csr.row_;
+    col_ = csr.col_;
+    nnz_ = csr.nnz_;
+    chunk_count_ = (row_ + chunk_size_ - 1) / chunk_size_;
+
+    // sort rows by length (descending) inside each sigma window
+    perm_.resize(row_);
+    for(IndexType r = 0; r < row_; ++r){
+        perm_[r] = r;
+    }
+    const numa_vector<IndexType>& rowptr = csr.rowptr_;
+    auto longer = [&rowptr](IndexType a, IndexType b){
+        return rowptr[a + 1] - rowptr[a] > rowptr[b + 1] - rowptr[b];
+    };
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType ws = 0; ws < row_; ws += sigma_){
+        IndexType we = std::min(ws + sigma_, row_);
+        std::stable_sort(perm_.begin() + ws, perm_.begin() + we, longer);
+    }
+
+    // chunk width = longest row of the chunk
+    chunk_len_.resize(chunk_count_);
+    chunk_ptr_.resize(chunk_count_ + 1);
+    chunk_ptr_[0] = 0;
+    for(IndexType c = 0; c < chunk_count_; ++c){
+        IndexType len = 0;
+        IndexType rs = c * chunk_size_;
+        IndexType re = std::min(rs + chunk_size_, row_);
+        for(IndexType sr = rs; sr < re; ++sr){
+            IndexType r = perm_[sr];
+            len = std::max(len, rowptr[r + 1] - rowptr[r]);
+        }
+        chunk_len_[c] = len;
+        chunk_ptr_[c + 1] = chunk_ptr_[c] + len * chunk_size_;
+    }
+    padded_nnz_ = chunk_ptr_[chunk_count_];
+
+    // fill column major chunks, padding uses value 0 and a valid column
+    colidx_.resize(padded_nnz_);
+    value_.resize(padded_nnz_);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType c = 0; c < chunk_count_; ++c){
+        IndexType base = chunk_ptr_[c];
+        for(IndexType lane = 0; lane < chunk_size_; ++lane){
+            IndexType sr = c * chunk_size_ + lane;
+            IndexType rs = 0, rl = 0;
+            if(sr < row_){
+                IndexType r = perm_[sr];
+                rs = rowptr[r];
+                rl = rowptr[r + 1] - rs;
+            }
+            IndexType pad_col = rl > 0 ? csr.colidx_[rs + rl - 1] : 0;
+            for(IndexType j = 0; j < chunk_len_[c]; ++j){
+                IndexType idx = base + j * chunk_size_ + lane;
+                if(j < rl){
+                    colidx_[idx] = csr.colidx_[rs + j];
+                    value_[idx] = csr.value_[rs + j];
+                }else{
+                    colidx_[idx] = pad_col;
+                    value_[idx] = 0.;
+                }
+            }
+        }
+    }
+}
+
+template<typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::print_info(){
+    cout << "SELL-C-sigma" << endl;
+    cout << "row : " << row_ << endl;
+    cout << "col : " << col_ << endl;
+    cout << "nnz : " << nnz_ << endl;
+    cout << "C : " << chunk_size_ << endl;
+    cout << "sigma : " << sigma_ << endl;
+    cout << "chunk count : " << chunk_count_ << endl;
+    cout << "padded nnz : " << padded_nnz_ << endl;
+    cout << "fill efficiency (nnz / padded nnz) : " << (padded_nnz_ > 0 ? static_cast<double>(nnz_) / padded_nnz_ : 1.) << endl;
+}
+
+// chunk_ptr_ + chunk_len_ + perm_ on top of the padded slices
+template<typename IndexType, typename ValueType>
+double SELL<IndexType, ValueType>::matrix_bytes() const {
+    return static_cast<double>(padded_nnz_) * (sizeof(IndexType) + sizeof(ValueType))
+        + (2. * chunk_count_ + 1. + row_) * sizeof(IndexType);
+}
+
+template class SELL<int32_t, float>;
+template class SELL<int32_t, double>;
+template class SELL<int64_t, float>;
+template class SELL<int64_t, double>;
@@ -0,0 +1,74 @@
+#include "sell.hpp"
+#include "spmm.hpp"
+#include "benchmark.hpp"
+
+template <typename IndexType, typename ValueType, int K>
+static void sell_spmm_kernel(const SELL<IndexType, ValueType>& A, ValueType* Y, const ValueType* X, int k){
+    const int width = K > 0 ? K : k;
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType c = 0; c < A.chunk_count_; ++c){
+        const IndexType* colidx = A.colidx_.data() + A.chunk_ptr_[c];
+        const ValueType* value = A.value_.data() + A.chunk_ptr_[c];
+        const IndexType rs = c * SELL_CHUNK;
+        const IndexType re = std::min(rs + SELL_CHUNK, A.row_);
+        for(int j0 = 0; j0 < width; j0 += SPMM_MAX_K){
+            const int kt = K > 0 ? K : std::min(SPMM_MAX_K, width - j0);
+            ValueType sum[SELL_CHUNK][K > 0 ? K : SPMM_MAX_K];
+            for(int lane = 0; lane < SELL_CHUNK; ++lane){
+                for(int j = 0; j < kt; ++j){
+                    sum[lane][j] = 0.;
+                }
+            }
+            for(IndexType jj = 0; jj < A.chunk_len_[c]; ++jj){
+                for(int lane = 0; lane < SELL_CHUNK; ++lane){
+                    const ValueType v = value[jj * SELL_CHUNK + lane];
+                    const ValueType* xr = X + static_cast<int64_t>(colidx[jj * SELL_CHUNK + lane]) * width + j0;
+                    #pragma omp simd
+                    for(int j = 0; j < kt; ++j){
+                        sum[lane][j] += v * xr[j];
+                    }
+                }
+            }
+            for(IndexType sr = rs; sr < re; ++sr){
+                ValueType* yr = Y + static_cast<int64_t>(A.perm_[sr]) * width + j0;
+                for(int j = 0; j < kt; ++j){
+                    yr[j] = sum[sr - rs][j];
+                }
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::SpMM(vector<ValueType>& Y, const vector<ValueType>& X, int k){
+    assert(static_cast<int64_t>(X.size()) >= static_cast<int64_t>(col_) * k);
+    assert(static_cast<int64_t>(Y.size()) >= static_cast<int64_t>(row_) * k);
+#define SELL_SPMM_KERNEL(K) sell_spmm_kernel<IndexType, ValueType, K>(*this, Y.data(), X.data(), k)
+    SPMM_DISPATCH(k, SELL_SPMM_KERNEL)
+#undef SELL_SPMM_KERNEL
+}
+
+template <typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::spmm_benchmark(int k){
+    vector<ValueType> X = benchmark_block<ValueType>(col_, k);
+    vector<ValueType> Y(static_cast<int64_t>(row_) * k, 0.);
+    vector<vector<ValueType>> x = benchmark_columns<ValueType>(col_, k);
+    vector<vector<ValueType>> y(k, vector<ValueType>(row_, 0.));
+    double vector_bytes = (static_cast<double>(row_) + col_) * sizeof(ValueType);
+    spmm_benchmark_run("sell", precision_info<IndexType, ValueType>(), 2. * nnz_, k, matrix_bytes(), vector_bytes,
+        [&](){ SpMM(Y, X, k); },
+        [&](){
+            for(int j = 0; j < k; ++j){
+                SpMV(y[j], x[j]);
+            }
+        },
+        [&](){ return benchmark_residual_block(Y, k); },
+        [&](){ return benchmark_residual_block(y); }, benchmark_tolerance<ValueType>());
+}
+
+template class SELL<int32_t, float>;
+template class SELL<int32_t, double>;
+template class SELL<int64_t, float>;
+template class SELL<int64_t, double>;
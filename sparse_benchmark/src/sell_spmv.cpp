@@ -0,0 +1,169 @@
+#include "sell.hpp"
+#include "benchmark.hpp"
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+template <typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::spmv_benchmark(){
+    // init x y
+    vector<ValueType> x = benchmark_vector<ValueType>(col_);
+    vector<ValueType> y(row_, 0.);
+    spmv_benchmark_run("sell spmv", precision_info<IndexType, ValueType>() + "\nC : " + std::to_string(chunk_size_) + ", sigma : " + std::to_string(sigma_),
+        2. * nnz_, matrix_bytes() + (static_cast<double>(row_) + col_) * sizeof(ValueType), [&](){ SpMV(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
+
+template <typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::spmv_benchmark_mixed(){
+    vector<double> x = benchmark_vector<double>(col_);
+    vector<double> y(row_, 0.);
+    spmv_benchmark_run("sell spmv mixed", precision_info<IndexType, ValueType>() + ", vector / accumulate : double",
+        2. * nnz_, matrix_bytes() + (static_cast<double>(row_) + col_) * sizeof(double), [&](){ SpMV_mixed(y, x); },
+        [&](){ return benchmark_residual(y); }, benchmark_tolerance<ValueType>());
+}
+
+// portable kernel, the lane loop is left to the compiler (SVE, NEON, ...)
+template <typename IndexType, typename ValueType, typename VectorType>
+static void sell_spmv_portable(const SELL<IndexType, ValueType>& A, VectorType* y, const VectorType* x){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType c = 0; c < A.chunk_count_; ++c){
+        VectorType sum[SELL_CHUNK];
+        for(int lane = 0; lane < SELL_CHUNK; ++lane){
+            sum[lane] = 0.;
+        }
+        const IndexType* colidx = A.colidx_.data() + A.chunk_ptr_[c];
+        const ValueType* value = A.value_.data() + A.chunk_ptr_[c];
+        for(IndexType j = 0; j < A.chunk_len_[c]; ++j){
+            #pragma omp simd
+            for(int lane = 0; lane < SELL_CHUNK; ++lane){
+                sum[lane] += static_cast<VectorType>(value[j * SELL_CHUNK + lane]) * x[colidx[j * SELL_CHUNK + lane]];
+            }
+        }
+        IndexType rs = c * SELL_CHUNK;
+        IndexType re = std::min(rs + SELL_CHUNK, A.row_);
+        for(IndexType sr = rs; sr < re; ++sr){
+            y[A.perm_[sr]] = sum[sr - rs];
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+static void sell_spmv_simd(const SELL<IndexType, ValueType>& A, ValueType* y, const ValueType* x){
+    sell_spmv_portable(A, y, x);
+}
+
+#if defined(__AVX512F__)
+template <>
+void sell_spmv_simd<int64_t, double>(const SELL<int64_t, double>& A, double* y, const double* x){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int64_t c = 0; c < A.chunk_count_; ++c){
+        __m512d sum = _mm512_setzero_pd();
+        const int64_t* colidx = A.colidx_.data() + A.chunk_ptr_[c];
+        const double* value = A.value_.data() + A.chunk_ptr_[c];
+        for(int64_t j = 0; j < A.chunk_len_[c]; ++j){
+            __m512i vidx = _mm512_loadu_si512(colidx + j * 8);
+            __m512d vx = _mm512_i64gather_pd(vidx, x, 8);
+            sum = _mm512_fmadd_pd(_mm512_loadu_pd(value + j * 8), vx, sum);
+        }
+        double out[8];
+        _mm512_storeu_pd(out, sum);
+        int64_t rs = c * 8;
+        int64_t re = std::min(rs + 8, A.row_);
+        for(int64_t sr = rs; sr < re; ++sr){
+            y[A.perm_[sr]] = out[sr - rs];
+        }
+    }
+}
+
+template <>
+void sell_spmv_simd<int32_t, double>(const SELL<int32_t, double>& A, double* y, const double* x){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int32_t c = 0; c < A.chunk_count_; ++c){
+        __m512d sum = _mm512_setzero_pd();
+        const int32_t* colidx = A.colidx_.data() + A.chunk_ptr_[c];
+        const double* value = A.value_.data() + A.chunk_ptr_[c];
+        for(int32_t j = 0; j < A.chunk_len_[c]; ++j){
+            __m256i vidx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colidx + j * 8));
+            __m512d vx = _mm512_i32gather_pd(vidx, x, 8);
+            sum = _mm512_fmadd_pd(_mm512_loadu_pd(value + j * 8), vx, sum);
+        }
+        double out[8];
+        _mm512_storeu_pd(out, sum);
+        int32_t rs = c * 8;
+        int32_t re = std::min(rs + 8, A.row_);
+        for(int32_t sr = rs; sr < re; ++sr){
+            y[A.perm_[sr]] = out[sr - rs];
+        }
+    }
+}
+#elif defined(__AVX2__) && defined(__FMA__)
+template <>
+void sell_spmv_simd<int64_t, double>(const SELL<int64_t, double>& A, double* y, const double* x){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int64_t c = 0; c < A.chunk_count_; ++c){
+        __m256d sum = _mm256_setzero_pd();
+        const int64_t* colidx = A.colidx_.data() + A.chunk_ptr_[c];
+        const double* value = A.value_.data() + A.chunk_ptr_[c];
+        for(int64_t j = 0; j < A.chunk_len_[c]; ++j){
+            __m256i vidx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(colidx + j * 4));
+            __m256d vx = _mm256_i64gather_pd(x, vidx, 8);
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(value + j * 4), vx, sum);
+        }
+        double out[4];
+        _mm256_storeu_pd(out, sum);
+        int64_t rs = c * 4;
+        int64_t re = std::min(rs + 4, A.row_);
+        for(int64_t sr = rs; sr < re; ++sr){
+            y[A.perm_[sr]] = out[sr - rs];
+        }
+    }
+}
+
+template <>
+void sell_spmv_simd<int32_t, double>(const SELL<int32_t, double>& A, double* y, const double* x){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(int32_t c = 0; c < A.chunk_count_; ++c){
+        __m256d sum = _mm256_setzero_pd();
+        const int32_t* colidx = A.colidx_.data() + A.chunk_ptr_[c];
+        const double* value = A.value_.data() + A.chunk_ptr_[c];
+        for(int32_t j = 0; j < A.chunk_len_[c]; ++j){
+            __m128i vidx = _mm_loadu_si128(reinterpret_cast<const __m128i*>(colidx + j * 4));
+            __m256d vx = _mm256_i32gather_pd(x, vidx, 8);
+            sum = _mm256_fmadd_pd(_mm256_loadu_pd(value + j * 4), vx, sum);
+        }
+        double out[4];
+        _mm256_storeu_pd(out, sum);
+        int32_t rs = c * 4;
+        int32_t re = std::min(rs + 4, A.row_);
+        for(int32_t sr = rs; sr < re; ++sr){
+            y[A.perm_[sr]] = out[sr - rs];
+        }
+    }
+}
+#endif
+
+template <typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueType>& x){
+    sell_spmv_simd(*this, y.data(), x.data());
+}
+
+template <typename IndexType, typename ValueType>
+void SELL<IndexType, ValueType>::SpMV_mixed(vector<double>& y, const vector<double>& x){
+    sell_spmv_portable(*this, y.data(), x.data());
+}
+
+template class SELL<int32_t, float>;
+template class SELL<int32_t, double>;
+template class SELL<int64_t, float>;
+template class SELL<int64_t, double>;
@@ -0,0 +1,576 @@
+#include "solver.hpp"
+#include "amg.hpp"
+#include "benchmark.hpp"
+
+#define SOLVER_SMALL 1e-20
+#define SOLVER_VSMALL 1e-300
+
+SolverType solver_type_from_string(const string& name){
+    if(name == "pcg" || name == "PCG"){
+        return SOLVER_PCG;
+    }
+    if(name == "pbicgstab" || name == "PBiCGStab"){
+        return SOLVER_PBICGSTAB;
+    }
+    if(name == "gamg" || name == "GAMG"){
+        return SOLVER_GAMG;
+    }
+    cerr << "unknown solver : " << name << ", expect pcg, pbicgstab or gamg" << endl;
+    throw std::invalid_argument("unknown solver");
+}
+
+string solver_type_to_string(SolverType type){
+    switch(type){
+        case SOLVER_PCG : return "pcg";
+        case SOLVER_PBICGSTAB : return "pbicgstab";
+        case SOLVER_GAMG : return "gamg";
+    }
+    return "unknown";
+}
+
+void SolverPerformance::print() const {
+    const double time_other = time_total_ - time_spmv_ - time_precondition_ - time_reduction_;
+    cout << solver_ << " solver -------------" << endl;
+    cout << "thread count : " << omp_get_max_threads() << endl;
+    cout << "preconditioner : " << preconditioner_ << endl;
+    cout << "iterations : " << iterations_ << ", converged : " << converged_ << endl;
+    cout << "initial residual : " << initial_residual_ << ", final residual : " << final_residual_ << endl;
+    cout << "time total : " << time_total_ << endl;
+    cout << "time spmv : " << time_spmv_ << " (" << 100. * time_spmv_ / time_total_ << "%), count : " << spmv_count_ << endl;
+    cout << "time precondition : " << time_precondition_ << " (" << 100. * time_precondition_ / time_total_ << "%), count : " << precondition_count_ << endl;
+    cout << "time reduction + update : " << time_reduction_ << " (" << 100. * time_reduction_ / time_total_ << "%)" << endl;
+    cout << "time other : " << time_other << endl;
+    cout << "----------------------------" << endl;
+}
+
+bool solver_converged(const SolverControl& control, double initial, double residual){
+    return residual < control.tolerance_ || (control.rel_tol_ > 0. && residual < control.rel_tol_ * initial);
+}
+
+template <typename ValueType>
+static double sum_prod(const vector<ValueType>& a, const vector<ValueType>& b){
+    const int64_t n = a.size();
+    double sum = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:sum)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        sum += static_cast<double>(a[i]) * b[i];
+    }
+    return sum;
+}
+
+template <typename MatrixType, typename VectorType>
+double solver_initial_residual(const MatrixType& A, const vector<VectorType>& x, const vector<VectorType>& yA,
+    const vector<VectorType>& b, vector<VectorType>& r, double& norm_factor){
+    const int64_t n = A.row_;
+    double x_sum = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:x_sum)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        x_sum += x[i];
+    }
+    const double x_ref = n > 0 ? x_sum / n : 0.;
+
+    double factor = 0.;
+    double residual = 0.;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:factor, residual)
+#endif
+    for(int64_t i = 0; i < n; ++i){
+        double row_sum = 0.;
+        for(int64_t idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+            row_sum += A.value_[idx];
+        }
+        const double pA = x_ref * row_sum;
+        factor += std::abs(yA[i] - pA) + std::abs(b[i] - pA);
+        r[i] = b[i] - yA[i];
+        residual += std::abs(static_cast<double>(r[i]));
+    }
+    norm_factor = factor + SOLVER_SMALL;
+    return residual;
+}
+
+template <typename MatrixType, typename IndexType, typename ValueType>
+SolverPerformance pcg_solve(MatrixType& A, const Preconditioner<IndexType, ValueType>& M,
+    vector<ValueType>& x, const vector<ValueType>& b, const SolverControl& control){
+    const IndexType n = A.row_;
+    SolverPerformance perf = {"pcg", preconditioner_type_to_string(M.type()), 0, 0., 0., false, 0, 0, 0., 0., 0., 0.};
+    const double start = omp_get_wtime();
+    double t;
+
+    vector<ValueType> wA(n);
+    vector<ValueType> rA(n);
+    vector<ValueType> pA(n);
+
+    t = omp_get_wtime();
+    A.SpMV(wA, x);
+    perf.time_spmv_ += omp_get_wtime() - t;
+    perf.spmv_count_ += 1;
+
+    t = omp_get_wtime();
+    double norm_factor;
+    perf.initial_residual_ = solver_initial_residual(A, x, wA, b, rA, norm_factor) / norm_factor;
+    perf.final_residual_ = perf.initial_residual_;
+    perf.time_reduction_ += omp_get_wtime() - t;
+
+    double wArA = 0.;
+    while(perf.iterations_ < control.max_iter_ && !solver_converged(control, perf.initial_residual_, perf.final_residual_)){
+        const double wArA_old = wArA;
+
+        t = omp_get_wtime();
+        M.precondition(wA, rA);
+        perf.time_precondition_ += omp_get_wtime() - t;
+        perf.precondition_count_ += 1;
+
+        t = omp_get_wtime();
+        wArA = sum_prod(wA, rA);
+        const double beta = (perf.iterations_ == 0) ? 0. : wArA / wArA_old;
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            pA[i] = wA[i] + beta * pA[i];
+        }
+        perf.time_reduction_ += omp_get_wtime() - t;
+
+        // w = A p and <p, w> in one pass
+        t = omp_get_wtime();
+        const double wApA = A.SpMV_dot(wA, pA);
+        perf.time_spmv_ += omp_get_wtime() - t;
+        perf.spmv_count_ += 1;
+        if(std::abs(wApA) < SOLVER_VSMALL){
+            break;
+        }
+
+        t = omp_get_wtime();
+        const double alpha = wArA / wApA;
+        // x += alpha p, r -= alpha A p, sum |r| in one pass
+        double residual = 0.;
+#ifdef _OPENMP
+        #pragma omp parallel for reduction(+:residual)
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            x[i] += alpha * pA[i];
+            rA[i] -= alpha * wA[i];
+            residual += std::abs(static_cast<double>(rA[i]));
+        }
+        perf.final_residual_ = residual / norm_factor;
+        perf.time_reduction_ += omp_get_wtime() - t;
+        perf.iterations_ += 1;
+    }
+    perf.converged_ = solver_converged(control, perf.initial_residual_, perf.final_residual_);
+    perf.time_total_ = omp_get_wtime() - start;
+    return perf;
+}
+
+template <typename MatrixType, typename IndexType, typename ValueType>
+SolverPerformance pbicgstab_solve(MatrixType& A, const Preconditioner<IndexType, ValueType>& M,
+    vector<ValueType>& x, const vector<ValueType>& b, const SolverControl& control){
+    const IndexType n = A.row_;
+    SolverPerformance perf = {"pbicgstab", preconditioner_type_to_string(M.type()), 0, 0., 0., false, 0, 0, 0., 0., 0., 0.};
+    const double start = omp_get_wtime();
+    double t;
+
+    vector<ValueType> yA(n);
+    vector<ValueType> rA(n);
+
+    t = omp_get_wtime();
+    A.SpMV(yA, x);
+    perf.time_spmv_ += omp_get_wtime() - t;
+    perf.spmv_count_ += 1;
+
+    t = omp_get_wtime();
+    double norm_factor;
+    perf.initial_residual_ = solver_initial_residual(A, x, yA, b, rA, norm_factor) / norm_factor;
+    perf.final_residual_ = perf.initial_residual_;
+    perf.time_reduction_ += omp_get_wtime() - t;
+
+    if(!solver_converged(control, perf.initial_residual_, perf.final_residual_)){
+        vector<ValueType> rA0(rA);
+        vector<ValueType> AyA(n);
+        vector<ValueType> pA(n);
+        vector<ValueType> sA(n);
+        vector<ValueType> zA(n);
+        vector<ValueType> tA(n);
+
+        double rA0rA = 0.;
+        double alpha = 0.;
+        double omega = 0.;
+
+        while(perf.iterations_ < control.max_iter_){
+            t = omp_get_wtime();
+            const double rA0rA_old = rA0rA;
+            rA0rA = sum_prod(rA0, rA);
+            if(std::abs(rA0rA) < SOLVER_VSMALL){
+                perf.time_reduction_ += omp_get_wtime() - t;
+                break;
+            }
+            if(perf.iterations_ == 0){
+#ifdef _OPENMP
+                #pragma omp parallel for
+#endif
+                for(IndexType i = 0; i < n; ++i){
+                    pA[i] = rA[i];
+                }
+            }else{
+                if(std::abs(omega) < SOLVER_VSMALL){
+                    perf.time_reduction_ += omp_get_wtime() - t;
+                    break;
+                }
+                const double beta = (rA0rA / rA0rA_old) * (alpha / omega);
+#ifdef _OPENMP
+                #pragma omp parallel for
+#endif
+                for(IndexType i = 0; i < n; ++i){
+                    pA[i] = rA[i] + beta * (pA[i] - omega * AyA[i]);
+                }
+            }
+            perf.time_reduction_ += omp_get_wtime() - t;
+
+            t = omp_get_wtime();
+            M.precondition(yA, pA);
+            perf.time_precondition_ += omp_get_wtime() - t;
+            perf.precondition_count_ += 1;
+
+            // Ay = A y and <r0, Ay> in one pass
+            t = omp_get_wtime();
+            const double rA0AyA = A.SpMV_dot(AyA, yA, rA0);
+            perf.time_spmv_ += omp_get_wtime() - t;
+            perf.spmv_count_ += 1;
+            if(std::abs(rA0AyA) < SOLVER_VSMALL){
+                break;
+            }
+
+            t = omp_get_wtime();
+            alpha = rA0rA / rA0AyA;
+            // s = r - alpha A y, sum |s| in one pass
+            double s_residual = 0.;
+#ifdef _OPENMP
+            #pragma omp parallel for reduction(+:s_residual)
+#endif
+            for(IndexType i = 0; i < n; ++i){
+                sA[i] = rA[i] - alpha * AyA[i];
+                s_residual += std::abs(static_cast<double>(sA[i]));
+            }
+            perf.time_reduction_ += omp_get_wtime() - t;
+            perf.iterations_ += 1;
+
+            if(solver_converged(control, perf.initial_residual_, s_residual / norm_factor)){
+                t = omp_get_wtime();
+#ifdef _OPENMP
+                #pragma omp parallel for
+#endif
+                for(IndexType i = 0; i < n; ++i){
+                    x[i] += alpha * yA[i];
+                }
+                perf.final_residual_ = s_residual / norm_factor;
+                perf.time_reduction_ += omp_get_wtime() - t;
+                break;
+            }
+
+            t = omp_get_wtime();
+            M.precondition(zA, sA);
+            perf.time_precondition_ += omp_get_wtime() - t;
+            perf.precondition_count_ += 1;
+
+            t = omp_get_wtime();
+            A.SpMV(tA, zA);
+            perf.time_spmv_ += omp_get_wtime() - t;
+            perf.spmv_count_ += 1;
+
+            t = omp_get_wtime();
+            // <t, t> and <t, s> in one pass
+            double tAtA = 0.;
+            double tAsA = 0.;
+#ifdef _OPENMP
+            #pragma omp parallel for reduction(+:tAtA, tAsA)
+#endif
+            for(IndexType i = 0; i < n; ++i){
+                tAtA += static_cast<double>(tA[i]) * tA[i];
+                tAsA += static_cast<double>(tA[i]) * sA[i];
+            }
+            omega = tAsA / (tAtA + SOLVER_VSMALL);
+            // x += alpha y + omega z, r = s - omega t, sum |r| in one pass
+            double residual = 0.;
+#ifdef _OPENMP
+            #pragma omp parallel for reduction(+:residual)
+#endif
+            for(IndexType i = 0; i < n; ++i){
+                x[i] += alpha * yA[i] + omega * zA[i];
+                rA[i] = sA[i] - omega * tA[i];
+                residual += std::abs(static_cast<double>(rA[i]));
+            }
+            perf.final_residual_ = residual / norm_factor;
+            perf.time_reduction_ += omp_get_wtime() - t;
+
+            if(solver_converged(control, perf.initial_residual_, perf.final_residual_)){
+                break;
+            }
+        }
+    }
+    perf.converged_ = solver_converged(control, perf.initial_residual_, perf.final_residual_);
+    perf.time_total_ = omp_get_wtime() - start;
+    return perf;
+}
+
+template <typename IndexType, typename ValueType>
+void set_laplacian_values(CSR<IndexType, ValueType>& A, double shift){
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < A.row_; ++i){
+        IndexType off_diagonal = 0;
+        IndexType diag = -1;
+        for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+            if(A.colidx_[idx] == i){
+                diag = idx;
+            }else{
+                A.value_[idx] = -1.;
+                off_diagonal += 1;
+            }
+        }
+        if(diag >= 0){
+            A.value_[diag] = (1. + shift) * off_diagonal;
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+SolverPerformance solver_benchmark(CSR<IndexType, ValueType>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control){
+    omp_timer timer;
+    Preconditioner<IndexType, ValueType>* M = NULL;
+    AMG<IndexType, ValueType>* amg = NULL;
+    if(solver == SOLVER_GAMG){
+        amg = new AMG<IndexType, ValueType>(A, amg_control_from_env());
+    }else{
+        M = new Preconditioner<IndexType, ValueType>(A, preconditioner);
+    }
+    double setup_time = timer.timeIncrement();
+
+    vector<ValueType> x(A.col_, 0.);
+    vector<ValueType> b(A.row_);
+    vector<ValueType> x_exact = benchmark_vector<ValueType>(A.col_);
+    A.SpMV(b, x_exact);
+
+    SolverPerformance perf;
+    if(solver == SOLVER_GAMG){
+        perf = amg->solve(x, b, control);
+    }else if(solver == SOLVER_PCG){
+        perf = pcg_solve(A, *M, x, b, control);
+    }else{
+        perf = pbicgstab_solve(A, *M, x, b, control);
+    }
+
+    double error = 0.;
+    for(IndexType i = 0; i < A.col_; ++i){
+        error = std::max(error, std::abs(static_cast<double>(x[i]) - x_exact[i]));
+    }
+
+    cout << "solver benchmark -----------" << endl;
+    cout << precision_info<IndexType, ValueType>() << endl;
+    cout << (solver == SOLVER_GAMG ? "hierarchy" : "preconditioner") << " setup time : " << setup_time << endl;
+    cout << "max |x - x_exact| : " << error << endl;
+    cout << "----------------------------" << endl;
+    perf.print();
+    if(amg != NULL){
+        amg->print_info();
+        amg->print_profile();
+    }
+    delete amg;
+    delete M;
+    return perf;
+}
+
+template <typename IndexType>
+SolverPerformance refinement_solve(CSR<IndexType, double>& A, CSRMixed<IndexType, float>& A_low,
+    const Preconditioner<IndexType, double>& M, SolverType inner, vector<double>& x, const vector<double>& b,
+    const SolverControl& control, double inner_rel_tol, int& refinement_steps){
+    const IndexType n = A.row_;
+    SolverPerformance perf = {"refinement " + solver_type_to_string(inner), preconditioner_type_to_string(M.type()),
+        0, 0., 0., false, 0, 0, 0., 0., 0., 0.};
+    const double start = omp_get_wtime();
+    double t;
+
+    vector<double> yA(n);
+    vector<double> rA(n);
+    vector<double> dA(n);
+    double norm_factor = 0.;
+    refinement_steps = 0;
+    while(true){
+        // residual in double values, normFactor of the first x kept for every step
+        t = omp_get_wtime();
+        A.SpMV(yA, x);
+        perf.time_spmv_ += omp_get_wtime() - t;
+        perf.spmv_count_ += 1;
+
+        t = omp_get_wtime();
+        double factor;
+        const double residual = solver_initial_residual(A, x, yA, b, rA, factor);
+        if(refinement_steps == 0){
+            norm_factor = factor;
+            perf.initial_residual_ = residual / norm_factor;
+        }
+        perf.final_residual_ = residual / norm_factor;
+        perf.time_reduction_ += omp_get_wtime() - t;
+        if(solver_converged(control, perf.initial_residual_, perf.final_residual_) || perf.iterations_ >= control.max_iter_){
+            break;
+        }
+
+        // correction on the float values, from d = 0
+        t = omp_get_wtime();
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            dA[i] = 0.;
+        }
+        perf.time_reduction_ += omp_get_wtime() - t;
+        const SolverControl inner_control = {0., inner_rel_tol, control.max_iter_ - perf.iterations_};
+        const SolverPerformance inner_perf = (inner == SOLVER_PCG) ? pcg_solve(A_low, M, dA, rA, inner_control)
+            : pbicgstab_solve(A_low, M, dA, rA, inner_control);
+        perf.iterations_ += inner_perf.iterations_;
+        perf.spmv_count_ += inner_perf.spmv_count_;
+        perf.precondition_count_ += inner_perf.precondition_count_;
+        perf.time_spmv_ += inner_perf.time_spmv_;
+        perf.time_precondition_ += inner_perf.time_precondition_;
+        perf.time_reduction_ += inner_perf.time_reduction_;
+        if(inner_perf.iterations_ == 0){
+            // breakdown of the inner solver, no correction
+            break;
+        }
+
+        t = omp_get_wtime();
+#ifdef _OPENMP
+        #pragma omp parallel for
+#endif
+        for(IndexType i = 0; i < n; ++i){
+            x[i] += dA[i];
+        }
+        perf.time_reduction_ += omp_get_wtime() - t;
+        refinement_steps += 1;
+    }
+    perf.converged_ = solver_converged(control, perf.initial_residual_, perf.final_residual_);
+    perf.time_total_ = omp_get_wtime() - start;
+    return perf;
+}
+
+template <typename IndexType>
+void refinement_benchmark(CSR<IndexType, double>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control){
+    if(solver != SOLVER_PCG && solver != SOLVER_PBICGSTAB){
+        cout << "Warning : refinement_benchmark supports pcg and pbicgstab, " << solver_type_to_string(solver) << " is skipped !!!" << endl;
+        return;
+    }
+    omp_timer timer;
+    Preconditioner<IndexType, double> M(A, preconditioner);
+    CSRMixed<IndexType, float> A_low(A, env_get_bool("MIXED_DELTA16", true));
+    double setup_time = timer.timeIncrement();
+    const double inner_rel_tol = env_get_double("REFINEMENT_INNER_REL_TOL", 1e-3);
+
+    vector<double> b(A.row_);
+    vector<double> x_exact = benchmark_vector<double>(A.col_);
+    A.SpMV(b, x_exact);
+
+    vector<double> x_double(A.col_, 0.);
+    SolverPerformance perf_double = (solver == SOLVER_PCG) ? pcg_solve(A, M, x_double, b, control)
+        : pbicgstab_solve(A, M, x_double, b, control);
+
+    vector<double> x_mixed(A.col_, 0.);
+    int refinement_steps = 0;
+    SolverPerformance perf_mixed = refinement_solve(A, A_low, M, solver, x_mixed, b, control, inner_rel_tol, refinement_steps);
+
+    double error_double = 0.;
+    double error_mixed = 0.;
+    for(IndexType i = 0; i < A.col_; ++i){
+        error_double = std::max(error_double, std::abs(x_double[i] - x_exact[i]));
+        error_mixed = std::max(error_mixed, std::abs(x_mixed[i] - x_exact[i]));
+    }
+    const double vector_bytes = (static_cast<double>(A.row_) + A.col_) * sizeof(double);
+    const double bytes_double = A.matrix_bytes() + vector_bytes;
+    const double bytes_mixed = A_low.matrix_bytes() + vector_bytes;
+
+    cout << "refinement benchmark -------" << endl;
+    cout << precision_info<IndexType, double>() << ", inner : " << precision_info<IndexType, float>()
+         << ", column : " << (A_low.delta16_ ? "delta16" : "index") << ", accumulate : double" << endl;
+    cout << "preconditioner + mixed csr setup time : " << setup_time << ", inner rel tol : " << inner_rel_tol << endl;
+    cout << "bytes per SpMV (matrix + x + y), double : " << bytes_double << ", mixed : " << bytes_mixed
+         << ", saved : " << 100. * (1. - bytes_mixed / bytes_double) << "%" << endl;
+    cout << "double     : residual " << perf_double.final_residual_ << ", max |x - x_exact| " << error_double
+         << ", iterations " << perf_double.iterations_ << ", time " << perf_double.time_total_ << endl;
+    cout << "refinement : residual " << perf_mixed.final_residual_ << ", max |x - x_exact| " << error_mixed
+         << ", iterations " << perf_mixed.iterations_ << " in " << refinement_steps << " steps, time " << perf_mixed.time_total_ << endl;
+    cout << "----------------------------" << endl;
+    perf_double.print();
+    perf_mixed.print();
+}
+
+template double solver_initial_residual(const CSR<int32_t, float>& A, const vector<float>& x, const vector<float>& yA,
+    const vector<float>& b, vector<float>& r, double& norm_factor);
+template double solver_initial_residual(const CSR<int32_t, double>& A, const vector<double>& x, const vector<double>& yA,
+    const vector<double>& b, vector<double>& r, double& norm_factor);
+template double solver_initial_residual(const CSR<int64_t, float>& A, const vector<float>& x, const vector<float>& yA,
+    const vector<float>& b, vector<float>& r, double& norm_factor);
+template double solver_initial_residual(const CSR<int64_t, double>& A, const vector<double>& x, const vector<double>& yA,
+    const vector<double>& b, vector<double>& r, double& norm_factor);
+
+template SolverPerformance pcg_solve(CSR<int32_t, float>& A, const Preconditioner<int32_t, float>& M,
+    vector<float>& x, const vector<float>& b, const SolverControl& control);
+template SolverPerformance pcg_solve(CSR<int32_t, double>& A, const Preconditioner<int32_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+template SolverPerformance pcg_solve(CSR<int64_t, float>& A, const Preconditioner<int64_t, float>& M,
+    vector<float>& x, const vector<float>& b, const SolverControl& control);
+template SolverPerformance pcg_solve(CSR<int64_t, double>& A, const Preconditioner<int64_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+
+template SolverPerformance pbicgstab_solve(CSR<int32_t, float>& A, const Preconditioner<int32_t, float>& M,
+    vector<float>& x, const vector<float>& b, const SolverControl& control);
+template SolverPerformance pbicgstab_solve(CSR<int32_t, double>& A, const Preconditioner<int32_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+template SolverPerformance pbicgstab_solve(CSR<int64_t, float>& A, const Preconditioner<int64_t, float>& M,
+    vector<float>& x, const vector<float>& b, const SolverControl& control);
+template SolverPerformance pbicgstab_solve(CSR<int64_t, double>& A, const Preconditioner<int64_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+
+template double solver_initial_residual(const CSRMixed<int32_t, float>& A, const vector<double>& x, const vector<double>& yA,
+    const vector<double>& b, vector<double>& r, double& norm_factor);
+template double solver_initial_residual(const CSRMixed<int64_t, float>& A, const vector<double>& x, const vector<double>& yA,
+    const vector<double>& b, vector<double>& r, double& norm_factor);
+
+template SolverPerformance pcg_solve(CSRMixed<int32_t, float>& A, const Preconditioner<int32_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+template SolverPerformance pcg_solve(CSRMixed<int64_t, float>& A, const Preconditioner<int64_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+
+template SolverPerformance pbicgstab_solve(CSRMixed<int32_t, float>& A, const Preconditioner<int32_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+template SolverPerformance pbicgstab_solve(CSRMixed<int64_t, float>& A, const Preconditioner<int64_t, double>& M,
+    vector<double>& x, const vector<double>& b, const SolverControl& control);
+
+template SolverPerformance refinement_solve(CSR<int32_t, double>& A, CSRMixed<int32_t, float>& A_low,
+    const Preconditioner<int32_t, double>& M, SolverType inner, vector<double>& x, const vector<double>& b,
+    const SolverControl& control, double inner_rel_tol, int& refinement_steps);
+template SolverPerformance refinement_solve(CSR<int64_t, double>& A, CSRMixed<int64_t, float>& A_low,
+    const Preconditioner<int64_t, double>& M, SolverType inner, vector<double>& x, const vector<double>& b,
+    const SolverControl& control, double inner_rel_tol, int& refinement_steps);
+
+template void set_laplacian_values(CSR<int32_t, float>& A, double shift);
+template void set_laplacian_values(CSR<int32_t, double>& A, double shift);
+template void set_laplacian_values(CSR<int64_t, float>& A, double shift);
+template void set_laplacian_values(CSR<int64_t, double>& A, double shift);
+
+template SolverPerformance solver_benchmark(CSR<int32_t, float>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
+template SolverPerformance solver_benchmark(CSR<int32_t, double>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
+template SolverPerformance solver_benchmark(CSR<int64_t, float>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
+template SolverPerformance solver_benchmark(CSR<int64_t, double>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
+
+template void refinement_benchmark(CSR<int32_t, double>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
+template void refinement_benchmark(CSR<int64_t, double>& A, SolverType solver, PreconditionerType preconditioner,
+    const SolverControl& control);
@@ -0,0 +1,306 @@
+#include "spgemm.hpp"
+#include "parallel.hpp"
+#include "benchmark.hpp"
+
+SpGEMMAccumulator spgemm_accumulator_from_string(const string& name){
+    if(name == "auto"){
+        return SPGEMM_ACCUMULATOR_AUTO;
+    }
+    if(name == "hash"){
+        return SPGEMM_ACCUMULATOR_HASH;
+    }
+    if(name == "esc"){
+        return SPGEMM_ACCUMULATOR_ESC;
+    }
+    cerr << "unknown spgemm accumulator : " << name << ", expect auto, hash or esc" << endl;
+    throw std::invalid_argument("unknown spgemm accumulator");
+}
+
+string spgemm_accumulator_to_string(SpGEMMAccumulator accumulator){
+    switch(accumulator){
+        case SPGEMM_ACCUMULATOR_AUTO : return "auto";
+        case SPGEMM_ACCUMULATOR_HASH : return "hash";
+        case SPGEMM_ACCUMULATOR_ESC : return "esc";
+    }
+    return "unknown";
+}
+
+// power of two table with at most half of it used
+static int64_t spgemm_hash_size(int64_t count){
+    int64_t size = 2;
+    while(size < 2 * count){
+        size <<= 1;
+    }
+    return size;
+}
+
+template <typename IndexType>
+static int64_t spgemm_hash(IndexType key, int64_t mask){
+    return (static_cast<uint64_t>(key) * 2654435761u) & mask;
+}
+
+// sorted distinct columns of row i of A * B at the front of buffer, returns their count
+template <typename IndexType, typename ValueType>
+static IndexType spgemm_esc_pattern(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B, IndexType i,
+    vector<IndexType>& buffer, int64_t row_flop){
+    if(static_cast<int64_t>(buffer.size()) < row_flop){
+        buffer.resize(row_flop);
+    }
+    IndexType count = 0;
+    for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+        const IndexType k = A.colidx_[idx];
+        for(IndexType kdx = B.rowptr_[k]; kdx < B.rowptr_[k+1]; ++kdx){
+            buffer[count++] = B.colidx_[kdx];
+        }
+    }
+    std::sort(buffer.begin(), buffer.begin() + count);
+    return std::unique(buffer.begin(), buffer.begin() + count) - buffer.begin();
+}
+
+// distinct columns of row i of A * B through the hash table, written unsorted to
+// out when out != NULL, returns their count
+template <typename IndexType, typename ValueType>
+static IndexType spgemm_hash_pattern(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B, IndexType i,
+    vector<IndexType>& keys, int64_t row_flop, IndexType* out){
+    const int64_t size = spgemm_hash_size(std::min<int64_t>(row_flop, B.col_));
+    const int64_t mask = size - 1;
+    if(static_cast<int64_t>(keys.size()) < size){
+        keys.resize(size);
+    }
+    std::fill(keys.begin(), keys.begin() + size, -1);
+    IndexType count = 0;
+    for(IndexType idx = A.rowptr_[i]; idx < A.rowptr_[i+1]; ++idx){
+        const IndexType k = A.colidx_[idx];
+        for(IndexType kdx = B.rowptr_[k]; kdx < B.rowptr_[k+1]; ++kdx){
+            const IndexType j = B.colidx_[kdx];
+            int64_t h = spgemm_hash(j, mask);
+            while(keys[h] != -1 && keys[h] != j){
+                h = (h + 1) & mask;
+            }
+            if(keys[h] == -1){
+                keys[h] = j;
+                if(out != NULL){
+                    out[count] = j;
+                }
+                count += 1;
+            }
+        }
+    }
+    return count;
+}
+
+template <typename IndexType, typename ValueType>
+SpGEMM<IndexType, ValueType>::SpGEMM(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B,
+    SpGEMMAccumulator accumulator):A_(A), B_(B), accumulator_(accumulator), flop_(0), max_row_flop_(0){
+    if(A.col_ != B.row_){
+        cerr << "In SpGEMM<IndexType, ValueType>::SpGEMM(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B), "
+             << "A.col_ (" << A.col_ << ") != B.row_ (" << B.row_ << ") !!!" << endl;
+        throw std::invalid_argument("dimension mismatch");
+    }
+    symbolic();
+}
+
+template <typename IndexType, typename ValueType>
+void SpGEMM<IndexType, ValueType>::symbolic(){
+    const IndexType n = A_.row_;
+    row_flop_.resize(n);
+    row_esc_.resize(n);
+    int64_t flop = 0;
+    int64_t max_row_flop = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:flop) reduction(max:max_row_flop)
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        int64_t row_flop = 0;
+        for(IndexType idx = A_.rowptr_[i]; idx < A_.rowptr_[i+1]; ++idx){
+            const IndexType k = A_.colidx_[idx];
+            row_flop += B_.rowptr_[k+1] - B_.rowptr_[k];
+        }
+        row_flop_[i] = row_flop;
+        row_esc_[i] = (accumulator_ == SPGEMM_ACCUMULATOR_ESC)
+            || (accumulator_ == SPGEMM_ACCUMULATOR_AUTO && row_flop <= SPGEMM_ESC_MAX_FLOP);
+        flop += row_flop;
+        max_row_flop = std::max(max_row_flop, row_flop);
+    }
+    flop_ = flop;
+    max_row_flop_ = max_row_flop;
+
+    // count pass, scan, fill pass
+    rowptr_.assign(n + 1, 0);
+    #pragma omp parallel
+    {
+        vector<IndexType> buffer;
+        #pragma omp for schedule(dynamic, 64)
+        for(IndexType i = 0; i < n; ++i){
+            rowptr_[i] = row_esc_[i] ? spgemm_esc_pattern(A_, B_, i, buffer, row_flop_[i])
+                : spgemm_hash_pattern(A_, B_, i, buffer, row_flop_[i], static_cast<IndexType*>(NULL));
+        }
+    }
+    parallel_exclusive_scan(rowptr_.data(), static_cast<int64_t>(n) + 1);
+
+    colidx_.resize(rowptr_[n]);
+    #pragma omp parallel
+    {
+        vector<IndexType> buffer;
+        #pragma omp for schedule(dynamic, 64)
+        for(IndexType i = 0; i < n; ++i){
+            if(row_esc_[i]){
+                const IndexType count = spgemm_esc_pattern(A_, B_, i, buffer, row_flop_[i]);
+                std::copy(buffer.begin(), buffer.begin() + count, colidx_.begin() + rowptr_[i]);
+            }else{
+                spgemm_hash_pattern(A_, B_, i, buffer, row_flop_[i], colidx_.data() + rowptr_[i]);
+                std::sort(colidx_.begin() + rowptr_[i], colidx_.begin() + rowptr_[i+1]);
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+CSR<IndexType, ValueType> SpGEMM<IndexType, ValueType>::multiply() const {
+    CSR<IndexType, ValueType> C(A_.row_, B_.col_, rowptr_, colidx_, vector<ValueType>(colidx_.size()));
+    numeric(C);
+    return C;
+}
+
+// ESC rows sort (column, product) pairs and sum the runs in column order,
+// hash rows map the columns of C to their slots and accumulate in place
+template <typename IndexType, typename ValueType>
+void SpGEMM<IndexType, ValueType>::numeric(CSR<IndexType, ValueType>& C) const {
+    const IndexType n = A_.row_;
+    if(C.row_ != n || C.col_ != B_.col_ || C.nnz_ != nnz()){
+        cerr << "In SpGEMM<IndexType, ValueType>::numeric(CSR<IndexType, ValueType>& C), C does not have the pattern of the symbolic phase !!!" << endl;
+        throw std::invalid_argument("pattern mismatch");
+    }
+    ValueType* value = C.value_.data();
+    #pragma omp parallel
+    {
+        vector<std::pair<IndexType, ValueType>> products;
+        vector<IndexType> keys;
+        vector<IndexType> slots;
+        #pragma omp for schedule(dynamic, 64)
+        for(IndexType i = 0; i < n; ++i){
+            if(row_esc_[i]){
+                products.resize(row_flop_[i]);
+                int64_t count = 0;
+                for(IndexType idx = A_.rowptr_[i]; idx < A_.rowptr_[i+1]; ++idx){
+                    const IndexType k = A_.colidx_[idx];
+                    const ValueType a = A_.value_[idx];
+                    for(IndexType kdx = B_.rowptr_[k]; kdx < B_.rowptr_[k+1]; ++kdx){
+                        products[count++] = std::make_pair(B_.colidx_[kdx], a * B_.value_[kdx]);
+                    }
+                }
+                std::sort(products.begin(), products.begin() + count,
+                    [](const std::pair<IndexType, ValueType>& l, const std::pair<IndexType, ValueType>& r){ return l.first < r.first; });
+                IndexType p = rowptr_[i] - 1;
+                IndexType last = -1;
+                for(int64_t q = 0; q < count; ++q){
+                    if(products[q].first != last){
+                        last = products[q].first;
+                        value[++p] = 0.;
+                    }
+                    value[p] += products[q].second;
+                }
+                continue;
+            }
+            const int64_t size = spgemm_hash_size(rowptr_[i+1] - rowptr_[i]);
+            const int64_t mask = size - 1;
+            if(static_cast<int64_t>(keys.size()) < size){
+                keys.resize(size);
+                slots.resize(size);
+            }
+            std::fill(keys.begin(), keys.begin() + size, -1);
+            for(IndexType p = rowptr_[i]; p < rowptr_[i+1]; ++p){
+                int64_t h = spgemm_hash(colidx_[p], mask);
+                while(keys[h] != -1){
+                    h = (h + 1) & mask;
+                }
+                keys[h] = colidx_[p];
+                slots[h] = p;
+                value[p] = 0.;
+            }
+            for(IndexType idx = A_.rowptr_[i]; idx < A_.rowptr_[i+1]; ++idx){
+                const IndexType k = A_.colidx_[idx];
+                const ValueType a = A_.value_[idx];
+                for(IndexType kdx = B_.rowptr_[k]; kdx < B_.rowptr_[k+1]; ++kdx){
+                    const IndexType j = B_.colidx_[kdx];
+                    int64_t h = spgemm_hash(j, mask);
+                    while(keys[h] != j){
+                        h = (h + 1) & mask;
+                    }
+                    value[slots[h]] += a * B_.value_[kdx];
+                }
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void SpGEMM<IndexType, ValueType>::print_info() const {
+    IndexType esc_row = 0;
+    for(IndexType i = 0; i < A_.row_; ++i){
+        esc_row += row_esc_[i];
+    }
+    cout << "SpGEMM" << endl;
+    cout << "accumulator : " << spgemm_accumulator_to_string(accumulator_) << ", esc rows : " << esc_row
+         << ", hash rows : " << A_.row_ - esc_row << endl;
+    cout << "row : " << A_.row_ << ", col : " << B_.col_ << ", nnz : " << nnz() << endl;
+    cout << "flop : " << flop_ << ", max row flop : " << max_row_flop_
+         << ", flop / nnz : " << static_cast<double>(flop_) / std::max<IndexType>(nnz(), 1) << endl;
+}
+
+template <typename IndexType, typename ValueType>
+CSR<IndexType, ValueType> spgemm(const CSR<IndexType, ValueType>& A, const CSR<IndexType, ValueType>& B, SpGEMMAccumulator accumulator){
+    SpGEMM<IndexType, ValueType> product(A, B, accumulator);
+    return product.multiply();
+}
+
+template <typename IndexType, typename ValueType>
+void spgemm_benchmark(CSR<IndexType, ValueType>& A, CSR<IndexType, ValueType>& B){
+    // y_ref = A (B x)
+    vector<ValueType> x = benchmark_vector<ValueType>(B.col_);
+    vector<ValueType> Bx(B.row_);
+    vector<ValueType> y_ref(A.row_);
+    vector<ValueType> y(A.row_);
+    B.SpMV(Bx, x);
+    A.SpMV(y_ref, Bx);
+    const string info = precision_info<IndexType, ValueType>();
+
+    const SpGEMMAccumulator accumulators[] = {SPGEMM_ACCUMULATOR_AUTO, SPGEMM_ACCUMULATOR_HASH, SPGEMM_ACCUMULATOR_ESC};
+    for(SpGEMMAccumulator accumulator : accumulators){
+        SpGEMM<IndexType, ValueType> product(A, B, accumulator);
+        CSR<IndexType, ValueType> C = product.multiply();
+        product.print_info();
+        auto difference = [&](){
+            C.SpMV(y, x);
+            double diff = 0.;
+            double norm = 0.;
+            for(IndexType i = 0; i < C.row_; ++i){
+                diff = std::max(diff, std::abs(static_cast<double>(y[i]) - y_ref[i]));
+                norm = std::max(norm, std::abs(static_cast<double>(y_ref[i])));
+            }
+            return norm > 0. ? diff / norm : diff;
+        };
+        // A, B and C streamed once, the products stay in cache
+        const double bytes = A.matrix_bytes() + B.matrix_bytes() + C.matrix_bytes();
+        const string name = "spgemm " + spgemm_accumulator_to_string(accumulator);
+        spmv_benchmark_run(name + " symbolic + numeric", info, 2. * product.flop(), bytes,
+            [&](){ C = spgemm(A, B, accumulator); }, difference, benchmark_tolerance<ValueType>());
+        spmv_benchmark_run(name + " numeric (reuse)", info, 2. * product.flop(), bytes,
+            [&](){ product.numeric(C); }, difference, benchmark_tolerance<ValueType>());
+    }
+}
+
+template class SpGEMM<int32_t, float>;
+template class SpGEMM<int32_t, double>;
+template class SpGEMM<int64_t, float>;
+template class SpGEMM<int64_t, double>;
+
+template CSR<int32_t, float> spgemm(const CSR<int32_t, float>& A, const CSR<int32_t, float>& B, SpGEMMAccumulator accumulator);
+template CSR<int32_t, double> spgemm(const CSR<int32_t, double>& A, const CSR<int32_t, double>& B, SpGEMMAccumulator accumulator);
+template CSR<int64_t, float> spgemm(const CSR<int64_t, float>& A, const CSR<int64_t, float>& B, SpGEMMAccumulator accumulator);
+template CSR<int64_t, double> spgemm(const CSR<int64_t, double>& A, const CSR<int64_t, double>& B, SpGEMMAccumulator accumulator);
+
+template void spgemm_benchmark(CSR<int32_t, float>& A, CSR<int32_t, float>& B);
+template void spgemm_benchmark(CSR<int32_t, double>& A, CSR<int32_t, double>& B);
+template void spgemm_benchmark(CSR<int64_t, float>& A, CSR<int64_t, float>& B);
+template void spgemm_benchmark(CSR<int64_t, double>& A, CSR<int64_t, double>& B);
@@ -0,0 +1,223 @@
+#include "triangular.hpp"
+#include "parallel.hpp"
+#include "benchmark.hpp"
+
+TriangularSchedule triangular_schedule_from_string(const string& name){
+    if(name == "serial"){
+        return TRIANGULAR_SCHEDULE_SERIAL;
+    }
+    if(name == "level"){
+        return TRIANGULAR_SCHEDULE_LEVEL;
+    }
+    cerr << "unknown triangular schedule : " << name << ", expect serial or level" << endl;
+    throw std::invalid_argument("unknown triangular schedule");
+}
+
+string triangular_schedule_to_string(TriangularSchedule schedule){
+    switch(schedule){
+        case TRIANGULAR_SCHEDULE_SERIAL : return "serial";
+        case TRIANGULAR_SCHEDULE_LEVEL : return "level";
+    }
+    return "unknown";
+}
+
+template <typename IndexType, typename ValueType>
+Triangular<IndexType, ValueType>::Triangular(const CSR<IndexType, ValueType>& A):A_(A){
+    if(A.row_ != A.col_){
+        cerr << "In Triangular<IndexType, ValueType>::Triangular(const CSR<IndexType, ValueType>& A), matrix have to be square !!!" << endl;
+        throw std::invalid_argument("matrix is not square");
+    }
+    const IndexType n = A.row_;
+    const IndexType* colidx = A.colidx_.data();
+    lower_end_.resize(n);
+    upper_begin_.resize(n);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        lower_end_[i] = std::lower_bound(colidx + A.rowptr_[i], colidx + A.rowptr_[i+1], i) - colidx;
+        upper_begin_[i] = std::upper_bound(colidx + lower_end_[i], colidx + A.rowptr_[i+1], i) - colidx;
+    }
+    build_levels(true);
+    build_levels(false);
+}
+
+// levels in sweep order (serial, one pass over the triangle), then rows
+// grouped by level with a counting sort, ascending row inside a level
+template <typename IndexType, typename ValueType>
+void Triangular<IndexType, ValueType>::build_levels(bool lower){
+    const IndexType n = A_.row_;
+    const IndexType* rowptr = A_.rowptr_.data();
+    const IndexType* colidx = A_.colidx_.data();
+    vector<IndexType> level(n);
+    IndexType level_count = 0;
+    for(IndexType k = 0; k < n; ++k){
+        const IndexType i = lower ? k : n - 1 - k;
+        const IndexType begin = lower ? rowptr[i] : upper_begin_[i];
+        const IndexType end = lower ? lower_end_[i] : rowptr[i+1];
+        IndexType l = 0;
+        for(IndexType idx = begin; idx < end; ++idx){
+            l = std::max(l, level[colidx[idx]] + 1);
+        }
+        level[i] = l;
+        level_count = std::max(level_count, l + 1);
+    }
+
+    vector<IndexType>& level_ptr = lower ? lower_level_ptr_ : upper_level_ptr_;
+    vector<IndexType>& level_row = lower ? lower_level_row_ : upper_level_row_;
+    level_ptr.assign(level_count + 1, 0);
+    level_row.resize(n);
+    for(IndexType i = 0; i < n; ++i){
+        level_ptr[level[i]] += 1;
+    }
+    parallel_exclusive_scan(level_ptr.data(), static_cast<int64_t>(level_count) + 1);
+    vector<IndexType> cursor(level_ptr.begin(), level_ptr.end() - 1);
+    for(IndexType i = 0; i < n; ++i){
+        level_row[cursor[level[i]]++] = i;
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void Triangular<IndexType, ValueType>::lower_solve(ValueType* x, const ValueType* b, const ValueType* c, const ValueType* s, TriangularSchedule schedule) const {
+    const IndexType* rowptr = A_.rowptr_.data();
+    const IndexType* colidx = A_.colidx_.data();
+    const ValueType* value = A_.value_.data();
+    if(schedule == TRIANGULAR_SCHEDULE_SERIAL){
+        for(IndexType i = 0; i < A_.row_; ++i){
+            ValueType sum = 0.;
+            for(IndexType idx = rowptr[i]; idx < lower_end_[i]; ++idx){
+                sum += value[idx] * x[colidx[idx]];
+            }
+            x[i] = (c == NULL ? b[i] : c[i] * b[i]) - s[i] * sum;
+        }
+        return;
+    }
+    const IndexType level_count = lower_level_count();
+    #pragma omp parallel
+    {
+        for(IndexType l = 0; l < level_count; ++l){
+            #pragma omp for schedule(static)
+            for(IndexType k = lower_level_ptr_[l]; k < lower_level_ptr_[l+1]; ++k){
+                const IndexType i = lower_level_row_[k];
+                ValueType sum = 0.;
+                for(IndexType idx = rowptr[i]; idx < lower_end_[i]; ++idx){
+                    sum += value[idx] * x[colidx[idx]];
+                }
+                x[i] = (c == NULL ? b[i] : c[i] * b[i]) - s[i] * sum;
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void Triangular<IndexType, ValueType>::upper_solve(ValueType* x, const ValueType* b, const ValueType* c, const ValueType* s, TriangularSchedule schedule) const {
+    const IndexType* rowptr = A_.rowptr_.data();
+    const IndexType* colidx = A_.colidx_.data();
+    const ValueType* value = A_.value_.data();
+    if(schedule == TRIANGULAR_SCHEDULE_SERIAL){
+        for(IndexType i = A_.row_ - 1; i >= 0; --i){
+            ValueType sum = 0.;
+            for(IndexType idx = upper_begin_[i]; idx < rowptr[i+1]; ++idx){
+                sum += value[idx] * x[colidx[idx]];
+            }
+            x[i] = (c == NULL ? b[i] : c[i] * b[i]) - s[i] * sum;
+        }
+        return;
+    }
+    const IndexType level_count = upper_level_count();
+    #pragma omp parallel
+    {
+        for(IndexType l = 0; l < level_count; ++l){
+            #pragma omp for schedule(static)
+            for(IndexType k = upper_level_ptr_[l]; k < upper_level_ptr_[l+1]; ++k){
+                const IndexType i = upper_level_row_[k];
+                ValueType sum = 0.;
+                for(IndexType idx = upper_begin_[i]; idx < rowptr[i+1]; ++idx){
+                    sum += value[idx] * x[colidx[idx]];
+                }
+                x[i] = (c == NULL ? b[i] : c[i] * b[i]) - s[i] * sum;
+            }
+        }
+    }
+}
+
+template <typename IndexType, typename ValueType>
+void Triangular<IndexType, ValueType>::print_info() const {
+    IndexType lower_max = 0;
+    IndexType upper_max = 0;
+    for(IndexType l = 0; l < lower_level_count(); ++l){
+        lower_max = std::max(lower_max, lower_level_ptr_[l+1] - lower_level_ptr_[l]);
+    }
+    for(IndexType l = 0; l < upper_level_count(); ++l){
+        upper_max = std::max(upper_max, upper_level_ptr_[l+1] - upper_level_ptr_[l]);
+    }
+    cout << "Triangular" << endl;
+    cout << "row : " << A_.row_ << endl;
+    cout << "lower levels : " << lower_level_count() << ", parallelism (rows / level) : " << static_cast<double>(A_.row_) / lower_level_count()
+         << ", max rows / level : " << lower_max << endl;
+    cout << "upper levels : " << upper_level_count() << ", parallelism (rows / level) : " << static_cast<double>(A_.row_) / upper_level_count()
+         << ", max rows / level : " << upper_max << endl;
+}
+
+template <typename IndexType, typename ValueType>
+void Triangular<IndexType, ValueType>::benchmark() const {
+    const IndexType n = A_.row_;
+    vector<ValueType> rdiag(n, 1.);
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        if(lower_end_[i] < upper_begin_[i] && A_.value_[lower_end_[i]] != 0.){
+            rdiag[i] = 1. / A_.value_[lower_end_[i]];
+        }
+    }
+    IndexType lower_nnz = 0;
+    IndexType upper_nnz = 0;
+#ifdef _OPENMP
+    #pragma omp parallel for reduction(+:lower_nnz, upper_nnz)
+#endif
+    for(IndexType i = 0; i < n; ++i){
+        lower_nnz += lower_end_[i] - A_.rowptr_[i];
+        upper_nnz += A_.rowptr_[i+1] - upper_begin_[i];
+    }
+
+    vector<ValueType> b = benchmark_vector<ValueType>(n);
+    vector<ValueType> x_serial(n);
+    vector<ValueType> x(n);
+    // rowptr + lower_end / upper_begin + level rows, the triangle, x, b, 1 / diag
+    const double index_bytes = 4. * n * sizeof(IndexType);
+    const string info = precision_info<IndexType, ValueType>();
+    auto difference = [&](){
+        double diff = 0.;
+        double norm = 0.;
+        for(IndexType i = 0; i < n; ++i){
+            diff = std::max(diff, std::abs(static_cast<double>(x[i]) - x_serial[i]));
+            norm = std::max(norm, std::abs(static_cast<double>(x_serial[i])));
+        }
+        return norm > 0. ? diff / norm : diff;
+    };
+
+    print_info();
+    for(int lower = 1; lower >= 0; --lower){
+        const double tri_nnz = lower ? lower_nnz : upper_nnz;
+        const double bytes = tri_nnz * (sizeof(IndexType) + sizeof(ValueType)) + index_bytes + 3. * n * sizeof(ValueType);
+        const string name = lower ? "lower" : "upper";
+        auto solve = [&](vector<ValueType>& out, TriangularSchedule schedule){
+            if(lower){
+                lower_solve(out.data(), b.data(), rdiag.data(), rdiag.data(), schedule);
+            }else{
+                upper_solve(out.data(), b.data(), rdiag.data(), rdiag.data(), schedule);
+            }
+        };
+        spmv_benchmark_run(name + " solve serial", info, 2. * tri_nnz + n, bytes,
+            [&](){ solve(x_serial, TRIANGULAR_SCHEDULE_SERIAL); });
+        spmv_benchmark_run(name + " solve level", info + "\nlevels : " + std::to_string(lower ? lower_level_count() : upper_level_count()),
+            2. * tri_nnz + n, bytes, [&](){ solve(x, TRIANGULAR_SCHEDULE_LEVEL); },
+            difference, benchmark_tolerance<ValueType>());
+    }
+}
+
+template class Triangular<int32_t, float>;
+template class Triangular<int32_t, double>;
+template class Triangular<int64_t, float>;
+template class Triangular<int64_t, double>;
@@ -6,8 +6,6 @@
 #include <mpi.h>
 #include "slave_kernel.h"
 
-#define SLAVE_FUN(x) slave_##x 
-
 void fill_random_d(double* input, int64_t len, double start, double end){
     double range_len = end - start;
     for(int64_t i = 0; i < len; ++i){
@@ -47,7 +45,7 @@ void bias_gelu_d_ldm_lookup_prefetch_slave(double* input, const double* bias, in
     para.bias = bias;
     para.row = row;
     para.col = col;
-    CRTS_athread_spawn(bias_gelu_d_ldm_lookup_prefetch, &para);
+    CRTS_athread_spawn(SLAVE_FUN(bias_gelu_d_ldm_lookup_prefetch), &para);
     CRTS_athread_join();
 }
 
@@ -57,7 +55,7 @@ void bias_gelu_d_ldm_lookup_prefetch_simd_slave(double* input, const double* bia
     para.bias = bias;
     para.row = row;
     para.col = col;
-    CRTS_athread_spawn(bias_gelu_d_ldm_lookup_prefetch_simd, &para);
+    CRTS_athread_spawn(SLAVE_FUN(bias_gelu_d_ldm_lookup_prefetch_simd), &para);
     CRTS_athread_join();
 }
 
@@ -16,7 +16,7 @@ void bias_gelu_h_ldm_fastexp_prefetch_slave(float16* input, const float16* bias,
     para.bias = bias;
     para.row = row;
     para.col = col;
-    CRTS_athread_spawn(bias_gelu_h_ldm_fastexp_prefetch, &para);
+    CRTS_athread_spawn(SLAVE_FUN(bias_gelu_h_ldm_fastexp_prefetch), &para);
     CRTS_athread_join();
 }
 
@@ -26,7 +26,7 @@ void bias_gelu_h_ldm_lookup_prefetch_slave(float16* input, const float16* bias,
     para.bias = bias;
     para.row = row;
     para.col = col;
-    CRTS_athread_spawn(bias_gelu_h_ldm_lookup_prefetch, &para);
+    CRTS_athread_spawn(SLAVE_FUN(bias_gelu_h_ldm_lookup_prefetch), &para);
     CRTS_athread_join();
 }
 
@@ -36,7 +36,7 @@ void bias_gelu_h_ldm_lookup_prefetch_simd_slave(float16* input, const float16* b
     para.bias = bias;
     para.row = row;
     para.col = col;
-    CRTS_athread_spawn(bias_gelu_h_ldm_lookup_prefetch_simd, &para);
+    CRTS_athread_spawn(SLAVE_FUN(bias_gelu_h_ldm_lookup_prefetch_simd), &para);
     CRTS_athread_join();
 }
 
@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# x86 build of bias_gelu : the slave kernels run on the CRTS emulation of
+# ../crts_emu (64 CPE threads), simd.h is its scalar shim, the fp16
+# conversions come from ../swfp16 (run ../swfp16/build_emu.sh first),
+# run with ./bias_gelu_emu.bin
+
+FP16_CONVERT_INC="-I../swfp16"
+FP16_CONVERT_LIB="../swfp16/libswfp16_emu.a"
+
+INCS="${FP16_CONVERT_INC}"
+LIBS="${FP16_CONVERT_LIB}"
+
+EMU="-D__sw_64__ -I../crts_emu"
+
+CC=mpicc
+CFLAGS="-O2 -g $EMU $INCS"
+
+set -ex
+
+rm -f bias_gelu_emu.bin
+
+$CC $CFLAGS -c -o crts_emu.o ../crts_emu/crts_emu.c
+# kernel f is spawned as SLAVE_FUN(f) = slave_f, the name the slave compiler gives it
+for f in bias_gelu_d_ldm_lookup_prefetch bias_gelu_d_ldm_lookup_prefetch_simd \
+    bias_gelu_s_ldm_lookup_prefetch bias_gelu_s_ldm_lookup_prefetch_simd \
+    bias_gelu_h_ldm_lookup_prefetch bias_gelu_h_ldm_lookup_prefetch_simd \
+    bias_gelu_h_ldm_fastexp_prefetch; do
+    $CC $CFLAGS -D__sw_slave__ -D$f=slave_$f -c -o $f.emu.o ./$f.c
+done
+
+$CC $CFLAGS -D__sw_host__ -o bias_gelu_emu.bin ./bias_gelu.c *.emu.o crts_emu.o $LIBS -lpthread -lm
+
+rm -f *.emu.o crts_emu.o
@@ -1,9 +1,11 @@
 #pragma once
-__thread_local const float range_start = -3;
-__thread_local const float range_end = 3;
-__thread_local const float fit_split = 64;
-__thread_local const int fit_order = 0;
-__thread_local const float fast_gelu_poly_table_float[385] __attribute__ ((aligned(64))) = {
+// static : every kernel that includes a table keeps its own LDM copy, the
+// d / s / h tables share their names
+static __thread_local const float range_start = -3;
+static __thread_local const float range_end = 3;
+static __thread_local const float fit_split = 64;
+static __thread_local const int fit_order = 0;
+static __thread_local const float fast_gelu_poly_table_float[385] __attribute__ ((aligned(64))) = {
     -3.728273e-03,
     -3.917147e-03,
     -4.114183e-03,
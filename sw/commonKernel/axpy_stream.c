@@ -0,0 +1,40 @@
+#define STREAM_MAX_IN 2
+
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+void axpy_stream(axpy_param_t* para_p){
+    axpy_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(axpy_param_t));
+
+    scalar* y = para.y;
+    const scalar* x = para.x;
+    scalar alpha = para.alpha;
+    scalar beta = para.beta;
+    label len = para.len;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, x + local_start);
+    stream_add_in(&stream, y + local_start);
+    stream_set_out(&stream, y + local_start, 1);
+    stream_start(&stream);
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        label brl = stream_tile_begin(&stream, t, buffer);
+        const scalar* x_buffer = buffer[0];
+        scalar* y_buffer = buffer[1];
+        for(label i = 0; i < brl; ++i){
+            y_buffer[i] = alpha * x_buffer[i] + beta * y_buffer[i];
+        }
+        stream_tile_end(&stream, t);
+    }
+
+    stream_finish(&stream);
+}
@@ -2,10 +2,12 @@
 
 DEF="-DWM_DP -DWM_ARCH_OPTION=64"
 
+# -ffp-contract=off : the reproducible sums (repro_sum.h) need the products
+# rounded, no FMA, to give the bits of the host and emu builds
 CC=mpicc
-CFLAGS="-msimd -O3 -mftz -mieee -faddress_align=64 $DEF"
+CFLAGS="-msimd -O3 -mftz -mieee -faddress_align=64 -ffp-contract=off $DEF"
 CXX=mpicxx
-CFLAGS="-msimd -O3 -mftz -mieee -faddress_align=64 $DEF"
+CFLAGS="-msimd -O3 -mftz -mieee -faddress_align=64 -ffp-contract=off $DEF"
 
 
 set -ex
@@ -25,5 +27,18 @@ $CC -c -mslave $CFLAGS -o sum_mag_naive.o ./sum_mag_naive.c
 $CC -c -mslave $CFLAGS -o sum_sqr_naive.o ./sum_sqr_naive.c
 $CC -c -mslave $CFLAGS -o sum_prod_naive.o ./sum_prod_naive.c
 $CC -c -mslave $CFLAGS -o copy_naive.o ./copy_naive.c
+$CC -c -mslave $CFLAGS -o multi_reduce_naive.o ./multi_reduce_naive.c
+$CC -c -mslave $CFLAGS -o repro_reduce_naive.o ./repro_reduce_naive.c
+
+$CC -c -mslave $CFLAGS -o axpy_stream.o ./axpy_stream.c
+$CC -c -mslave $CFLAGS -o triad_stream.o ./triad_stream.c
+$CC -c -mslave $CFLAGS -o copy_stream.o ./copy_stream.c
+$CC -c -mslave $CFLAGS -o norm_factor_local_stream.o ./norm_factor_local_stream.c
+$CC -c -mslave $CFLAGS -o sum_stream.o ./sum_stream.c
+$CC -c -mslave $CFLAGS -o sum_mag_stream.o ./sum_mag_stream.c
+$CC -c -mslave $CFLAGS -o sum_sqr_stream.o ./sum_sqr_stream.c
+$CC -c -mslave $CFLAGS -o sum_prod_stream.o ./sum_prod_stream.c
+$CC -c -mslave $CFLAGS -o multi_reduce_stream.o ./multi_reduce_stream.c
+$CC -c -mslave $CFLAGS -o repro_reduce_stream.o ./repro_reduce_stream.c
 
 $CXX -mhybrid -o main.bin *.o -lm -lm_slave
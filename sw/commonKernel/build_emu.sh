@@ -0,0 +1,30 @@
+#!/bin/bash
+
+# x86 build of the Sunway path : the slave kernels run on the CRTS emulation
+# of ../crts_emu (64 CPE threads), run with ./main_emu.bin [bandwidth test length],
+# the DMA / RMA traffic per kernel is printed at exit
+
+DEF="-DWM_DP -DWM_ARCH_OPTION=64"
+EMU="-D__sw_64__ -I../crts_emu"
+
+CC=mpicc
+CXX=mpicxx
+CFLAGS="-O2 -g -ffp-contract=off $DEF $EMU"
+
+set -ex
+
+rm -f main_emu.bin
+
+$CC $CFLAGS -c -o crts_emu.o ../crts_emu/crts_emu.c
+$CC $CFLAGS -c -o reduce_rma.emu.o ./reduce_rma.c
+# kernel f is spawned as SLAVE_FUN(f) = slave_f, the name the slave compiler gives it
+for f in norm_factor_local_naive axpy_naive triad_naive sum_naive sum_mag_naive sum_sqr_naive \
+    sum_prod_naive copy_naive multi_reduce_naive repro_reduce_naive \
+    axpy_stream triad_stream copy_stream norm_factor_local_stream sum_stream sum_mag_stream \
+    sum_sqr_stream sum_prod_stream multi_reduce_stream repro_reduce_stream; do
+    $CC $CFLAGS -D$f=slave_$f -c -o $f.emu.o ./$f.c
+done
+
+$CXX $CFLAGS -o main_emu.bin ./main.cpp ./common_kernel.C *.emu.o crts_emu.o -lpthread -lm
+
+rm -f *.emu.o crts_emu.o
@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# x86 / non Sunway build of main.cpp on the host backend (common_host_kernel.C),
+# run with OMP_NUM_THREADS=<n> ./main_host.bin [bandwidth test length]
+
+DEF="-DWM_DP -DWM_ARCH_OPTION=64"
+
+CXX=mpicxx
+CFLAGS="-O3 -march=native -fopenmp -ffp-contract=off $DEF"
+
+set -ex
+
+rm -f main_host.bin
+
+$CXX $CFLAGS -o main_host.bin ./main.cpp ./common_host_kernel.C
@@ -2,6 +2,16 @@
 
 #include "slave_utils.h"
 #include <math.h>
+#include "repro_sum.h"
 
 // call_from slave
 extern scalar reduce_rma(scalar local);
+
+// largest count of reduce_rma_array
+#define REDUCE_RMA_MAX_COUNT 4
+
+// call_from slave, count <= REDUCE_RMA_MAX_COUNT values reduced in one tree
+extern void reduce_rma_array(scalar* local, int count);
+
+// call_from slave, merges the df_repro_t of all CPEs in one tree, valid on tid 0
+extern void reduce_rma_repro(df_repro_t* acc);
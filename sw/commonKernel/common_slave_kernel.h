@@ -24,6 +24,30 @@ extern void SLAVE_FUN(sum_prod_naive)(sum_prod_param_t* para_p);
 
 extern void SLAVE_FUN(copy_naive)(copy_param_t* para_p);
 
+extern void SLAVE_FUN(multi_reduce_naive)(multi_reduce_param_t* para_p);
+
+extern void SLAVE_FUN(repro_reduce_naive)(repro_reduce_param_t* para_p);
+
+extern void SLAVE_FUN(axpy_stream)(axpy_param_t* para_p);
+
+extern void SLAVE_FUN(triad_stream)(triad_param_t* para_p);
+
+extern void SLAVE_FUN(norm_factor_local_stream)(norm_factor_local_param_t* para_p);
+
+extern void SLAVE_FUN(sum_stream)(sum_param_t* para_p);
+
+extern void SLAVE_FUN(sum_mag_stream)(sum_mag_param_t* para_p);
+
+extern void SLAVE_FUN(sum_sqr_stream)(sum_sqr_param_t* para_p);
+
+extern void SLAVE_FUN(sum_prod_stream)(sum_prod_param_t* para_p);
+
+extern void SLAVE_FUN(copy_stream)(copy_param_t* para_p);
+
+extern void SLAVE_FUN(multi_reduce_stream)(multi_reduce_param_t* para_p);
+
+extern void SLAVE_FUN(repro_reduce_stream)(repro_reduce_param_t* para_p);
+
 
 
 #ifdef __cplusplus
@@ -61,6 +61,24 @@ typedef struct{
     label len;
 } sum_prod_param_t;
 
+typedef struct{
+    scalar* ret_p;          // DF_REDUCE_COUNT scalars
+    const scalar* a;
+    const scalar* b;        // read only for DF_REDUCE_SUM_PROD
+    unsigned int mask;
+    label len;
+} multi_reduce_param_t;
+
+typedef struct{
+    df_repro_t* ret_p;
+    const scalar* a;
+    const scalar* b;        // DF_REPRO_OP_SUM_PROD, DF_REPRO_OP_NORM_FACTOR_LOCAL
+    const scalar* c;        // DF_REPRO_OP_NORM_FACTOR_LOCAL
+    scalar gPsiAvg;
+    int op;
+    label len;
+} repro_reduce_param_t;
+
 typedef struct{
     scalar* dst;
     const scalar* src;
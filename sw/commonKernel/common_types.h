@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdint.h>
+
+// scalar / label of the OpenFOAM build, shared by the host and the slave side
+#if defined(WM_SP)
+    #define MPI_SCALAR MPI_FLOAT
+    typedef float scalar;
+#elif defined(WM_DP)
+    #define MPI_SCALAR MPI_DOUBLE
+    typedef double scalar;
+#elif defined(WM_LP)
+    #define MPI_SCALAR MPI_LONG_DOUBLE
+    typedef long double scalar;
+#endif
+
+#if WM_ARCH_OPTION == 32
+    #define MPI_LABEL MPI_INT
+    typedef int32_t label;
+#elif WM_ARCH_OPTION == 64
+    #define MPI_LABEL MPI_LONG
+    typedef int64_t label;
+#else
+    #error "WM_ARCH_OPTION must be 32 or 64"
+#endif
+
+// reductions of df_multi_reduce, bit i of the mask fills ret[i]
+#define DF_REDUCE_SUM       1u  // sum a
+#define DF_REDUCE_SUM_MAG   2u  // sum |a|
+#define DF_REDUCE_SUM_SQR   4u  // sum a * a
+#define DF_REDUCE_SUM_PROD  8u  // sum a * b
+#define DF_REDUCE_COUNT     4
+
+// reproducible sums (repro_sum.h) : DF_REPRO_BINS bins of DF_REPRO_WIDTH bits
+#define DF_REPRO_BINS       3
+#define DF_REPRO_WIDTH      26
+#define DF_REPRO_EMPTY      (-1000)         // top of an accumulator without a nonzero value
+#define DF_REPRO_MIN_TOP    (-37)           // lowest bin stays a normal number (-mftz)
+#define DF_REPRO_MAX_TOP    37              // 1.5 * 2^(DF_REPRO_WIDTH * top + 52) does not overflow
+#define DF_REPRO_MAX_LEN    ((label)1 << 27) // values of one reduction, over all ranks, the bins stay exact
+
+// binned accumulator, bin[k] is the exact sum of the parts of the values in
+// the bin of index top - k (multiples of 2^(DF_REPRO_WIDTH * (top - k)))
+typedef struct{
+    scalar top;
+    scalar bin[DF_REPRO_BINS];
+} df_repro_t;
+
+#define DF_REPRO_SIZE (1 + DF_REPRO_BINS)  // scalars in a df_repro_t
+
+// per element value of df_reduce_repro
+#define DF_REPRO_OP_SUM                 0   // a
+#define DF_REPRO_OP_SUM_MAG             1   // |a|
+#define DF_REPRO_OP_SUM_SQR             2   // a * a
+#define DF_REPRO_OP_SUM_PROD            3   // a * b
+#define DF_REPRO_OP_NORM_FACTOR_LOCAL   4   // |b - a * gPsiAvg| + |c - a * gPsiAvg|
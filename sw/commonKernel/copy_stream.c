@@ -0,0 +1,32 @@
+#define STREAM_MAX_IN 1
+
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+void copy_stream(copy_param_t* para_p){
+    copy_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(copy_param_t));
+
+    scalar* dst = para.dst;
+    const scalar* src = para.src;
+    label len = para.len;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, src + local_start);
+    stream_set_out(&stream, dst + local_start, 0);
+    stream_start(&stream);
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        stream_tile_begin(&stream, t, buffer);
+        stream_tile_end(&stream, t);
+    }
+
+    stream_finish(&stream);
+}
@@ -1,12 +1,37 @@
 #include <iostream>
 #include <mpi.h>
-#include <crts.h>
 #include <math.h>
+#include <string.h>
+#ifdef __sw_64__
+#include <crts.h>
+#else
+#include <stdlib.h>
+#endif
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 #include "common_kernel.H"
 
 #define LEN 524288
 
+// best of BENCH_REPEAT timed calls
+#define BENCH_REPEAT 20
+
+#ifndef __sw_64__
+static void* libc_aligned_malloc(size_t size){
+    void* p = NULL;
+    if(posix_memalign(&p, 64, size) != 0){
+        return NULL;
+    }
+    return p;
+}
+
+static void libc_aligned_free(void* p){
+    free(p);
+}
+#endif
+
 void fill_random(double* input, int64_t len, double start, double end){
     double range_len = end - start;
     for(int64_t i = 0; i < len; ++i){
@@ -244,10 +269,6 @@ void copy_test(){
 
     df_copy(dst, src, len);
 
-    for(int64_t i = 0; i < len; ++i){
-        printf("%lf, %lf\n", dst_answer[i], dst[i]);
-    }
-
     check_error(dst_answer, dst, len);
 
 
@@ -292,6 +313,35 @@ void norm_factor_local_test(){
     libc_aligned_free(sourcePtr);
 }
 
+void multi_reduce_test(){
+    int64_t random_len = 128;
+    double* random_list = (double*)libc_aligned_malloc(random_len * sizeof(double));
+    fill_random(random_list, random_len, -5, 5);
+
+    int64_t len = LEN + 5;
+    double* a  = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* b  = (double*)libc_aligned_malloc(len * sizeof(double));
+    for(int64_t i = 0; i < len; ++i){
+        a[i] = random_list[i % random_len];
+        b[i] = random_list[(i * 7) % random_len];
+    }
+
+    double answer[DF_REDUCE_COUNT];
+    double ret[DF_REDUCE_COUNT];
+    answer[0] = df_sum(a, len);
+    answer[1] = df_sum_mag(a, len);
+    answer[2] = df_sum_sqr(a, len);
+    answer[3] = df_sum_prod(a, b, len);
+
+    df_multi_reduce(ret, DF_REDUCE_SUM | DF_REDUCE_SUM_MAG | DF_REDUCE_SUM_SQR | DF_REDUCE_SUM_PROD, a, b, len);
+
+    check_error(answer, ret, DF_REDUCE_COUNT);
+
+    libc_aligned_free(random_list);
+    libc_aligned_free(a);
+    libc_aligned_free(b);
+}
+
 void triad(scalar* z, scalar alpha, const scalar* x, scalar beta, const scalar* y, scalar gamma, label len){
     for(label i = 0; i < len; ++i){
         z[i] = alpha * x[i] + beta * y[i] + gamma * z[i];
@@ -326,18 +376,374 @@ void triad_test(){
     libc_aligned_free(z_answer);
 }
 
+template <typename Function>
+double best_time(Function f){
+    f();
+    double best = 1e30;
+    for(int r = 0; r < BENCH_REPEAT; ++r){
+        double start = MPI_Wtime();
+        f();
+        best = std::min(best, MPI_Wtime() - start);
+    }
+    return best;
+}
+
+// a = b + 3 * c, the bandwidth ceiling of the streaming kernels. a is only
+// written, so its lines are read first (write allocate) : 4 streams, not the 3
+// of the STREAM report. print_bandwidth counts the kernels the same way, an
+// output that is only written is 2 streams. the kernels that update their
+// output in place (df_axpy, df_triad) have no write allocate and run a bit
+// faster, so the ceiling is the best of this triad and a = a + 3 * c (3 streams)
+double stream_triad_bandwidth(scalar* a, const scalar* b, const scalar* c, label len){
+    double time = best_time([&](){
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for(label i = 0; i < len; ++i){
+            a[i] = b[i] + 3. * c[i];
+        }
+    });
+    double time_in_place = best_time([&](){
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+        for(label i = 0; i < len; ++i){
+            a[i] = a[i] + 3. * c[i];
+        }
+    });
+    return std::max(4. / time, 3. / time_in_place) * len * sizeof(scalar) * 1e-9;
+}
+
+void print_bandwidth(const char* name, double streams, label len, double time, double stream){
+    double bandwidth = streams * len * sizeof(scalar) / time * 1e-9;
+    printf("%-20s %12.6e %10.3f %8.3f\n", name, time, bandwidth, bandwidth / stream);
+}
+
+// every df_* kernel in GB/s against the STREAM triad, arrays of len scalars
+void bandwidth_test(label len){
+    scalar* x = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* y = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* z = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* w = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    // first touch with the static schedule of the kernels
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+    for(label i = 0; i < len; ++i){
+        x[i] = 1. + (i % 16) / 16.;
+        y[i] = 0.5;
+        z[i] = 0.25;
+        w[i] = 0.;
+    }
+    int thread_count = 1;
+#ifdef _OPENMP
+    thread_count = omp_get_max_threads();
+#endif
+    double stream = stream_triad_bandwidth(w, x, y, len);
+    volatile scalar sink = 0.;
+
+    printf("-------------------------------------------------\n");
+    printf("len : %ld, threads : %d, STREAM triad (write allocate counted) : %.3f GB/s\n", (long)len, thread_count, stream);
+    printf("%-20s %12s %10s %8s\n", "kernel", "time", "GB/s", "/STREAM");
+    print_bandwidth("df_axpy", 3., len, best_time([&](){ df_axpy(y, 1e-3, x, 0.5, len); }), stream);
+    print_bandwidth("df_triad", 4., len, best_time([&](){ df_triad(z, 1e-3, x, 0.5, y, 0.5, len); }), stream);
+    print_bandwidth("df_copy", 3., len, best_time([&](){ df_copy(w, x, len); }), stream);
+    print_bandwidth("df_sum", 1., len, best_time([&](){ sink = df_sum(x, len); }), stream);
+    print_bandwidth("df_sum_mag", 1., len, best_time([&](){ sink = df_sum_mag(x, len); }), stream);
+    print_bandwidth("df_sum_sqr", 1., len, best_time([&](){ sink = df_sum_sqr(x, len); }), stream);
+    print_bandwidth("df_sum_prod", 2., len, best_time([&](){ sink = df_sum_prod(x, y, len); }), stream);
+    print_bandwidth("df_norm_factor_local", 3., len, best_time([&](){ sink = df_norm_factor_local(x, 2., y, z, len); }), stream);
+
+    // reproducible reductions, overhead against the plain ones
+    double plain[5];
+    double repro[5];
+    plain[0] = best_time([&](){ sink = df_sum(x, len); });
+    plain[1] = best_time([&](){ sink = df_sum_mag(x, len); });
+    plain[2] = best_time([&](){ sink = df_sum_sqr(x, len); });
+    plain[3] = best_time([&](){ sink = df_sum_prod(x, y, len); });
+    plain[4] = best_time([&](){ sink = df_norm_factor_local(x, 2., y, z, len); });
+    repro[0] = best_time([&](){ sink = df_sum_repro(x, len); });
+    repro[1] = best_time([&](){ sink = df_sum_mag_repro(x, len); });
+    repro[2] = best_time([&](){ sink = df_sum_sqr_repro(x, len); });
+    repro[3] = best_time([&](){ sink = df_sum_prod_repro(x, y, len); });
+    repro[4] = best_time([&](){ sink = df_norm_factor_local_repro(x, 2., y, z, len); });
+    print_bandwidth("df_sum_repro", 1., len, repro[0], stream);
+    print_bandwidth("df_sum_mag_repro", 1., len, repro[1], stream);
+    print_bandwidth("df_sum_sqr_repro", 1., len, repro[2], stream);
+    print_bandwidth("df_sum_prod_repro", 2., len, repro[3], stream);
+    print_bandwidth("df_norm_factor_repro", 3., len, repro[4], stream);
+    printf("repro / plain time : sum %.3f, sum_mag %.3f, sum_sqr %.3f, sum_prod %.3f, norm_factor_local %.3f\n",
+        repro[0] / plain[0], repro[1] / plain[1], repro[2] / plain[2], repro[3] / plain[3], repro[4] / plain[4]);
+
+    // the reductions of a convergence check, back to back calls against one sweep
+    scalar ret[DF_REDUCE_COUNT];
+    const unsigned int all = DF_REDUCE_SUM | DF_REDUCE_SUM_MAG | DF_REDUCE_SUM_SQR | DF_REDUCE_SUM_PROD;
+    const unsigned int single = DF_REDUCE_SUM | DF_REDUCE_SUM_MAG | DF_REDUCE_SUM_SQR;
+    double separate_all = best_time([&](){
+        sink = df_sum(x, len);
+        sink = df_sum_mag(x, len);
+        sink = df_sum_sqr(x, len);
+        sink = df_sum_prod(x, y, len);
+    });
+    double separate_single = best_time([&](){
+        sink = df_sum(x, len);
+        sink = df_sum_mag(x, len);
+        sink = df_sum_sqr(x, len);
+    });
+    double fused_all = best_time([&](){ df_multi_reduce(ret, all, x, y, len); });
+    double fused_single = best_time([&](){ df_multi_reduce(ret, single, x, NULL, len); });
+    print_bandwidth("separate (4)", 5., len, separate_all, stream);
+    print_bandwidth("df_multi_reduce (4)", 2., len, fused_all, stream);
+    print_bandwidth("separate (3)", 3., len, separate_single, stream);
+    print_bandwidth("df_multi_reduce (3)", 1., len, fused_single, stream);
+    printf("multi reduce speedup, 4 reductions : %.3f, 3 reductions : %.3f\n", separate_all / fused_all, separate_single / fused_single);
+    printf("-------------------------------------------------\n");
+
+    libc_aligned_free(x);
+    libc_aligned_free(y);
+    libc_aligned_free(z);
+    libc_aligned_free(w);
+}
+
+#ifdef __sw_64__
+// the streamed slave kernels (slave_stream.h) against the naive ones : same
+// bits (a CPE adds its values in the same order for any tile size) and the
+// time of both, len is not a multiple of the tile so the last tiles are partial
+void stream_test(label len){
+    scalar* x = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* y = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* z = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* naive = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    scalar* stream = (scalar*)libc_aligned_malloc(len * sizeof(scalar));
+    fill_random(x, len, -5, 5);
+    fill_random(y, len, -5, 5);
+    fill_random(z, len, -5, 5);
+
+    const int kernel_count = 10;
+    const char* name[kernel_count] = {"axpy", "triad", "triad gamma = 0", "copy", "sum", "sum_mag", "sum_sqr",
+        "sum_prod", "norm_factor_local", "multi_reduce"};
+    const double streams[kernel_count] = {3., 4., 3., 2., 1., 1., 1., 2., 3., 2.};
+    const unsigned int all = DF_REDUCE_SUM | DF_REDUCE_SUM_MAG | DF_REDUCE_SUM_SQR | DF_REDUCE_SUM_PROD;
+    // the updated arrays of axpy and triad start from y and z
+    auto reset = [&](int k, scalar* out){
+        if(k == 0){
+            array_copy(out, y, len);
+        }else if(k == 1){
+            array_copy(out, z, len);
+        }
+    };
+    // kernel k of the naive (s = 0) or the stream (s = 1) family, the result in out
+    auto run = [&](int k, int s, scalar* out){
+        switch(k){
+        case 0:
+            s == 0 ? axpy_navie_slave(out, 1e-3, x, 0.5, len) : axpy_stream_slave(out, 1e-3, x, 0.5, len);
+            break;
+        case 1:
+            s == 0 ? triad_naive_slave(out, 1e-3, x, 0.5, y, 0.5, len) : triad_stream_slave(out, 1e-3, x, 0.5, y, 0.5, len);
+            break;
+        case 2:
+            s == 0 ? triad_naive_slave(out, 1e-3, x, 0.5, y, 0., len) : triad_stream_slave(out, 1e-3, x, 0.5, y, 0., len);
+            break;
+        case 3:
+            s == 0 ? copy_naive_slave(out, x, len) : copy_stream_slave(out, x, len);
+            break;
+        case 4:
+            s == 0 ? sum_naive_slave(out, x, len) : sum_stream_slave(out, x, len);
+            break;
+        case 5:
+            s == 0 ? sum_mag_naive_slave(out, x, len) : sum_mag_stream_slave(out, x, len);
+            break;
+        case 6:
+            s == 0 ? sum_sqr_naive_slave(out, x, len) : sum_sqr_stream_slave(out, x, len);
+            break;
+        case 7:
+            s == 0 ? sum_prod_naive_slave(out, x, y, len) : sum_prod_stream_slave(out, x, y, len);
+            break;
+        case 8:
+            s == 0 ? norm_factor_local_naive_slave(out, x, 0.3, y, z, len) : norm_factor_local_stream_slave(out, x, 0.3, y, z, len);
+            break;
+        default:
+            s == 0 ? multi_reduce_naive_slave(out, all, x, y, len) : multi_reduce_stream_slave(out, all, x, y, len);
+            break;
+        }
+    };
+    // compared entries of the result
+    auto result_len = [&](int k){
+        return k < 4 ? len : k == 9 ? (label)DF_REDUCE_COUNT : (label)1;
+    };
+
+    printf("-------------------------------------------------\n");
+    printf("stream against naive slave kernels, len : %ld\n", (long)len);
+    printf("%-20s %10s %12s %12s %10s %8s\n", "kernel", "result", "naive", "stream", "GB/s", "speedup");
+    for(int k = 0; k < kernel_count; ++k){
+        reset(k, naive);
+        reset(k, stream);
+        run(k, 0, naive);
+        run(k, 1, stream);
+        int equal = memcmp(naive, stream, result_len(k) * sizeof(scalar)) == 0;
+        double naive_time = best_time([&](){ run(k, 0, naive); });
+        double stream_time = best_time([&](){ run(k, 1, stream); });
+        printf("%-20s %10s %12.6e %12.6e %10.3f %8.3f\n", name[k], equal ? "equal" : "DIFFERENT",
+            naive_time, stream_time, streams[k] * len * sizeof(scalar) / stream_time * 1e-9, naive_time / stream_time);
+    }
+    const int op_count = 5;
+    const int op[op_count] = {DF_REPRO_OP_SUM, DF_REPRO_OP_SUM_MAG, DF_REPRO_OP_SUM_SQR, DF_REPRO_OP_SUM_PROD, DF_REPRO_OP_NORM_FACTOR_LOCAL};
+    int repro_equal = 1;
+    for(int k = 0; k < op_count; ++k){
+        df_repro_t acc[2];
+        repro_reduce_naive_slave(&acc[0], op[k], x, y, z, 0.3, len);
+        repro_reduce_stream_slave(&acc[1], op[k], x, y, z, 0.3, len);
+        repro_equal &= memcmp(&acc[0], &acc[1], sizeof(df_repro_t)) == 0;
+    }
+    printf("%-20s %10s\n", "repro_reduce", repro_equal ? "equal" : "DIFFERENT");
+    printf("-------------------------------------------------\n");
+
+    libc_aligned_free(x);
+    libc_aligned_free(y);
+    libc_aligned_free(z);
+    libc_aligned_free(naive);
+    libc_aligned_free(stream);
+}
+#endif
+
+#ifdef _OPENMP
+// the reductions have to give the same bits on 1 thread and on all threads
+void deterministic_test(){
+    int64_t len = LEN + 13;
+    double* a = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* b = (double*)libc_aligned_malloc(len * sizeof(double));
+    fill_random(a, len, -5, 5);
+    fill_random(b, len, -5, 5);
+    int thread_count = omp_get_max_threads();
+    double ret[2][5];
+    for(int k = 0; k < 2; ++k){
+        omp_set_num_threads(k == 0 ? 1 : thread_count);
+        ret[k][0] = df_sum(a, len);
+        ret[k][1] = df_sum_mag(a, len);
+        ret[k][2] = df_sum_sqr(a, len);
+        ret[k][3] = df_sum_prod(a, b, len);
+        ret[k][4] = df_norm_factor_local(a, 0.3, b, a, len);
+    }
+    omp_set_num_threads(thread_count);
+    printf("-------------------------------------------------\n");
+    printf("deterministic reductions, 1 against %d threads : %s\n", thread_count,
+        memcmp(ret[0], ret[1], sizeof(ret[0])) == 0 ? "bitwise equal" : "DIFFERENT");
+    printf("-------------------------------------------------\n");
+    libc_aligned_free(a);
+    libc_aligned_free(b);
+}
+#endif
+
+// the reproducible reductions have to give the same bits for any order and any
+// split of the values, and on 1 and on all threads
+void reproducible_test(){
+    int64_t len = LEN + 13;
+    double* a = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* b = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* c = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* ar = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* br = (double*)libc_aligned_malloc(len * sizeof(double));
+    double* cr = (double*)libc_aligned_malloc(len * sizeof(double));
+    // values over 16 orders of magnitude, the plain sums depend on the order
+    for(int64_t i = 0; i < len; ++i){
+        a[i] = (rand() * 2. / RAND_MAX - 1.) * pow(10., rand() % 16 - 8);
+        b[i] = (rand() * 2. / RAND_MAX - 1.) * pow(10., rand() % 16 - 8);
+        c[i] = rand() * 1. / RAND_MAX;
+    }
+    for(int64_t i = 0; i < len; ++i){
+        ar[i] = a[len - 1 - i];
+        br[i] = b[len - 1 - i];
+        cr[i] = c[len - 1 - i];
+    }
+
+    const int op_count = 5;
+    const char* name[op_count] = {"sum", "sum_mag", "sum_sqr", "sum_prod", "norm_factor_local"};
+    const int op[op_count] = {DF_REPRO_OP_SUM, DF_REPRO_OP_SUM_MAG, DF_REPRO_OP_SUM_SQR, DF_REPRO_OP_SUM_PROD, DF_REPRO_OP_NORM_FACTOR_LOCAL};
+    const double gPsiAvg = 0.3;
+    int thread_count = 1;
+#ifdef _OPENMP
+    thread_count = omp_get_max_threads();
+#endif
+
+    printf("-------------------------------------------------\n");
+    printf("%-18s %10s %10s %10s %14s %14s\n", "reproducible", "threads", "reversed", "split", "plain error", "repro error");
+    for(int k = 0; k < op_count; ++k){
+        double ret[4];
+        df_repro_t acc;
+        // all values
+        df_reduce_repro(&acc, op[k], a, b, c, gPsiAvg, len);
+        ret[0] = repro_value(&acc);
+        // 1 thread
+#ifdef _OPENMP
+        omp_set_num_threads(1);
+#endif
+        df_reduce_repro(&acc, op[k], a, b, c, gPsiAvg, len);
+        ret[1] = repro_value(&acc);
+#ifdef _OPENMP
+        omp_set_num_threads(thread_count);
+#endif
+        // reversed order
+        df_reduce_repro(&acc, op[k], ar, br, cr, gPsiAvg, len);
+        ret[2] = repro_value(&acc);
+        // 3 uneven parts merged, as df_repro_allreduce over 3 ranks
+        int64_t split[4] = {0, 1001, len / 2 + 7, len};
+        df_repro_t merged;
+        repro_init(&merged);
+        for(int p = 2; p >= 0; --p){
+            df_reduce_repro(&acc, op[k], a + split[p], b + split[p], c + split[p], gPsiAvg, split[p + 1] - split[p]);
+            repro_merge(&merged, &acc);
+        }
+        ret[3] = repro_value(&merged);
+
+        // errors against a long double sum of the same values
+        long double reference = 0.;
+        for(int64_t i = 0; i < len; ++i){
+            double tmp = a[i] * gPsiAvg;
+            double v = k == 0 ? a[i] : k == 1 ? fabs(a[i]) : k == 2 ? a[i] * a[i] : k == 3 ? a[i] * b[i]
+                : fabs(b[i] - tmp) + fabs(c[i] - tmp);
+            reference += v;
+        }
+        double plain = k == 0 ? df_sum(a, len) : k == 1 ? df_sum_mag(a, len) : k == 2 ? df_sum_sqr(a, len)
+            : k == 3 ? df_sum_prod(a, b, len) : df_norm_factor_local(a, gPsiAvg, b, c, len);
+        printf("%-18s %10s %10s %10s %14.6e %14.6e\n", name[k],
+            memcmp(&ret[0], &ret[1], sizeof(double)) == 0 ? "equal" : "DIFFERENT",
+            memcmp(&ret[0], &ret[2], sizeof(double)) == 0 ? "equal" : "DIFFERENT",
+            memcmp(&ret[0], &ret[3], sizeof(double)) == 0 ? "equal" : "DIFFERENT",
+            (double)fabsl((plain - reference) / reference), (double)fabsl((ret[0] - reference) / reference));
+    }
+    printf("-------------------------------------------------\n");
+
+    libc_aligned_free(a);
+    libc_aligned_free(b);
+    libc_aligned_free(c);
+    libc_aligned_free(ar);
+    libc_aligned_free(br);
+    libc_aligned_free(cr);
+}
+
+// argv[1] : length of the bandwidth test arrays (default 2^25)
 int main(int argc, char** argv){
     MPI_Init(&argc, &argv);
 
-    // axpy_test();
+    axpy_test();
     triad_test();
 
-    // norm_factor_local_test();
-    // sum_test();
-    // sum_mag_test();
-    // sum_sqr_test();
-    // sum_prod_test();
-    // copy_test();
+    norm_factor_local_test();
+    sum_test();
+    sum_mag_test();
+    sum_sqr_test();
+    sum_prod_test();
+    copy_test();
+    multi_reduce_test();
+
+#ifdef _OPENMP
+    deterministic_test();
+#endif
+    reproducible_test();
+    bandwidth_test(argc > 1 ? atol(argv[1]) : (label)1 << 25);
+#ifdef __sw_64__
+    stream_test(argc > 1 ? atol(argv[1]) + 13 : ((label)1 << 25) + 13);
+#endif
 
     MPI_Finalize();
     return 0;
@@ -0,0 +1,61 @@
+#include "common_slave_function.h"
+#include "common_slave_param.h"
+
+#define MAX_CELL_LOCAL 1024
+
+// sum / sum_mag / sum_sqr / sum_prod of the mask in one sweep over a (and b),
+// one athread job and one reduction tree for all of them
+void multi_reduce_naive(multi_reduce_param_t* para_p){
+    multi_reduce_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(multi_reduce_param_t));
+
+    scalar* ret_p = para.ret_p;
+    const scalar* a = para.a;
+    const scalar* b = para.b;
+    const unsigned int mask = para.mask;
+    const label len = para.len;
+    const int need_b = (mask & DF_REDUCE_SUM_PROD) != 0;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    const scalar* local_a = a + local_start;
+    const scalar* local_b = b + local_start;
+
+    scalar a_buffer[MAX_CELL_LOCAL];
+    scalar b_buffer[MAX_CELL_LOCAL];
+
+    label block_count = slave_div_ceil(local_len, MAX_CELL_LOCAL);
+
+    scalar sum = 0.;
+    scalar sum_mag = 0.;
+    scalar sum_sqr = 0.;
+    scalar sum_prod = 0.;
+
+    for(label bi = 0; bi < block_count; ++bi){
+        label brs = bi * MAX_CELL_LOCAL;
+        label bre = slave_min(local_len, brs + MAX_CELL_LOCAL);
+        label brl = bre - brs;
+        CRTS_dma_get(a_buffer, (scalar*)local_a + brs, brl * sizeof(double));
+        if(need_b){
+            CRTS_dma_get(b_buffer, (scalar*)local_b + brs, brl * sizeof(double));
+            for(label i = 0; i < brl; ++i){
+                sum_prod += a_buffer[i] * b_buffer[i];
+            }
+        }
+        for(label i = 0; i < brl; ++i){
+            sum += a_buffer[i];
+            sum_mag += fabs(a_buffer[i]);
+            sum_sqr += a_buffer[i] * a_buffer[i];
+        }
+    }
+
+    scalar local[DF_REDUCE_COUNT] = {sum, sum_mag, sum_sqr, sum_prod};
+    reduce_rma_array(local, DF_REDUCE_COUNT);
+
+    if(CRTS_tid == 0){
+        CRTS_dma_put(ret_p, local, DF_REDUCE_COUNT * sizeof(scalar));
+    }
+}
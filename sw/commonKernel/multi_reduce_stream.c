@@ -0,0 +1,61 @@
+#define STREAM_MAX_IN 2
+
+#include "common_slave_function.h"
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+// multi_reduce_naive on streamed tiles, b is only fetched for DF_REDUCE_SUM_PROD
+void multi_reduce_stream(multi_reduce_param_t* para_p){
+    multi_reduce_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(multi_reduce_param_t));
+
+    scalar* ret_p = para.ret_p;
+    const scalar* a = para.a;
+    const scalar* b = para.b;
+    const unsigned int mask = para.mask;
+    const label len = para.len;
+    const int need_b = (mask & DF_REDUCE_SUM_PROD) != 0;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, a + local_start);
+    if(need_b){
+        stream_add_in(&stream, b + local_start);
+    }
+    stream_start(&stream);
+
+    scalar sum = 0.;
+    scalar sum_mag = 0.;
+    scalar sum_sqr = 0.;
+    scalar sum_prod = 0.;
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        label brl = stream_tile_begin(&stream, t, buffer);
+        const scalar* a_buffer = buffer[0];
+        if(need_b){
+            const scalar* b_buffer = buffer[1];
+            for(label i = 0; i < brl; ++i){
+                sum_prod += a_buffer[i] * b_buffer[i];
+            }
+        }
+        for(label i = 0; i < brl; ++i){
+            sum += a_buffer[i];
+            sum_mag += fabs(a_buffer[i]);
+            sum_sqr += a_buffer[i] * a_buffer[i];
+        }
+        stream_tile_end(&stream, t);
+    }
+
+    scalar local[DF_REDUCE_COUNT] = {sum, sum_mag, sum_sqr, sum_prod};
+    reduce_rma_array(local, DF_REDUCE_COUNT);
+
+    if(CRTS_tid == 0){
+        CRTS_dma_put(ret_p, local, DF_REDUCE_COUNT * sizeof(scalar));
+    }
+}
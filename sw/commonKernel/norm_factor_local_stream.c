@@ -0,0 +1,50 @@
+#define STREAM_MAX_IN 3
+
+#include "common_slave_function.h"
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+void norm_factor_local_stream(norm_factor_local_param_t* para_p){
+    norm_factor_local_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(norm_factor_local_param_t));
+
+    scalar* ret_p = para.ret_p;
+    const scalar* pAPtr = para.pAPtr;
+    const scalar* yAPtr = para.yAPtr;
+    const scalar* sourcePtr = para.sourcePtr;
+    const scalar gPsiAvg = para.gPsiAvg;
+    const label nCells = para.nCells;
+
+    label local_start = LOCAL_START(nCells, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(nCells, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, yAPtr + local_start);
+    stream_add_in(&stream, sourcePtr + local_start);
+    stream_add_in(&stream, pAPtr + local_start);
+    stream_start(&stream);
+
+    scalar local = 0.;
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        label brl = stream_tile_begin(&stream, t, buffer);
+        const scalar* yAPtr_buffer = buffer[0];
+        const scalar* sourcePtr_buffer = buffer[1];
+        const scalar* pAPtr_buffer = buffer[2];
+        for(label i = 0; i < brl; ++i){
+            double tmp = pAPtr_buffer[i] * gPsiAvg;
+            local += fabs(yAPtr_buffer[i] - tmp) + fabs(sourcePtr_buffer[i] - tmp);
+        }
+        stream_tile_end(&stream, t);
+    }
+
+    scalar ret = reduce_rma(local);
+
+    if(CRTS_tid == 0){
+        CRTS_dma_put(ret_p, &ret, sizeof(scalar));
+    }
+}
@@ -2,22 +2,46 @@
 
 #define MAX_CELL_LOCAL 1024
 
-scalar reduce_rma(scalar local){
+// acc[0, count) = combine(acc, in)
+typedef void (*reduce_rma_combine_t)(scalar* acc, const scalar* in, int count);
+
+static void reduce_rma_add(scalar* acc, const scalar* in, int count){
+    int k;
+    for(k = 0; k < count; ++k){
+        acc[k] += in[k];
+    }
+}
+
+// count is always DF_REPRO_SIZE, one df_repro_t
+static void reduce_rma_repro_merge(scalar* acc, const scalar* in, int count){
+    (void)count;
+    repro_merge((df_repro_t*)acc, (const df_repro_t*)in);
+}
+
+// 64 CPE tree on count values at once : each row folds into cid 0 (steps of
+// 1, 2, 4), then cid 0 folds down the column. one RMA message of count scalars per step,
+// local[0, count) is overwritten, the result is valid on tid 0
+static void reduce_rma_tree(scalar* local, int count, reduce_rma_combine_t combine){
     crts_rply_t rma_rplyl = 0;
     crts_rply_t rma_rplyr = 0;
     unsigned int R_COUNTL = 0;
     unsigned int R_COUNTR = 0;
 
-    scalar ret = local;
-    scalar rma_buf;
+    scalar ret[REDUCE_RMA_MAX_COUNT];
+    scalar rma_buf[REDUCE_RMA_MAX_COUNT];
+    int k;
+
+    for(k = 0; k < count; ++k){
+        ret[k] = local[k];
+    }
 
     CRTS_ssync_array();
 
     if(CRTS_cid % 2 == 0){
-        CRTS_rma_iget(&rma_buf, &rma_rplyl, sizeof(scalar), CRTS_tid+1, &ret, &rma_rplyr);
+        CRTS_rma_iget(rma_buf, &rma_rplyl, count * sizeof(scalar), CRTS_tid+1, ret, &rma_rplyr);
         R_COUNTL++;
         CRTS_rma_wait_value(&rma_rplyl, R_COUNTL);
-        ret += rma_buf;
+        combine(ret, rma_buf, count);
     }else{
         R_COUNTR++;
         CRTS_rma_wait_value(&rma_rplyr, R_COUNTR);
@@ -25,10 +49,10 @@ scalar reduce_rma(scalar local){
 
     if(CRTS_cid==0 || CRTS_cid==4){
         CRTS_ssync_peer(CRTS_tid+2);
-        CRTS_rma_iget(&rma_buf, &rma_rplyl, sizeof(scalar), CRTS_tid+2, &ret, &rma_rplyr);
+        CRTS_rma_iget(rma_buf, &rma_rplyl, count * sizeof(scalar), CRTS_tid+2, ret, &rma_rplyr);
         R_COUNTL++;
         CRTS_rma_wait_value(&rma_rplyl, R_COUNTL);
-        ret += rma_buf;
+        combine(ret, rma_buf, count);
     }else if(CRTS_cid==2 || CRTS_cid==6){
         CRTS_ssync_peer(CRTS_tid-2);
         R_COUNTR++;
@@ -37,10 +61,10 @@ scalar reduce_rma(scalar local){
 
     if(CRTS_cid == 0){
         CRTS_ssync_peer(CRTS_tid+4);
-        CRTS_rma_iget(&rma_buf, &rma_rplyl, sizeof(scalar), CRTS_tid+4, &ret, &rma_rplyr);
+        CRTS_rma_iget(rma_buf, &rma_rplyl, count * sizeof(scalar), CRTS_tid+4, ret, &rma_rplyr);
         R_COUNTL++;
         CRTS_rma_wait_value(&rma_rplyl, R_COUNTL);
-        ret += rma_buf;
+        combine(ret, rma_buf, count);
     }else if(CRTS_cid == 4){
         CRTS_ssync_peer(CRTS_tid-4);
         R_COUNTR++;
@@ -56,10 +80,10 @@ scalar reduce_rma(scalar local){
             if(!flag2 || !(CRTS_rid & flag2)){
                 if(!(CRTS_rid&flag)){
                     CRTS_ssync_peer(CRTS_tid + pep);
-                    CRTS_rma_iget(&rma_buf, &rma_rplyl, sizeof(scalar), CRTS_tid+pep, &ret, &rma_rplyr);
+                    CRTS_rma_iget(rma_buf, &rma_rplyl, count * sizeof(scalar), CRTS_tid+pep, ret, &rma_rplyr);
                     R_COUNTL++;
                     CRTS_rma_wait_value(&rma_rplyl, R_COUNTL);
-                    ret += rma_buf;
+                    combine(ret, rma_buf, count);
                 }else{
                     CRTS_ssync_peer(CRTS_tid - pep);
                     R_COUNTR++;
@@ -68,6 +92,21 @@ scalar reduce_rma(scalar local){
             }
         }
     }
-    return ret;
+
+    for(k = 0; k < count; ++k){
+        local[k] = ret[k];
+    }
+}
+
+scalar reduce_rma(scalar local){
+    reduce_rma_tree(&local, 1, reduce_rma_add);
+    return local;
+}
+
+void reduce_rma_array(scalar* local, int count){
+    reduce_rma_tree(local, count, reduce_rma_add);
 }
 
+void reduce_rma_repro(df_repro_t* acc){
+    reduce_rma_tree((scalar*)acc, DF_REPRO_SIZE, reduce_rma_repro_merge);
+}
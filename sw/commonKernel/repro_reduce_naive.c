@@ -0,0 +1,85 @@
+#include "common_slave_function.h"
+#include "common_slave_param.h"
+
+#define MAX_CELL_LOCAL 1024
+
+// binned reproducible reduction of the DF_REPRO_OP_* values (repro_sum.h),
+// the df_repro_t of the 64 CPEs are merged by reduce_rma_repro
+void repro_reduce_naive(repro_reduce_param_t* para_p){
+    repro_reduce_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(repro_reduce_param_t));
+
+    df_repro_t* ret_p = para.ret_p;
+    const scalar* a = para.a;
+    const scalar* b = para.b;
+    const scalar* c = para.c;
+    const scalar gPsiAvg = para.gPsiAvg;
+    const int op = para.op;
+    const label len = para.len;
+    const int need_b = op == DF_REPRO_OP_SUM_PROD || op == DF_REPRO_OP_NORM_FACTOR_LOCAL;
+    const int need_c = op == DF_REPRO_OP_NORM_FACTOR_LOCAL;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    const scalar* local_a = a + local_start;
+    const scalar* local_b = b + local_start;
+    const scalar* local_c = c + local_start;
+
+    scalar a_buffer[MAX_CELL_LOCAL];
+    scalar b_buffer[MAX_CELL_LOCAL];
+    scalar c_buffer[MAX_CELL_LOCAL];
+
+    label block_count = slave_div_ceil(local_len, MAX_CELL_LOCAL);
+
+    df_repro_t acc;
+    repro_init(&acc);
+
+    for(label bi = 0; bi < block_count; ++bi){
+        label brs = bi * MAX_CELL_LOCAL;
+        label bre = slave_min(local_len, brs + MAX_CELL_LOCAL);
+        label brl = bre - brs;
+        CRTS_dma_get(a_buffer, (scalar*)local_a + brs, brl * sizeof(double));
+        if(need_b){
+            CRTS_dma_get(b_buffer, (scalar*)local_b + brs, brl * sizeof(double));
+        }
+        if(need_c){
+            CRTS_dma_get(c_buffer, (scalar*)local_c + brs, brl * sizeof(double));
+        }
+        // the values of the block in a_buffer, then one deposit
+        switch(op){
+        case DF_REPRO_OP_SUM_MAG:
+            for(label i = 0; i < brl; ++i){
+                a_buffer[i] = fabs(a_buffer[i]);
+            }
+            break;
+        case DF_REPRO_OP_SUM_SQR:
+            for(label i = 0; i < brl; ++i){
+                a_buffer[i] = a_buffer[i] * a_buffer[i];
+            }
+            break;
+        case DF_REPRO_OP_SUM_PROD:
+            for(label i = 0; i < brl; ++i){
+                a_buffer[i] = a_buffer[i] * b_buffer[i];
+            }
+            break;
+        case DF_REPRO_OP_NORM_FACTOR_LOCAL:
+            for(label i = 0; i < brl; ++i){
+                scalar tmp = a_buffer[i] * gPsiAvg;
+                a_buffer[i] = fabs(b_buffer[i] - tmp) + fabs(c_buffer[i] - tmp);
+            }
+            break;
+        default:
+            break;
+        }
+        repro_deposit(&acc, a_buffer, brl);
+    }
+
+    reduce_rma_repro(&acc);
+
+    if(CRTS_tid == 0){
+        CRTS_dma_put(ret_p, &acc, sizeof(df_repro_t));
+    }
+}
@@ -0,0 +1,83 @@
+#define STREAM_MAX_IN 3
+
+#include "common_slave_function.h"
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+// repro_reduce_naive on streamed tiles, the bins do not depend on the tile
+// size so the result has the bits of the naive kernel
+void repro_reduce_stream(repro_reduce_param_t* para_p){
+    repro_reduce_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(repro_reduce_param_t));
+
+    df_repro_t* ret_p = para.ret_p;
+    const scalar* a = para.a;
+    const scalar* b = para.b;
+    const scalar* c = para.c;
+    const scalar gPsiAvg = para.gPsiAvg;
+    const int op = para.op;
+    const label len = para.len;
+    const int need_b = op == DF_REPRO_OP_SUM_PROD || op == DF_REPRO_OP_NORM_FACTOR_LOCAL;
+    const int need_c = op == DF_REPRO_OP_NORM_FACTOR_LOCAL;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, a + local_start);
+    if(need_b){
+        stream_add_in(&stream, b + local_start);
+    }
+    if(need_c){
+        stream_add_in(&stream, c + local_start);
+    }
+    stream_start(&stream);
+
+    df_repro_t acc;
+    repro_init(&acc);
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        label brl = stream_tile_begin(&stream, t, buffer);
+        scalar* a_buffer = buffer[0];
+        const scalar* b_buffer = buffer[1];
+        const scalar* c_buffer = buffer[2];
+        // the values of the tile in a_buffer, then one deposit
+        switch(op){
+        case DF_REPRO_OP_SUM_MAG:
+            for(label i = 0; i < brl; ++i){
+                a_buffer[i] = fabs(a_buffer[i]);
+            }
+            break;
+        case DF_REPRO_OP_SUM_SQR:
+            for(label i = 0; i < brl; ++i){
+                a_buffer[i] = a_buffer[i] * a_buffer[i];
+            }
+            break;
+        case DF_REPRO_OP_SUM_PROD:
+            for(label i = 0; i < brl; ++i){
+                a_buffer[i] = a_buffer[i] * b_buffer[i];
+            }
+            break;
+        case DF_REPRO_OP_NORM_FACTOR_LOCAL:
+            for(label i = 0; i < brl; ++i){
+                scalar tmp = a_buffer[i] * gPsiAvg;
+                a_buffer[i] = fabs(b_buffer[i] - tmp) + fabs(c_buffer[i] - tmp);
+            }
+            break;
+        default:
+            break;
+        }
+        repro_deposit(&acc, a_buffer, brl);
+        stream_tile_end(&stream, t);
+    }
+
+    reduce_rma_repro(&acc);
+
+    if(CRTS_tid == 0){
+        CRTS_dma_put(ret_p, &acc, sizeof(df_repro_t));
+    }
+}
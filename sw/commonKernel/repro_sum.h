@@ -0,0 +1,122 @@
+#pragma once
+
+#include <math.h>
+#include "common_types.h"
+
+// reproducible summation, binned after Demmel / Nguyen (ReproBLAS)
+//
+// bin t has the grain G_t = 2^(DF_REPRO_WIDTH * t). R_t(x), x rounded to the
+// nearest (even) multiple of G_t, is (x + M_t) - M_t with M_t = 1.5 * 2^52 * G_t.
+// a value deposits d_t(x) = R_t(x) - R_t+1(x) in bin t, from the top bin down
+// through the remainders. d_t depends on x and t only, bins are sums of
+// multiples of G_t that stay exact below DF_REPRO_MAX_LEN values, so the bins
+// do not depend on the order of the additions : blocks, CPEs, threads and ranks
+// can be merged in any order and give the same bits.
+// the top bin follows the largest |value|, raising an accumulator drops the
+// bins that fall under the lowest one, which is what a single sweep over all the
+// values keeps too. the result is the sum of the values rounded to the grain of
+// the lowest bin, 2^-50 to 2^-77 of the largest |value|.
+//
+// the values have to be computed the same way everywhere (no FMA contraction,
+// no -ffast-math, which would also fold (x + M) - M), |value| < 2^987,
+// the grain never goes under 2^-1014
+
+static inline int repro_floor_div(int a, int b){
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+static inline void repro_init(df_repro_t* acc){
+    int k;
+    acc->top = DF_REPRO_EMPTY;
+    for(k = 0; k < DF_REPRO_BINS; ++k){
+        acc->bin[k] = 0.;
+    }
+}
+
+// smallest top with R_top+1(x) = 0 for every |x| <= absmax
+static inline int repro_top(scalar absmax){
+    int e;
+    int top;
+    if(!(absmax > 0.)){
+        return DF_REPRO_EMPTY;
+    }
+    frexp(absmax, &e);      // absmax < 2^e <= G_top+1 / 2
+    top = repro_floor_div(e, DF_REPRO_WIDTH);
+    top = top < DF_REPRO_MIN_TOP ? DF_REPRO_MIN_TOP : top;
+    return top > DF_REPRO_MAX_TOP ? DF_REPRO_MAX_TOP : top;
+}
+
+// M_t of bin t, the extraction constant
+static inline scalar repro_bound(int t){
+    return ldexp(1.5, DF_REPRO_WIDTH * t + 52);
+}
+
+// moves the bins of acc under a top >= acc->top
+static inline void repro_raise(df_repro_t* acc, int top){
+    int shift = top - (int)acc->top;
+    int k;
+    if(shift <= 0){
+        return;
+    }
+    for(k = DF_REPRO_BINS - 1; k >= 0; --k){
+        acc->bin[k] = k >= shift ? acc->bin[k - shift] : 0.;
+    }
+    acc->top = top;
+}
+
+// acc += in, exact
+static inline void repro_merge(df_repro_t* acc, const df_repro_t* in){
+    int shift;
+    int k;
+    if((int)in->top == DF_REPRO_EMPTY){
+        return;
+    }
+    repro_raise(acc, (int)in->top);
+    shift = (int)acc->top - (int)in->top;
+    for(k = 0; k + shift < DF_REPRO_BINS; ++k){
+        acc->bin[k + shift] += in->bin[k];
+    }
+}
+
+// deposits value[0, len) in acc
+static inline void repro_deposit(df_repro_t* acc, const scalar* value, label len){
+    scalar absmax = 0.;
+    scalar bound[DF_REPRO_BINS];
+    scalar sum[DF_REPRO_BINS];
+    label i;
+    int k;
+
+    for(i = 0; i < len; ++i){
+        scalar v = fabs(value[i]);
+        absmax = v > absmax ? v : absmax;
+    }
+    repro_raise(acc, repro_top(absmax));
+    if((int)acc->top == DF_REPRO_EMPTY){
+        return;
+    }
+    for(k = 0; k < DF_REPRO_BINS; ++k){
+        bound[k] = repro_bound((int)acc->top - k);
+        sum[k] = 0.;
+    }
+    for(i = 0; i < len; ++i){
+        scalar r = value[i];
+        for(k = 0; k < DF_REPRO_BINS; ++k){
+            scalar q = (r + bound[k]) - bound[k];
+            sum[k] += q;
+            r -= q;
+        }
+    }
+    for(k = 0; k < DF_REPRO_BINS; ++k){
+        acc->bin[k] += sum[k];
+    }
+}
+
+// the sum, lowest bin first
+static inline scalar repro_value(const df_repro_t* acc){
+    scalar ret = 0.;
+    int k;
+    for(k = DF_REPRO_BINS - 1; k >= 0; --k){
+        ret += acc->bin[k];
+    }
+    return ret;
+}
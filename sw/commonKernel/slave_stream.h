@@ -0,0 +1,145 @@
+#pragma once
+
+#include "slave_utils.h"
+
+// streaming tiles for the slave kernels, the CRTS_dma_iget / CRTS_dma_wait_value
+// prefetch of bias_gelu over STREAM_BUFFERS buffers :
+// the local range of a CPE is cut in tiles of STREAM_TILE elements, tile t
+// lives in buffer t % STREAM_BUFFERS. the gets of the next tiles and the put of
+// the previous ones run while tile t is computed
+//
+//     slave_stream_t stream;
+//     stream_init(&stream, local_len);
+//     stream_add_in(&stream, local_x);             // buffer[0]
+//     stream_add_in(&stream, local_y);             // buffer[1]
+//     stream_set_out(&stream, local_y, 1);         // buffer[1] goes back to y
+//     stream_start(&stream);
+//     for(label t = 0; t < stream.tile_count; ++t){
+//         scalar* buffer[STREAM_MAX_IN];
+//         label n = stream_tile_begin(&stream, t, buffer);
+//         ... buffer[k][0, n) ...
+//         stream_tile_end(&stream, t);
+//     }
+//     stream_finish(&stream);
+//
+// the slave_stream_t holds the buffers, STREAM_BUFFERS * STREAM_MAX_IN *
+// STREAM_TILE scalars of LDM when it is a local of the kernel : a kernel
+// defines STREAM_MAX_IN (arrays read per tile) before the include.
+// each buffer has its own reply counters, so a wait never depends on the
+// completion order of the DMA requests
+
+#ifndef STREAM_MAX_IN
+#define STREAM_MAX_IN 3
+#endif
+
+#ifndef STREAM_BUFFERS
+#define STREAM_BUFFERS 3
+#endif
+
+#ifndef STREAM_TILE
+#define STREAM_TILE 1024
+#endif
+
+typedef struct{
+    scalar* in[STREAM_MAX_IN];              // local part in main memory
+    int in_count;
+    scalar* out;                            // NULL : nothing written back
+    int out_index;                          // the buffer of in[out_index] is put to out
+    label len;
+    label tile_count;
+    label depth;                            // tiles fetched ahead of the computed one
+    crts_rply_t get_reply[STREAM_BUFFERS];
+    crts_rply_t put_reply[STREAM_BUFFERS];
+    int get_issued[STREAM_BUFFERS];
+    int put_issued[STREAM_BUFFERS];
+    scalar buffer[STREAM_BUFFERS][STREAM_MAX_IN][STREAM_TILE];
+} slave_stream_t;
+
+static inline void stream_init(slave_stream_t* s, label len){
+    int b;
+    s->in_count = 0;
+    s->out = NULL;
+    s->out_index = 0;
+    s->len = len;
+    s->tile_count = slave_div_ceil(len, STREAM_TILE);
+    s->depth = 0;
+    for(b = 0; b < STREAM_BUFFERS; ++b){
+        s->get_reply[b] = 0;
+        s->put_reply[b] = 0;
+        s->get_issued[b] = 0;
+        s->put_issued[b] = 0;
+    }
+}
+
+// returns the index of the tile buffer of in
+static inline int stream_add_in(slave_stream_t* s, const scalar* in){
+    s->in[s->in_count] = (scalar*)in;
+    return s->in_count++;
+}
+
+// the tile buffer index (computed in place) is put to out after each tile
+static inline void stream_set_out(slave_stream_t* s, scalar* out, int index){
+    s->out = out;
+    s->out_index = index;
+}
+
+static inline label stream_tile_len(const slave_stream_t* s, label t){
+    return slave_min(s->len - t * STREAM_TILE, STREAM_TILE);
+}
+
+// gets of tile t, once the put of the tile that had the buffer is done
+static inline void stream_fetch(slave_stream_t* s, label t){
+    int b = t % STREAM_BUFFERS;
+    label offset = t * STREAM_TILE;
+    label n = stream_tile_len(s, t);
+    int k;
+    CRTS_dma_wait_value(&s->put_reply[b], s->put_issued[b]);
+    for(k = 0; k < s->in_count; ++k){
+        CRTS_dma_iget(s->buffer[b][k], s->in[k] + offset, n * sizeof(scalar), &s->get_reply[b]);
+    }
+    s->get_issued[b] += s->in_count;
+}
+
+// with an output the buffer of the tile before has its put in flight, so one
+// buffer less is fetched ahead and the fetch does not wait on that put
+static inline void stream_start(slave_stream_t* s){
+    label t;
+    s->depth = s->out != NULL ? STREAM_BUFFERS - 2 : STREAM_BUFFERS - 1;
+    s->depth = slave_max(s->depth, 1);
+    for(t = 0; t < s->depth && t < s->tile_count; ++t){
+        stream_fetch(s, t);
+    }
+}
+
+// fetches tile t + depth, waits for tile t, buffer[k] = tile t of in[k]
+// (all STREAM_MAX_IN entries are set), returns the tile length
+static inline label stream_tile_begin(slave_stream_t* s, label t, scalar** buffer){
+    int b = t % STREAM_BUFFERS;
+    int k;
+    if(t + s->depth < s->tile_count){
+        stream_fetch(s, t + s->depth);
+    }
+    CRTS_dma_wait_value(&s->get_reply[b], s->get_issued[b]);
+    for(k = 0; k < STREAM_MAX_IN; ++k){
+        buffer[k] = s->buffer[b][k];
+    }
+    return stream_tile_len(s, t);
+}
+
+// puts tile t to out
+static inline void stream_tile_end(slave_stream_t* s, label t){
+    int b = t % STREAM_BUFFERS;
+    if(s->out == NULL){
+        return;
+    }
+    CRTS_dma_iput(s->out + t * STREAM_TILE, s->buffer[b][s->out_index], stream_tile_len(s, t) * sizeof(scalar), &s->put_reply[b]);
+    s->put_issued[b] += 1;
+}
+
+// waits for the last puts
+static inline void stream_finish(slave_stream_t* s){
+    int b;
+    for(b = 0; b < STREAM_BUFFERS; ++b){
+        CRTS_dma_wait_value(&s->put_reply[b], s->put_issued[b]);
+    }
+}
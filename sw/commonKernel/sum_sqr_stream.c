@@ -0,0 +1,42 @@
+#define STREAM_MAX_IN 1
+
+#include "common_slave_function.h"
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+void sum_sqr_stream(sum_sqr_param_t* para_p){
+    sum_sqr_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(sum_sqr_param_t));
+
+    scalar* ret_p = para.ret_p;
+    const scalar* input = para.input;
+    const label len = para.len;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, input + local_start);
+    stream_start(&stream);
+
+    scalar local = 0.;
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        label brl = stream_tile_begin(&stream, t, buffer);
+        const scalar* input_buffer = buffer[0];
+        for(label i = 0; i < brl; ++i){
+            local += input_buffer[i] * input_buffer[i];
+        }
+        stream_tile_end(&stream, t);
+    }
+
+    scalar ret = reduce_rma(local);
+
+    if(CRTS_tid == 0){
+        CRTS_dma_put(ret_p, &ret, sizeof(scalar));
+    }
+}
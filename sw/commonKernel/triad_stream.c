@@ -0,0 +1,55 @@
+#define STREAM_MAX_IN 3
+
+#include "common_slave_param.h"
+#include "slave_stream.h"
+
+void triad_stream(triad_param_t* para_p){
+    triad_param_t para;
+
+    CRTS_dma_get(&para, para_p, sizeof(triad_param_t));
+
+    scalar* z = para.z;
+    const scalar* x = para.x;
+    const scalar* y = para.y;
+    const scalar alpha = para.alpha;
+    const scalar beta = para.beta;
+    const scalar gamma = para.gamma;
+    label len = para.len;
+
+    label local_start = LOCAL_START(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_end = LOCAL_END(len, CRTS_tid, CRTS_MAX_SPE_NUM);
+    label local_len = local_end - local_start;
+
+    // z is only read for gamma != 0, the result goes to the x buffer otherwise
+    slave_stream_t stream;
+    stream_init(&stream, local_len);
+    stream_add_in(&stream, x + local_start);
+    stream_add_in(&stream, y + local_start);
+    if(gamma != 0.){
+        stream_add_in(&stream, z + local_start);
+        stream_set_out(&stream, z + local_start, 2);
+    }else{
+        stream_set_out(&stream, z + local_start, 0);
+    }
+    stream_start(&stream);
+
+    for(label t = 0; t < stream.tile_count; ++t){
+        scalar* buffer[STREAM_MAX_IN];
+        label brl = stream_tile_begin(&stream, t, buffer);
+        scalar* x_buffer = buffer[0];
+        const scalar* y_buffer = buffer[1];
+        if(gamma != 0.){
+            scalar* z_buffer = buffer[2];
+            for(label i = 0; i < brl; ++i){
+                z_buffer[i] = alpha * x_buffer[i] + beta * y_buffer[i] + gamma * z_buffer[i];
+            }
+        }else{
+            for(label i = 0; i < brl; ++i){
+                x_buffer[i] = alpha * x_buffer[i] + beta * y_buffer[i];
+            }
+        }
+        stream_tile_end(&stream, t);
+    }
+
+    stream_finish(&stream);
+}
@@ -0,0 +1,24 @@
+#!/bin/bash
+
+# x86 build of the demos : the slave kernels run on the CRTS emulation of
+# ../crts_emu (64 CPE threads), run with ./main_emu.bin
+
+EMU="-D__sw_64__ -I../crts_emu"
+
+CC=mpicc
+CXX=mpicxx
+CFLAGS="-O2 -g $EMU"
+
+set -ex
+
+rm -f main_emu.bin
+
+$CC $CFLAGS -c -o crts_emu.o ../crts_emu/crts_emu.c
+# kernel f is spawned as SLAVE_FUN(f) = slave_f, the name the slave compiler gives it
+for f in ssync_demo axpy_naive ldm_info_demo rma_demo fp16_demo; do
+    $CC $CFLAGS -D__sw_slave__ -D$f=slave_$f -c -o $f.emu.o ./$f.slave.c
+done
+
+$CXX $CFLAGS -D__sw_host__ -o main_emu.bin ./main.cpp *.emu.o crts_emu.o -lpthread -lm
+
+rm -f *.emu.o crts_emu.o
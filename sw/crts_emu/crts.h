@@ -0,0 +1,135 @@
+#pragma once
+
+// x86 emulation of the CRTS athread / DMA / RMA interface of the Sunway CPEs,
+// put this directory first on the include path (with -D__sw_64__ so the
+// sources take their Sunway paths) and link crts_emu.c, see
+// commonKernel/build_emu.sh, cpe_demo/build_emu.sh, swfp16/build_emu.sh,
+// bias_gelu/build_emu.sh
+//
+// - the 64 CPEs are a pool of pthreads, CPE t runs on its own stack, the LDM
+//   arena of CPE t : local arrays and __thread_local data of a kernel have to
+//   fit in CRTS_EMU_LDM_SIZE bytes (default 256 KB), checked after every spawn.
+//   a stack deeper than the checked window aborts, one that leaves its 4 MB
+//   arena hits a PROT_NONE guard before the arena of the next CPE
+// - DMA is memcpy, CRTS_dma_iget / iput are queued and done in order by
+//   CRTS_dma_wait_value or the next ssync, so a buffer used before its wait
+//   gives wrong results as on the machine. requests still queued when the
+//   kernel returns are dropped with a warning
+// - RMA copies between the LDM arenas, an address of the caller's LDM names
+//   the same offset in the LDM of the peer. reply counters are atomics
+// - ssync_array / row / col are barriers, ssync_peer a pairwise handshake
+// - CRTS_rank / size / node_rank / node_size / jobid come from the environment
+//   of the MPI launcher, there is no LDM cache and no shared LDM
+// - float16 is _Float16 on the slave side (-D__sw_slave__, the host side
+//   keeps its short), simd.h of this directory is a scalar shim
+//
+// DMA bytes / requests, RMA messages / bytes, ssync and LDM use are counted
+// per kernel and printed at exit (CRTS_EMU_STATS=0 to turn off)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <assert.h>
+
+#define CRTS_EMU 1
+
+#define CRTS_MAX_SPE_NUM 64
+
+// per CPE data lives in the LDM arena (thread local storage of the CPE)
+#define __thread_local __thread
+
+// the slave compiler prefixes the kernels with slave_ : the emu builds
+// compile each kernel source with -D<kernel>=slave_<kernel>
+#define SLAVE_FUN(x) slave_##x
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef volatile int crts_rply_t;
+
+extern __thread int crts_emu_tid;
+
+#define CRTS_tid crts_emu_tid
+#define CRTS_cid (crts_emu_tid % 8)    // column of the 8 x 8 CPE array
+#define CRTS_rid (crts_emu_tid / 8)    // row
+
+// process of the job, set by CRTS_init from OMPI_COMM_WORLD_* / PMI_* (MPICH),
+// the job id from LSB_JOBID / SLURM_JOB_ID, 0 / 1 without a launcher
+extern long crts_emu_rank;
+extern long crts_emu_size;
+extern long crts_emu_node_rank;
+extern long crts_emu_node_size;
+extern long crts_emu_jobid;
+
+#define CRTS_rank crts_emu_rank
+#define CRTS_size crts_emu_size
+#define CRTS_node_rank crts_emu_node_rank
+#define CRTS_node_size crts_emu_node_size
+#define CRTS_jobid crts_emu_jobid
+
+// the LDM is all local memory : no LDM cache (bsub -cache_size 0), not shared
+#define _cache_size 0L
+#define _ldm_share_mode 0L
+#define _ldm_share_size 0L
+
+#ifdef __sw_slave__
+// half precision of the CPEs, the same bits as the short of the host side
+typedef _Float16 float16;
+#endif
+
+// host side
+
+void CRTS_init(void);
+
+// fn runs on the 64 CPEs with arg, the kernel name of the statistics is the
+// innermost identifier of the fn expression
+void crts_emu_spawn(void* fn, void* arg, const char* fn_text);
+
+#define CRTS_athread_spawn(fn, arg) crts_emu_spawn((void*)(fn), (void*)(arg), #fn)
+
+void CRTS_athread_join(void);
+
+void* libc_aligned_malloc(size_t size);
+
+void libc_aligned_free(void* p);
+
+// per kernel traffic since the start / the last reset
+void crts_emu_print_stats(void);
+
+void crts_emu_reset_stats(void);
+
+// slave side
+
+void CRTS_dma_get(void* ldm, void* mem, size_t size);
+
+void CRTS_dma_put(void* mem, void* ldm, size_t size);
+
+// queued, *reply += 1 when done
+void CRTS_dma_iget(void* ldm, void* mem, size_t size, crts_rply_t* reply);
+
+void CRTS_dma_iput(void* mem, void* ldm, size_t size, crts_rply_t* reply);
+
+// does the queued requests until *reply >= value
+void CRTS_dma_wait_value(crts_rply_t* reply, int value);
+
+// size bytes of remote in the LDM of CPE peer to local, then *local_reply += 1
+// and *remote_reply += 1 on the peer
+void CRTS_rma_iget(void* local, crts_rply_t* local_reply, size_t size, int peer, void* remote, crts_rply_t* remote_reply);
+
+// waits until *reply >= value
+void CRTS_rma_wait_value(crts_rply_t* reply, int value);
+
+void CRTS_ssync_array(void);
+
+void CRTS_ssync_row(void);
+
+void CRTS_ssync_col(void);
+
+void CRTS_ssync_peer(int peer);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,606 @@
+#define _GNU_SOURCE
+#include "crts.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <ctype.h>
+#include <link.h>
+#include <signal.h>
+#include <sys/mman.h>
+
+#define EMU_CPE_NUM CRTS_MAX_SPE_NUM
+#define EMU_ARENA_SIZE ((size_t)4 << 20)    // stack of a CPE thread, holds its LDM
+#define EMU_ARENA_GUARD ((size_t)64 << 10)  // PROT_NONE at the bottom of each arena
+#define EMU_LDM_SIZE (256 << 10)            // default CRTS_EMU_LDM_SIZE
+#define EMU_LDM_GUARD (64 << 10)            // painted under the LDM limit
+#define EMU_PROBE_GAP 1024                  // frame of the painting, above the window
+#define EMU_PAINT 0xa5a5a5a5a5a5a5a5ull
+#define EMU_DMA_QUEUE 64
+#define EMU_MAX_KERNEL 64
+#define EMU_NAME_SIZE 64
+#define EMU_SPIN_WARN (1 << 24)             // yields before a wait is reported
+
+__thread int crts_emu_tid = -1;
+
+long crts_emu_rank = 0;
+long crts_emu_size = 1;
+long crts_emu_node_rank = 0;
+long crts_emu_node_size = 1;
+long crts_emu_jobid = 0;
+
+typedef struct{
+    uint64_t spawn;
+    uint64_t get_count;
+    uint64_t get_bytes;
+    uint64_t put_count;
+    uint64_t put_bytes;
+    uint64_t rma_count;
+    uint64_t rma_bytes;
+    uint64_t ssync_count;
+    size_t ldm_max;             // stack + __thread_local bytes of one CPE
+    uint64_t pending;           // DMA requests not waited for at the end of the kernel, dropped
+} emu_counter_t;
+
+typedef struct{
+    void* dst;
+    const void* src;
+    size_t size;
+    crts_rply_t* reply;
+} emu_dma_t;
+
+typedef struct{
+    emu_counter_t counter;
+    emu_dma_t queue[EMU_DMA_QUEUE];     // ring of the queued iget / iput
+    int queue_head;
+    int queue_count;
+    char* probe;                        // stack depth of the kernel call
+    char* paint_lo;                     // [paint_lo, paint_hi) painted with EMU_PAINT
+    char* paint_hi;
+} emu_cpe_t;
+
+typedef struct{
+    char name[EMU_NAME_SIZE];
+    emu_counter_t counter;
+} emu_kernel_t;
+
+static int emu_started = 0;
+static char* emu_arena = NULL;
+static size_t emu_ldm_size = EMU_LDM_SIZE;
+static size_t emu_tls_size = 0;
+static pthread_t emu_thread[EMU_CPE_NUM];
+static emu_cpe_t emu_cpe[EMU_CPE_NUM];
+
+static pthread_mutex_t emu_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t emu_start_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t emu_done_cond = PTHREAD_COND_INITIALIZER;
+static uint64_t emu_generation = 0;
+static int emu_done = 0;
+static void (*emu_fn)(void*) = NULL;
+static void* emu_arg = NULL;
+static emu_kernel_t* emu_current = NULL;
+
+static pthread_barrier_t emu_array_barrier;
+static pthread_barrier_t emu_row_barrier[8];
+static pthread_barrier_t emu_col_barrier[8];
+static int emu_peer_sync[EMU_CPE_NUM][EMU_CPE_NUM];
+
+static emu_kernel_t emu_kernel[EMU_MAX_KERNEL];
+static int emu_kernel_count = 0;
+
+static void emu_error(const char* format, ...){
+    va_list args;
+    va_start(args, format);
+    fprintf(stderr, "crts_emu : ");
+    vfprintf(stderr, format, args);
+    fprintf(stderr, " !!!\n");
+    va_end(args);
+    abort();
+}
+
+static emu_cpe_t* emu_self(const char* what){
+    if(crts_emu_tid < 0){
+        emu_error("%s called outside of a CPE kernel", what);
+    }
+    return &emu_cpe[crts_emu_tid];
+}
+
+static char* emu_arena_of(int tid){
+    return emu_arena + (size_t)tid * EMU_ARENA_SIZE;
+}
+
+// [p, p + size) in the LDM arena of tid
+static int emu_in_ldm(int tid, const void* p, size_t size){
+    const char* lo = emu_arena_of(tid);
+    return (const char*)p >= lo && (const char*)p + size <= lo + EMU_ARENA_SIZE;
+}
+
+static int emu_in_any_ldm(const void* p){
+    return (const char*)p >= emu_arena && (const char*)p < emu_arena + (size_t)EMU_CPE_NUM * EMU_ARENA_SIZE;
+}
+
+static void emu_check_dma(const char* what, const void* ldm, const void* mem, size_t size){
+    if(!emu_in_ldm(crts_emu_tid, ldm, size)){
+        emu_error("%s on CPE %d : LDM side %p (%zu bytes) is not in the LDM of the CPE", what, crts_emu_tid, ldm, size);
+    }
+    if(emu_in_any_ldm(mem)){
+        emu_error("%s on CPE %d : memory side %p is in an LDM", what, crts_emu_tid, mem);
+    }
+}
+
+// waits until *value >= target, other CPEs share the cores
+static void emu_spin_wait(volatile int* value, int target, const char* what){
+    uint64_t spin = 0;
+    while(__atomic_load_n((int*)value, __ATOMIC_ACQUIRE) < target){
+        if(++spin == EMU_SPIN_WARN){
+            fprintf(stderr, "crts_emu : CPE %d still waits in %s (%d < %d), missing peer ?\n",
+                crts_emu_tid, what, *value, target);
+        }
+        sched_yield();
+    }
+}
+
+// --------------------------------------------------------------------------
+// LDM use : the stack window of the LDM is painted, the lowest overwritten
+// word after a kernel gives its depth
+
+static __attribute__((noinline)) char* emu_stack_probe(void){
+    return (char*)__builtin_frame_address(0);
+}
+
+static __attribute__((noinline)) void emu_paint(char* lo, char* hi){
+    for(volatile uint64_t* p = (uint64_t*)lo; p < (volatile uint64_t*)hi; ++p){
+        *p = EMU_PAINT;
+    }
+}
+
+// stack bytes of the last kernel, the window is painted again. the lowest
+// word written : the stack went below the window, its depth is unknown
+static size_t emu_stack_used(emu_cpe_t* cpe){
+    volatile uint64_t* p = (uint64_t*)cpe->paint_lo;
+    if(*p != EMU_PAINT){
+        emu_error("the stack of CPE %d overflows the %zu bytes of the painted LDM window, more than CRTS_EMU_LDM_SIZE",
+            crts_emu_tid, (size_t)(cpe->paint_hi - cpe->paint_lo));
+    }
+    while(p < (volatile uint64_t*)cpe->paint_hi && *p == EMU_PAINT){
+        ++p;
+    }
+    if(p == (volatile uint64_t*)cpe->paint_hi){
+        return 0;
+    }
+    emu_paint((char*)p, cpe->paint_hi);
+    return cpe->probe - (char*)p;
+}
+
+static int emu_tls_callback(struct dl_phdr_info* info, size_t size, void* data){
+    (void)size;
+    for(int i = 0; i < info->dlpi_phnum; ++i){
+        if(info->dlpi_phdr[i].p_type == PT_TLS){
+            *(size_t*)data = info->dlpi_phdr[i].p_memsz;
+        }
+    }
+    return 1;   // the executable only, the slave objects are linked into it
+}
+
+// --------------------------------------------------------------------------
+// DMA queue of a CPE
+
+static void emu_dma_complete(emu_cpe_t* cpe){
+    emu_dma_t* dma = &cpe->queue[cpe->queue_head];
+    memcpy(dma->dst, dma->src, dma->size);
+    *dma->reply += 1;
+    cpe->queue_head = (cpe->queue_head + 1) % EMU_DMA_QUEUE;
+    --cpe->queue_count;
+}
+
+static void emu_dma_drain(emu_cpe_t* cpe){
+    while(cpe->queue_count > 0){
+        emu_dma_complete(cpe);
+    }
+}
+
+static void emu_dma_push(emu_cpe_t* cpe, void* dst, const void* src, size_t size, crts_rply_t* reply){
+    if(cpe->queue_count == EMU_DMA_QUEUE){
+        emu_dma_complete(cpe);
+    }
+    emu_dma_t* dma = &cpe->queue[(cpe->queue_head + cpe->queue_count) % EMU_DMA_QUEUE];
+    dma->dst = dst;
+    dma->src = src;
+    dma->size = size;
+    dma->reply = reply;
+    ++cpe->queue_count;
+}
+
+// --------------------------------------------------------------------------
+// CPE pool
+
+static void* emu_worker(void* p){
+    const int tid = (int)(intptr_t)p;
+    emu_cpe_t* cpe = &emu_cpe[tid];
+    uint64_t seen = 0;
+
+    // the SIGSEGV of a stack overflow runs on a stack of its own
+    stack_t alt;
+    alt.ss_sp = malloc(SIGSTKSZ);
+    alt.ss_size = SIGSTKSZ;
+    alt.ss_flags = 0;
+    if(alt.ss_sp == NULL || sigaltstack(&alt, NULL) != 0){
+        emu_error("cannot set the signal stack of CPE %d", tid);
+    }
+
+    crts_emu_tid = tid;
+    cpe->probe = emu_stack_probe();
+    cpe->paint_hi = cpe->probe - EMU_PROBE_GAP;
+    cpe->paint_lo = cpe->paint_hi - emu_ldm_size - EMU_LDM_GUARD;
+    if(cpe->paint_lo < emu_arena_of(tid) + EMU_ARENA_GUARD || !emu_in_ldm(tid, &crts_emu_tid, sizeof(int))){
+        emu_error("the stack of CPE %d does not hold its LDM", tid);
+    }
+    emu_paint(cpe->paint_lo, cpe->paint_hi);
+
+    for(;;){
+        void (*fn)(void*);
+        void* arg;
+        pthread_mutex_lock(&emu_mutex);
+        while(emu_generation == seen){
+            pthread_cond_wait(&emu_start_cond, &emu_mutex);
+        }
+        seen = emu_generation;
+        fn = emu_fn;
+        arg = emu_arg;
+        pthread_mutex_unlock(&emu_mutex);
+
+        fn(arg);
+
+        // the LDM of the kernel frame is gone, requests not waited for are dropped
+        cpe->counter.pending = cpe->queue_count;
+        cpe->queue_count = 0;
+        cpe->counter.ldm_max = emu_stack_used(cpe) + emu_tls_size;
+
+        pthread_mutex_lock(&emu_mutex);
+        if(++emu_done == EMU_CPE_NUM){
+            pthread_cond_signal(&emu_done_cond);
+        }
+        pthread_mutex_unlock(&emu_mutex);
+    }
+    return NULL;
+}
+
+// the first of the variables that is set, value otherwise
+static long emu_env_long(long value, const char* name0, const char* name1){
+    const char* env = getenv(name0);
+    if(env == NULL){
+        env = getenv(name1);
+    }
+    return env != NULL ? atol(env) : value;
+}
+
+// a fault in the guard of an arena is a CPE stack that left its LDM arena,
+// reported on the alternate stack of the thread
+static void emu_segv_handler(int sig, siginfo_t* info, void* context){
+    (void)context;
+    const char* addr = (const char*)info->si_addr;
+    if(emu_in_any_ldm(addr) && (size_t)(addr - emu_arena) % EMU_ARENA_SIZE < EMU_ARENA_GUARD){
+        static const char message[] = "crts_emu : CPE stack overflow, a kernel ran through the guard of its LDM arena !!!\n";
+        ssize_t written = write(STDERR_FILENO, message, sizeof(message) - 1);
+        (void)written;
+        abort();
+    }
+    signal(sig, SIG_DFL);
+    raise(sig);
+}
+
+static void emu_atexit(void){
+    crts_emu_print_stats();
+}
+
+void CRTS_init(void){
+    if(emu_started){
+        return;
+    }
+    emu_started = 1;
+
+    const char* env = getenv("CRTS_EMU_LDM_SIZE");
+    if(env != NULL){
+        emu_ldm_size = (size_t)atol(env);
+    }
+    env = getenv("CRTS_EMU_STATS");
+    if(env == NULL || atoi(env) != 0){
+        atexit(emu_atexit);
+    }
+    dl_iterate_phdr(emu_tls_callback, &emu_tls_size);
+
+    crts_emu_rank = emu_env_long(0, "OMPI_COMM_WORLD_RANK", "PMI_RANK");
+    crts_emu_size = emu_env_long(1, "OMPI_COMM_WORLD_SIZE", "PMI_SIZE");
+    crts_emu_node_rank = emu_env_long(0, "OMPI_COMM_WORLD_LOCAL_RANK", "MPI_LOCALRANKID");
+    crts_emu_node_size = emu_env_long(1, "OMPI_COMM_WORLD_LOCAL_SIZE", "MPI_LOCALNRANKS");
+    crts_emu_jobid = emu_env_long(0, "LSB_JOBID", "SLURM_JOB_ID");
+
+    emu_arena = (char*)mmap(NULL, (size_t)EMU_CPE_NUM * EMU_ARENA_SIZE, PROT_READ | PROT_WRITE,
+        MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if(emu_arena == MAP_FAILED){
+        emu_error("cannot map the LDM arenas");
+    }
+    // a stack that grows out of its arena faults instead of writing the LDM
+    // of the CPE below
+    for(int tid = 0; tid < EMU_CPE_NUM; ++tid){
+        if(mprotect(emu_arena_of(tid), EMU_ARENA_GUARD, PROT_NONE) != 0){
+            emu_error("cannot protect the guard of the arena of CPE %d", tid);
+        }
+    }
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = emu_segv_handler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, NULL);
+
+    pthread_barrier_init(&emu_array_barrier, NULL, EMU_CPE_NUM);
+    for(int i = 0; i < 8; ++i){
+        pthread_barrier_init(&emu_row_barrier[i], NULL, 8);
+        pthread_barrier_init(&emu_col_barrier[i], NULL, 8);
+    }
+
+    for(int tid = 0; tid < EMU_CPE_NUM; ++tid){
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setstack(&attr, emu_arena_of(tid) + EMU_ARENA_GUARD, EMU_ARENA_SIZE - EMU_ARENA_GUARD);
+        if(pthread_create(&emu_thread[tid], &attr, emu_worker, (void*)(intptr_t)tid) != 0){
+            emu_error("cannot start the thread of CPE %d", tid);
+        }
+        pthread_attr_destroy(&attr);
+    }
+}
+
+// the first identifier followed by ')' or the end of fn_text :
+// "reinterpret_cast<void *>(SLAVE_FUN(axpy_naive))" -> axpy_naive
+static void emu_kernel_name(char* name, const char* fn_text){
+    const char* p = fn_text;
+    const char* best = fn_text;
+    size_t best_len = strlen(fn_text);
+    while(*p){
+        if(isalpha((unsigned char)*p) || *p == '_'){
+            const char* begin = p;
+            while(isalnum((unsigned char)*p) || *p == '_'){
+                ++p;
+            }
+            const char* next = p;
+            while(isspace((unsigned char)*next)){
+                ++next;
+            }
+            if(*next == ')' || *next == '\0'){
+                best = begin;
+                best_len = p - begin;
+                break;
+            }
+        }else{
+            ++p;
+        }
+    }
+    if(best_len >= EMU_NAME_SIZE){
+        best_len = EMU_NAME_SIZE - 1;
+    }
+    memcpy(name, best, best_len);
+    name[best_len] = '\0';
+}
+
+static emu_kernel_t* emu_find_kernel(const char* fn_text){
+    char name[EMU_NAME_SIZE];
+    emu_kernel_name(name, fn_text);
+    for(int k = 0; k < emu_kernel_count; ++k){
+        if(strcmp(emu_kernel[k].name, name) == 0){
+            return &emu_kernel[k];
+        }
+    }
+    if(emu_kernel_count == EMU_MAX_KERNEL){
+        emu_error("more than %d kernels", EMU_MAX_KERNEL);
+    }
+    emu_kernel_t* kernel = &emu_kernel[emu_kernel_count++];
+    memset(kernel, 0, sizeof(emu_kernel_t));
+    strcpy(kernel->name, name);
+    return kernel;
+}
+
+void crts_emu_spawn(void* fn, void* arg, const char* fn_text){
+    CRTS_init();
+    if(emu_current != NULL){
+        emu_error("CRTS_athread_spawn of %s before the join of %s", fn_text, emu_current->name);
+    }
+    emu_current = emu_find_kernel(fn_text);
+    memset(emu_peer_sync, 0, sizeof(emu_peer_sync));
+    for(int tid = 0; tid < EMU_CPE_NUM; ++tid){
+        memset(&emu_cpe[tid].counter, 0, sizeof(emu_counter_t));
+    }
+
+    pthread_mutex_lock(&emu_mutex);
+    emu_fn = (void (*)(void*))fn;
+    emu_arg = arg;
+    emu_done = 0;
+    ++emu_generation;
+    pthread_cond_broadcast(&emu_start_cond);
+    pthread_mutex_unlock(&emu_mutex);
+}
+
+void CRTS_athread_join(void){
+    if(emu_current == NULL){
+        return;
+    }
+    pthread_mutex_lock(&emu_mutex);
+    while(emu_done < EMU_CPE_NUM){
+        pthread_cond_wait(&emu_done_cond, &emu_mutex);
+    }
+    pthread_mutex_unlock(&emu_mutex);
+
+    emu_counter_t* total = &emu_current->counter;
+    size_t ldm_max = 0;
+    int ldm_tid = 0;
+    uint64_t pending = 0;
+    ++total->spawn;
+    for(int tid = 0; tid < EMU_CPE_NUM; ++tid){
+        const emu_counter_t* c = &emu_cpe[tid].counter;
+        total->get_count += c->get_count;
+        total->get_bytes += c->get_bytes;
+        total->put_count += c->put_count;
+        total->put_bytes += c->put_bytes;
+        total->rma_count += c->rma_count;
+        total->rma_bytes += c->rma_bytes;
+        total->ssync_count += c->ssync_count;
+        pending += c->pending;
+        if(c->ldm_max > ldm_max){
+            ldm_max = c->ldm_max;
+            ldm_tid = tid;
+        }
+    }
+    if(ldm_max > total->ldm_max){
+        total->ldm_max = ldm_max;
+    }
+    if(pending > 0 && total->pending == 0){
+        fprintf(stderr, "crts_emu : Warning : %s ends with %lu DMA requests not waited for, dropped\n",
+            emu_current->name, (unsigned long)pending);
+    }
+    total->pending += pending;
+    if(ldm_max > emu_ldm_size){
+        emu_error("%s uses %zu bytes of LDM on CPE %d, more than the %zu of CRTS_EMU_LDM_SIZE",
+            emu_current->name, ldm_max, ldm_tid, emu_ldm_size);
+    }
+    emu_current = NULL;
+}
+
+void* libc_aligned_malloc(size_t size){
+    void* p = NULL;
+    if(posix_memalign(&p, 64, size) != 0){
+        return NULL;
+    }
+    return p;
+}
+
+void libc_aligned_free(void* p){
+    free(p);
+}
+
+void crts_emu_print_stats(void){
+    if(emu_kernel_count == 0){
+        return;
+    }
+    printf("-------------------------------------------------\n");
+    printf("crts_emu, traffic per kernel over all spawns and CPEs\n");
+    printf("%-24s %7s %10s %10s %10s %10s %10s %8s %8s %8s\n", "kernel", "spawns", "get MB", "put MB",
+        "DMA reqs", "MB/spawn", "RMA msgs", "RMA KB", "ssync", "LDM KB");
+    for(int k = 0; k < emu_kernel_count; ++k){
+        const emu_counter_t* c = &emu_kernel[k].counter;
+        const double spawn = c->spawn > 0 ? (double)c->spawn : 1.;
+        printf("%-24s %7lu %10.3f %10.3f %10lu %10.3f %10lu %8.3f %8lu %8.1f\n", emu_kernel[k].name,
+            (unsigned long)c->spawn, c->get_bytes * 1e-6, c->put_bytes * 1e-6,
+            (unsigned long)(c->get_count + c->put_count), (c->get_bytes + c->put_bytes) * 1e-6 / spawn,
+            (unsigned long)c->rma_count, c->rma_bytes * 1e-3, (unsigned long)c->ssync_count, c->ldm_max / 1024.);
+    }
+    printf("-------------------------------------------------\n");
+}
+
+void crts_emu_reset_stats(void){
+    for(int k = 0; k < emu_kernel_count; ++k){
+        memset(&emu_kernel[k].counter, 0, sizeof(emu_counter_t));
+    }
+}
+
+// --------------------------------------------------------------------------
+// slave side
+
+void CRTS_dma_get(void* ldm, void* mem, size_t size){
+    emu_cpe_t* cpe = emu_self("CRTS_dma_get");
+    emu_check_dma("CRTS_dma_get", ldm, mem, size);
+    memcpy(ldm, mem, size);
+    ++cpe->counter.get_count;
+    cpe->counter.get_bytes += size;
+}
+
+void CRTS_dma_put(void* mem, void* ldm, size_t size){
+    emu_cpe_t* cpe = emu_self("CRTS_dma_put");
+    emu_check_dma("CRTS_dma_put", ldm, mem, size);
+    memcpy(mem, ldm, size);
+    ++cpe->counter.put_count;
+    cpe->counter.put_bytes += size;
+}
+
+void CRTS_dma_iget(void* ldm, void* mem, size_t size, crts_rply_t* reply){
+    emu_cpe_t* cpe = emu_self("CRTS_dma_iget");
+    emu_check_dma("CRTS_dma_iget", ldm, mem, size);
+    emu_dma_push(cpe, ldm, mem, size, reply);
+    ++cpe->counter.get_count;
+    cpe->counter.get_bytes += size;
+}
+
+void CRTS_dma_iput(void* mem, void* ldm, size_t size, crts_rply_t* reply){
+    emu_cpe_t* cpe = emu_self("CRTS_dma_iput");
+    emu_check_dma("CRTS_dma_iput", ldm, mem, size);
+    emu_dma_push(cpe, mem, ldm, size, reply);
+    ++cpe->counter.put_count;
+    cpe->counter.put_bytes += size;
+}
+
+void CRTS_dma_wait_value(crts_rply_t* reply, int value){
+    emu_cpe_t* cpe = emu_self("CRTS_dma_wait_value");
+    while(*reply < value){
+        if(cpe->queue_count == 0){
+            emu_error("CRTS_dma_wait_value on CPE %d : reply %d never reaches %d", crts_emu_tid, *reply, value);
+        }
+        emu_dma_complete(cpe);
+    }
+}
+
+void CRTS_rma_iget(void* local, crts_rply_t* local_reply, size_t size, int peer, void* remote, crts_rply_t* remote_reply){
+    emu_cpe_t* cpe = emu_self("CRTS_rma_iget");
+    const int tid = crts_emu_tid;
+    if(peer < 0 || peer >= EMU_CPE_NUM){
+        emu_error("CRTS_rma_iget on CPE %d : peer %d", tid, peer);
+    }
+    if(!emu_in_ldm(tid, local, size) || !emu_in_ldm(tid, remote, size) || !emu_in_ldm(tid, (const void*)remote_reply, sizeof(int))){
+        emu_error("CRTS_rma_iget on CPE %d : buffers and replies have to be LDM addresses", tid);
+    }
+    // the same LDM offset on the peer
+    const ptrdiff_t shift = (ptrdiff_t)(peer - tid) * (ptrdiff_t)EMU_ARENA_SIZE;
+    memcpy(local, (const char*)remote + shift, size);
+    __atomic_fetch_add((int*)((char*)remote_reply + shift), 1, __ATOMIC_RELEASE);
+    __atomic_fetch_add((int*)local_reply, 1, __ATOMIC_RELEASE);
+    ++cpe->counter.rma_count;
+    cpe->counter.rma_bytes += size;
+}
+
+void CRTS_rma_wait_value(crts_rply_t* reply, int value){
+    emu_self("CRTS_rma_wait_value");
+    emu_spin_wait(reply, value, "CRTS_rma_wait_value");
+}
+
+// an ssync also completes the queued DMA of the CPE
+
+void CRTS_ssync_array(void){
+    emu_cpe_t* cpe = emu_self("CRTS_ssync_array");
+    emu_dma_drain(cpe);
+    ++cpe->counter.ssync_count;
+    pthread_barrier_wait(&emu_array_barrier);
+}
+
+void CRTS_ssync_row(void){
+    emu_cpe_t* cpe = emu_self("CRTS_ssync_row");
+    emu_dma_drain(cpe);
+    ++cpe->counter.ssync_count;
+    pthread_barrier_wait(&emu_row_barrier[CRTS_rid]);
+}
+
+void CRTS_ssync_col(void){
+    emu_cpe_t* cpe = emu_self("CRTS_ssync_col");
+    emu_dma_drain(cpe);
+    ++cpe->counter.ssync_count;
+    pthread_barrier_wait(&emu_col_barrier[CRTS_cid]);
+}
+
+void CRTS_ssync_peer(int peer){
+    emu_cpe_t* cpe = emu_self("CRTS_ssync_peer");
+    const int tid = crts_emu_tid;
+    if(peer < 0 || peer >= EMU_CPE_NUM){
+        emu_error("CRTS_ssync_peer on CPE %d : peer %d", tid, peer);
+    }
+    emu_dma_drain(cpe);
+    ++cpe->counter.ssync_count;
+    const int generation = __atomic_add_fetch(&emu_peer_sync[tid][peer], 1, __ATOMIC_ACQ_REL);
+    emu_spin_wait(&emu_peer_sync[peer][tid], generation, "CRTS_ssync_peer");
+}
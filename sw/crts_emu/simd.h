@@ -0,0 +1,64 @@
+#pragma once
+
+// scalar shim of the CPE simd.h for crts_emu : the vector types are GCC
+// vectors of the same width, the intrinsics used by the kernels are loops or
+// vector operators. only what the sources of this tree call is here
+
+#include <string.h>
+#include "crts.h"
+
+// the vectors are passed by value between inline functions only
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+typedef double doublev8 __attribute__((vector_size(64)));
+typedef float floatv8 __attribute__((vector_size(32)));
+typedef int intv16 __attribute__((vector_size(64)));
+#ifdef __sw_slave__
+typedef float16 float16v32 __attribute__((vector_size(64)));
+#endif
+
+// no alignment is required on x86, simd_load / simd_loadu are the same
+#define simd_load(v, p) memcpy(&(v), (p), sizeof(v))
+#define simd_loadu(v, p) memcpy(&(v), (p), sizeof(v))
+#define simd_store(v, p) memcpy((p), &(v), sizeof(v))
+#define simd_storeu(v, p) memcpy((p), &(v), sizeof(v))
+
+// T : scalar, V : vector, N : lanes, S : suffix of the intrinsics
+#define SIMD_EMU_DEFINE(T, V, N, S, CPY, EXT)                                   \
+static inline V CPY(T x){                                                      \
+    V v;                                                                        \
+    int k;                                                                      \
+    for(k = 0; k < N; ++k){                                                     \
+        v[k] = x;                                                               \
+    }                                                                           \
+    return v;                                                                   \
+}                                                                               \
+static inline T EXT(V v, int k){                                               \
+    return v[k];                                                                \
+}                                                                               \
+static inline V simd_vadd##S(V a, V b){ return a + b; }                         \
+static inline V simd_vsub##S(V a, V b){ return a - b; }                         \
+static inline V simd_vmul##S(V a, V b){ return a * b; }                         \
+static inline V simd_vdiv##S(V a, V b){ return a / b; }                         \
+static inline V simd_smax##S(V a, V b){                                         \
+    int k;                                                                      \
+    for(k = 0; k < N; ++k){                                                     \
+        a[k] = a[k] < b[k] ? b[k] : a[k];                                       \
+    }                                                                           \
+    return a;                                                                   \
+}                                                                               \
+static inline V simd_smin##S(V a, V b){                                         \
+    int k;                                                                      \
+    for(k = 0; k < N; ++k){                                                     \
+        a[k] = b[k] < a[k] ? b[k] : a[k];                                       \
+    }                                                                           \
+    return a;                                                                   \
+}
+
+SIMD_EMU_DEFINE(double, doublev8, 8, d, simd_vcpyfd, simd_vextfd)
+SIMD_EMU_DEFINE(float, floatv8, 8, s, simd_vcpyfs, simd_vextfs)
+#ifdef __sw_slave__
+SIMD_EMU_DEFINE(float16, float16v32, 32, h, simd_vcpyh, simd_vexth)
+#endif
+
+#undef SIMD_EMU_DEFINE
@@ -7,5 +7,15 @@ int main(){
     COO<int64_t, double> coo = read_coo_from_pattern_mtx(filename);
     CSR<int64_t, double> csr(coo);
     csr.spmv_benchmark();
+    DIV<int64_t, double> div(coo);
+    div.print_info();
+    div.spmv_benchmark(csr);
+
+    // int32 indices and float values
+    COO<int32_t, float> coo_i32_f32(coo);
+    CSR<int32_t, float> csr_i32_f32(coo_i32_f32);
+    csr_i32_f32.spmv_benchmark();
+    DIV<int32_t, float> div_i32_f32(coo_i32_f32);
+    div_i32_f32.spmv_benchmark(csr_i32_f32);
     return 0;
 }
@@ -10,6 +10,7 @@
 #include <tuple>
 #include <algorithm>
 #include <stdexcept>
+#include <limits>
 #include <cassert>
 #ifndef _OPENMP
 #error "must open -fopenmp flag!!!"
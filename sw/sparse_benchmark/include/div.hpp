@@ -2,15 +2,21 @@
 
 #include "common.hpp"
 #include "coo.hpp"
+#include "csr.hpp"
+#include <memory>
 
 #define ROW_BLOCK_BIT 5
 
+// above this many distinct distances (env DIV_MAX_DISTANCE_COUNT) the padded
+// diagonals cost more than CSR, the matrix is kept in CSR instead
+#define DIV_MAX_DISTANCE_COUNT 64
+
 #define DIV_BLOCK_MASK ((1 << (row_block_bit_)) - 1)
 #define DIV_BLOCK_MASK_INVERSE (~DIV_BLOCK_MASK)
 
 #define DIV_BLOCK_INDEX(row) ((row) >> (row_block_bit_))
 #define DIV_BLOCK_ROW(row) ((row) & DIV_BLOCK_MASK)
-#define DIV_BLOCK_START(bi) (bi << row_block_bit_)
+#define DIV_BLOCK_START(bi) ((bi) << row_block_bit_)
 // #define DIV_BLOCK_END(rbs) (std::min((rbs) + (row_block_size_), (row_)))
 #define DIV_BLOCK_END(rbs) ((rbs) + (row_block_size_))
 // #define DIV_BLOCK_LEN(rbs,rbe) ((rbe - rbs))
@@ -22,7 +28,13 @@
 #define DIV_COL_OFFSET(divcol) ((divcol) << (row_block_bit_))
 #define DIV_INDEX(row,divcol) (((row) & (DIV_BLOCK_MASK_INVERSE)) * (distance_count_) + DIV_COL_OFFSET(divcol) + DIV_BLOCK_ROW(row))
 
-
+// DIV : diagonal with interleaved values
+// off diagonal entry (row, row + distance_list_[divcol]) is stored at
+// DIV_INDEX(row, divcol) : each block of row_block_size_ rows keeps its
+// distance_count_ diagonals one after another, row_block_size_ values each.
+// Column indices are implied by the distance, so SpMV only streams values.
+// Unstructured matrices (more distances than DIV_MAX_DISTANCE_COUNT) fall back
+// to CSR storage and SpMV.
 template <typename IndexType, typename ValueType>
 class DIV{
 private:
@@ -33,6 +45,7 @@ public:
     const IndexType row_block_size_;
 
     IndexType row_;
+    IndexType nnz_;
     vector<ValueType> diag_value_;
 
     IndexType block_count_; // node count 只算能整除的部分
@@ -43,15 +56,28 @@ public:
     IndexType max_distance_;
     IndexType min_distance_;
 
+    // blocks which may touch x out of [0, row_), need bounds check
     IndexType head_block_count_;
     IndexType tail_block_count_;
 
-    vector<scalar> off_diag_value_;
+    vector<ValueType> off_diag_value_;
+
+    // set when distance_count_ is over the cap, the other arrays are then empty
+    std::unique_ptr<CSR<IndexType, ValueType>> csr_fallback_;
 
-    DIV():row_(0),row_block_bit_(ROW_BLOCK_BIT),row_block_size_(1 << row_block_bit_);
+    DIV():row_block_bit_(ROW_BLOCK_BIT),row_block_size_(1 << ROW_BLOCK_BIT),row_(0),nnz_(0),block_count_(0),block_tail_(0),
+        distance_count_(0),max_distance_(0),min_distance_(0),head_block_count_(0),tail_block_count_(0){}
     
     DIV(const COO<IndexType,ValueType>& coo);
 
+    ~DIV(){}
+
+    void print_info();
+
+    // y of reference.SpMV is the reference of the residual check
+    void spmv_benchmark(CSR<IndexType, ValueType>& reference);
 
+    // y = A * x
+    void SpMV(vector<ValueType>& y, const vector<ValueType>& x);
 
-}
\ No newline at end of file
+};
@@ -2,6 +2,7 @@
 
 #include <cstdlib>
 #include <cstdio>
+#include <cstring>
 #include <cstdint>
 
 static bool env_get_bool(const char* name, bool default_value){
@@ -4,3 +4,4 @@
 #include <io.hpp>
 #include <coo.hpp>
 #include <csr.hpp>
+#include <div.hpp>
@@ -20,6 +20,23 @@ void COO<IndexType, ValueType>::sort(){
     sorted_ = true;
 }
 
+template<typename IndexType, typename ValueType>
+template<typename OtherIndexType, typename OtherValueType>
+COO<IndexType, ValueType>::COO(const COO<OtherIndexType,OtherValueType>& other)
+    :row_(other.row_), col_(other.col_), nnz_(other.nnz_), rowidx_(other.nnz_), colidx_(other.nnz_), value_(other.nnz_), sorted_(other.is_sorted()){
+    if(static_cast<int64_t>(other.row_) > static_cast<int64_t>(std::numeric_limits<IndexType>::max())
+        || static_cast<int64_t>(other.col_) > static_cast<int64_t>(std::numeric_limits<IndexType>::max())
+        || static_cast<int64_t>(other.nnz_) > static_cast<int64_t>(std::numeric_limits<IndexType>::max())){
+        cerr << "In COO<IndexType, ValueType>::COO(const COO<OtherIndexType,OtherValueType>& other), row / col / nnz overflow IndexType !!!" << endl;
+        throw std::overflow_error("IndexType overflow");
+    }
+    for(IndexType i = 0; i < nnz_; ++i){
+        rowidx_[i] = static_cast<IndexType>(other.rowidx_[i]);
+        colidx_[i] = static_cast<IndexType>(other.colidx_[i]);
+        value_[i] = static_cast<ValueType>(other.value_[i]);
+    }
+}
+
 template<typename IndexType, typename ValueType>
 void COO<IndexType, ValueType>::print_info(){
     cout << "row : " << row_ << endl;
@@ -45,4 +62,11 @@ bool COO<IndexType, ValueType>::check_sorted(){
     return sorted_;
 }
 
+template COO<int32_t, float>::COO(const COO<int64_t, double>& other);
+template COO<int32_t, double>::COO(const COO<int64_t, double>& other);
+template COO<int64_t, float>::COO(const COO<int64_t, double>& other);
+
+template class COO<int32_t, float>;
+template class COO<int32_t, double>;
+template class COO<int64_t, float>;
 template class COO<int64_t, double>;
@@ -49,5 +49,8 @@ CSR<IndexType, ValueType>::CSR(const COO<IndexType,ValueType>& coo){
     }
 }
 
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
 template class CSR<int64_t, double>;
 
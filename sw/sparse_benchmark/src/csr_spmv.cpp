@@ -6,16 +6,16 @@ template <typename IndexType, typename ValueType>
 void CSR<IndexType, ValueType>::spmv_benchmark(){
     const int repeat_count = env_get_int("REPEAT_COUNT", 10);
     // init x y
-    vector<ValueType> x(row_, 1.);
+    vector<ValueType> x(col_, 1.);
     vector<ValueType> y(row_, 0.);
     omp_timer timer;
     // warm up
-    SpMV(x, y);
+    SpMV(y, x);
 
     double time_no_warm_up = timer.timeIncrement();
 
     for(int repeat = 0; repeat < repeat_count; ++repeat){
-        SpMV(x, y);
+        SpMV(y, x);
     }
 
     double time_warm_up = timer.timeIncrement();
@@ -30,6 +30,7 @@ void CSR<IndexType, ValueType>::spmv_benchmark(){
 #ifdef _OPENMP
     cout << "thread count : " << omp_get_max_threads() << endl;
 #endif
+    cout << "index : int" << 8 * sizeof(IndexType) << ", value : " << (sizeof(ValueType) == sizeof(float) ? "float" : "double") << endl;
     cout << "with out warm up : " << endl;
     cout << "time : " << time_no_warm_up << endl;
     cout << "FLOPs : " << FLOPs << endl;
@@ -49,10 +50,15 @@ void CSR<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueTyp
     #pragma omp parallel for 
 #endif
     for(IndexType r = 0; r < row_; ++r){
+        ValueType sum = 0.;
         for(IndexType idx = rowptr_[r]; idx < rowptr_[r+1]; ++idx){
-            y[r] += value_[idx] * x[colidx_[idx]];
+            sum += value_[idx] * x[colidx_[idx]];
         }
+        y[r] = sum;
     }
 }
 
+template class CSR<int32_t, float>;
+template class CSR<int32_t, double>;
+template class CSR<int64_t, float>;
 template class CSR<int64_t, double>;
@@ -1,15 +1,113 @@
 #include "div.hpp"
+#include <set>
 
 template<typename IndexType, typename ValueType>
-DIV<IndexType, ValueType>::DIV(const COO<IndexType,ValueType>& coo){
+DIV<IndexType, ValueType>::DIV(const COO<IndexType,ValueType>& coo)
+    :row_block_bit_(ROW_BLOCK_BIT), row_block_size_(1 << ROW_BLOCK_BIT){
     if(!coo.is_sorted()){
         cerr << "In DIV<IndexType, ValueType>::DIV(const COO<IndexType,ValueType>& coo), coo have to be sorted !!!" << endl;
         throw std::invalid_argument("coo is not sorted");
     }
+    if(coo.row_ != coo.col_){
+        cerr << "In DIV<IndexType, ValueType>::DIV(const COO<IndexType,ValueType>& coo), coo have to be square !!!" << endl;
+        throw std::invalid_argument("coo is not square");
+    }
 
     row_ = coo.row_;
-    
+    nnz_ = coo.nnz_;
+
+    block_count_ = DIV_BLOCK_INDEX(row_);
+    block_tail_ = DIV_BLOCK_TAIL;
+
+    // distinct off diagonal distances (col - row), ascending
+    std::set<IndexType> distance_set;
+    for(IndexType i = 0; i < nnz_; ++i){
+        IndexType distance = coo.colidx_[i] - coo.rowidx_[i];
+        if(distance != 0){
+            distance_set.insert(distance);
+        }
+    }
+    distance_list_.assign(distance_set.begin(), distance_set.end());
+    distance_count_ = distance_list_.size();
+
+    const IndexType max_distance_count = env_get_int("DIV_MAX_DISTANCE_COUNT", DIV_MAX_DISTANCE_COUNT);
+    if(distance_count_ > max_distance_count){
+        cout << "Warning : DIV distance count " << distance_count_ << " > " << max_distance_count << ", fall back to CSR !!!" << endl;
+        csr_fallback_.reset(new CSR<IndexType, ValueType>(coo));
+        block_count_ = block_tail_ = 0;
+        min_distance_ = max_distance_ = 0;
+        head_block_count_ = tail_block_count_ = 0;
+        return;
+    }
+    min_distance_ = distance_count_ > 0 ? distance_list_.front() : 0;
+    max_distance_ = distance_count_ > 0 ? distance_list_.back() : 0;
+
+    const IndexType block_total = DIV_BLOCK_COUNT;
+    head_block_count_ = min_distance_ < 0 ? std::min(block_total, (-min_distance_ + row_block_size_ - 1) >> row_block_bit_) : 0;
+    tail_block_count_ = max_distance_ > 0 ? std::min(block_total, block_total - (std::max(row_ - max_distance_, static_cast<IndexType>(0)) >> row_block_bit_)) : 0;
+
+    // the tail block is padded to row_block_size_ rows
+    diag_value_.resize(row_);
+    off_diag_value_.resize(block_total * row_block_size_ * distance_count_);
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType r = 0; r < row_; ++r){
+        diag_value_[r] = 0.;
+    }
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < static_cast<IndexType>(off_diag_value_.size()); ++i){
+        off_diag_value_[i] = 0.;
+    }
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType i = 0; i < nnz_; ++i){
+        IndexType r = coo.rowidx_[i];
+        IndexType distance = coo.colidx_[i] - r;
+        if(distance == 0){
+            diag_value_[r] = coo.value_[i];
+        }else{
+            IndexType divcol = std::lower_bound(distance_list_.begin(), distance_list_.end(), distance) - distance_list_.begin();
+            off_diag_value_[DIV_INDEX(r, divcol)] = coo.value_[i];
+        }
+    }
 }
 
-template class DIV<int64_t, double>;
+template<typename IndexType, typename ValueType>
+void DIV<IndexType, ValueType>::print_info(){
+    const IndexType block_total = DIV_BLOCK_COUNT;
+    double csr_bytes = static_cast<double>(nnz_) * (sizeof(ValueType) + sizeof(IndexType)) + (row_ + 1.) * sizeof(IndexType);
+    if(csr_fallback_){
+        cout << "DIV (CSR fallback)" << endl;
+        cout << "row : " << row_ << endl;
+        cout << "nnz : " << nnz_ << endl;
+        cout << "distance count : " << distance_count_ << endl;
+        cout << "matrix bytes CSR : " << csr_bytes << endl;
+        return;
+    }
+    double div_bytes = static_cast<double>(row_) * sizeof(ValueType) + static_cast<double>(off_diag_value_.size()) * sizeof(ValueType);
+    cout << "DIV" << endl;
+    cout << "row : " << row_ << endl;
+    cout << "nnz : " << nnz_ << endl;
+    cout << "row block size : " << row_block_size_ << endl;
+    cout << "block count : " << block_count_ << ", tail : " << block_tail_ << endl;
+    cout << "head block count : " << head_block_count_ << ", tail block count : " << tail_block_count_ << " of " << block_total << endl;
+    cout << "distance count : " << distance_count_ << endl;
+    cout << "distance list :";
+    for(IndexType d = 0; d < distance_count_; ++d){
+        cout << " " << distance_list_[d];
+    }
+    cout << endl;
+    cout << "fill efficiency (nnz / stored) : " << static_cast<double>(nnz_) / (row_ + off_diag_value_.size()) << endl;
+    cout << "matrix bytes CSR : " << csr_bytes << ", DIV : " << div_bytes << ", ratio : " << div_bytes / csr_bytes << endl;
+}
 
+template class DIV<int32_t, float>;
+template class DIV<int32_t, double>;
+template class DIV<int64_t, float>;
+template class DIV<int64_t, double>;
@@ -0,0 +1,127 @@
+#include "div.hpp"
+#include <cmath>
+
+template <typename IndexType, typename ValueType>
+void DIV<IndexType, ValueType>::spmv_benchmark(CSR<IndexType, ValueType>& reference){
+    const int repeat_count = env_get_int("REPEAT_COUNT", 10);
+    // init x y, x varies so a wrong distance changes y
+    vector<ValueType> x(row_);
+    vector<ValueType> y(row_, 0.);
+    for(IndexType i = 0; i < row_; ++i){
+        x[i] = 1. + (i % 16) / 16.;
+    }
+    omp_timer timer;
+    // warm up
+    SpMV(y, x);
+
+    double time_no_warm_up = timer.timeIncrement();
+
+    for(int repeat = 0; repeat < repeat_count; ++repeat){
+        SpMV(y, x);
+    }
+
+    double time_warm_up = timer.timeIncrement();
+
+    // max |y - y_ref| / max |y_ref|
+    vector<ValueType> y_ref(reference.row_, 0.);
+    reference.SpMV(y_ref, x);
+    double diff = 0.;
+    double norm = 0.;
+    for(IndexType r = 0; r < row_; ++r){
+        diff = std::max(diff, std::abs(static_cast<double>(y[r]) - y_ref[r]));
+        norm = std::max(norm, std::abs(static_cast<double>(y_ref[r])));
+    }
+    const double residual = norm > 0. ? diff / norm : diff;
+    const double tolerance = 1024. * std::numeric_limits<ValueType>::epsilon();
+
+    double FLOPs = 2. * nnz_;
+    double TFLOPS = FLOPs / time_no_warm_up * 1e-12;
+
+    double FLOPs_repeat = FLOPs * repeat_count;
+    double TFLOPS_repeat = FLOPs_repeat / time_warm_up * 1e-12;
+
+    cout << "div spmv benchmark ---------" << endl;
+#ifdef _OPENMP
+    cout << "thread count : " << omp_get_max_threads() << endl;
+#endif
+    cout << "index : int" << 8 * sizeof(IndexType) << ", value : " << (sizeof(ValueType) == sizeof(float) ? "float" : "double") << endl;
+    cout << "with out warm up : " << endl;
+    cout << "time : " << time_no_warm_up << endl;
+    cout << "FLOPs : " << FLOPs << endl;
+    cout << "TFLOPS : " << TFLOPS << endl;
+    cout << "with warm up and repeat : " << endl;
+    cout << "repeat_count : " << repeat_count << endl;
+    cout << "time : " << time_warm_up << endl;
+    cout << "FLOPs : " << FLOPs_repeat << endl;
+    cout << "TFLOPS : " << TFLOPS_repeat << endl;
+    cout << "residual : " << residual << (residual <= tolerance ? " (passed)" : " (FAILED)") << endl;
+    cout << "----------------------------" << endl;
+}
+
+template <typename IndexType, typename ValueType>
+void DIV<IndexType, ValueType>::SpMV(vector<ValueType>& y, const vector<ValueType>& x){
+    if(csr_fallback_){
+        csr_fallback_->SpMV(y, x);
+        return;
+    }
+    const IndexType block_total = DIV_BLOCK_COUNT;
+    const IndexType inner_block_end = block_total - tail_block_count_;
+    const IndexType* distance_list = distance_list_.data();
+    const ValueType* diag_value = diag_value_.data();
+    const ValueType* x_ptr = x.data();
+    ValueType* y_ptr = y.data();
+
+#ifdef _OPENMP
+    #pragma omp parallel for
+#endif
+    for(IndexType bi = 0; bi < block_total; ++bi){
+        const IndexType rbs = DIV_BLOCK_START(bi);
+        const ValueType* block_value = off_diag_value_.data() + DIV_INDEX_BLOCK_START(rbs);
+        ValueType sum[1 << ROW_BLOCK_BIT];
+
+        if(bi >= head_block_count_ && bi < inner_block_end && bi < block_count_){
+            // inner block : every x[r + distance] is in range
+            #pragma omp simd
+            for(IndexType i = 0; i < (1 << ROW_BLOCK_BIT); ++i){
+                sum[i] = diag_value[rbs + i] * x_ptr[rbs + i];
+            }
+            for(IndexType divcol = 0; divcol < distance_count_; ++divcol){
+                const ValueType* value = block_value + DIV_COL_OFFSET(divcol);
+                const ValueType* xd = x_ptr + rbs + distance_list[divcol];
+                #pragma omp simd
+                for(IndexType i = 0; i < (1 << ROW_BLOCK_BIT); ++i){
+                    sum[i] += value[i] * xd[i];
+                }
+            }
+            #pragma omp simd
+            for(IndexType i = 0; i < (1 << ROW_BLOCK_BIT); ++i){
+                y_ptr[rbs + i] = sum[i];
+            }
+        }else{
+            // head / tail block : check column range, the last block may be partial
+            const IndexType rbe = std::min(DIV_BLOCK_END(rbs), row_);
+            const IndexType len = rbe - rbs;
+            for(IndexType i = 0; i < len; ++i){
+                sum[i] = diag_value[rbs + i] * x_ptr[rbs + i];
+            }
+            for(IndexType divcol = 0; divcol < distance_count_; ++divcol){
+                const ValueType* value = block_value + DIV_COL_OFFSET(divcol);
+                const IndexType distance = distance_list[divcol];
+                for(IndexType i = 0; i < len; ++i){
+                    IndexType c = rbs + i + distance;
+                    if(c >= 0 && c < row_){
+                        sum[i] += value[i] * x_ptr[c];
+                    }
+                }
+            }
+            for(IndexType i = 0; i < len; ++i){
+                y_ptr[rbs + i] = sum[i];
+            }
+        }
+    }
+}
+
+template class DIV<int32_t, float>;
+template class DIV<int32_t, double>;
+template class DIV<int64_t, float>;
+template class DIV<int64_t, double>;
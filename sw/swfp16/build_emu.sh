@@ -0,0 +1,33 @@
+#!/bin/bash
+
+# x86 build of libswfp16 : the slave kernels run on the CRTS emulation of
+# ../crts_emu (64 CPE threads), gives libswfp16_emu.a (without crts_emu, the
+# program links it) for bias_gelu/build_emu.sh and the check ./main_emu.bin
+
+EMU="-D__sw_64__ -I../crts_emu"
+
+LIB=libswfp16_emu.a
+
+CC=mpicc
+CFLAGS="-O2 -g $EMU"
+CXX=mpicxx
+CXXFLAGS="-O2 -g $EMU"
+
+set -ex
+
+rm -f $LIB main_emu.bin
+
+# kernel f is spawned as SLAVE_FUN(f) = slave_f, the name the slave compiler gives it
+for f in fp16_array_from_float_array fp16_array_to_float_array fp16_array_from_double_array \
+    fp16_array_to_double_array fp16_from_float fp16_to_float; do
+    $CC $CFLAGS -D__sw_slave__ -D$f=slave_$f -c -o $f.emu.o ./$f.c
+done
+$CXX $CXXFLAGS -D__sw_host__ -c -o swfp16.emu.o ./swfp16.cpp
+
+ar cr $LIB *.emu.o
+ranlib $LIB
+
+$CC $CFLAGS -c -o crts_emu.o ../crts_emu/crts_emu.c
+$CXX $CXXFLAGS -D__sw_host__ -o main_emu.bin ./main.cpp $LIB crts_emu.o -lpthread -lm
+
+rm -f *.emu.o crts_emu.o